@@ -5,7 +5,7 @@ This module computes statistical metrics from trace records,
 including latency distributions, throughput, anomaly detection, and error counts.
 
 Usage:
-    python metrics.py <traces.jsonl>
+    python metrics.py <traces.jsonl | trace.bin>
 
     Output is JSON with metric summaries.
 """
@@ -22,6 +22,12 @@ except ImportError:
     HAS_NUMPY = False
 
 
+# Flag bit definitions (must match trace_pkg.sv)
+FLAG_TRACE_DROPPED  = 0x0001
+FLAG_CORE_ERROR     = 0x0002
+FLAG_INFLIGHT_UNDER = 0x0004
+
+
 @dataclass
 class LatencyMetrics:
     """Latency distribution metrics."""
@@ -254,7 +260,7 @@ class MetricsEngine:
         Returns:
             LatencyMetrics object with distribution statistics
         """
-        if not latencies:
+        if len(latencies) == 0:
             return LatencyMetrics(
                 count=0,
                 min_cycles=0,
@@ -272,20 +278,21 @@ class MetricsEngine:
             )
 
         if HAS_NUMPY:
-            arr = np.array(latencies)
+            arr = np.asarray(latencies)
+            p50, p75, p90, p95, p99, p999 = np.percentile(arr, [50, 75, 90, 95, 99, 99.9])
             return LatencyMetrics(
                 count=len(arr),
                 min_cycles=int(arr.min()),
                 max_cycles=int(arr.max()),
                 mean_cycles=float(arr.mean()),
-                median_cycles=float(np.median(arr)),
+                median_cycles=float(p50),
                 stddev_cycles=float(arr.std()),
-                p50_cycles=float(np.percentile(arr, 50)),
-                p75_cycles=float(np.percentile(arr, 75)),
-                p90_cycles=float(np.percentile(arr, 90)),
-                p95_cycles=float(np.percentile(arr, 95)),
-                p99_cycles=float(np.percentile(arr, 99)),
-                p999_cycles=float(np.percentile(arr, 99.9)),
+                p50_cycles=float(p50),
+                p75_cycles=float(p75),
+                p90_cycles=float(p90),
+                p95_cycles=float(p95),
+                p99_cycles=float(p99),
+                p999_cycles=float(p999),
                 clock_period_ns=self.clock_period_ns,
             )
         else:
@@ -530,11 +537,6 @@ def compute_trace_metrics(records: List[dict]) -> TraceMetrics:
             last_tx_id=None,
         )
 
-    # Flag bit definitions (must match trace_pkg.sv)
-    FLAG_TRACE_DROPPED  = 0x0001
-    FLAG_CORE_ERROR     = 0x0002
-    FLAG_INFLIGHT_UNDER = 0x0004
-
     latencies = []
     error_count = 0
     dropped_count = 0
@@ -569,17 +571,58 @@ def compute_trace_metrics(records: List[dict]) -> TraceMetrics:
     )
 
 
+def compute_trace_file_metrics(path, clock_period_ns: float = 10.0) -> TraceMetrics:
+    """Compute the metrics of compute_trace_metrics straight from a trace file.
+
+    The file is mapped as a record array (see trace_array.py) instead of
+    being decoded to dicts, so this needs numpy; the native decoder is used
+    when built.
+
+    Args:
+        path: Raw or compact 32-byte trace file
+        clock_period_ns: Clock period for time conversion
+
+    Returns:
+        TraceMetrics object with all metrics
+    """
+    if __package__:
+        from .trace_array import TRACE_DTYPE, count_flags, latencies, open_trace_array
+    else:
+        from trace_array import TRACE_DTYPE, count_flags, latencies, open_trace_array
+
+    records = open_trace_array(path)
+    if records.dtype != TRACE_DTYPE:
+        raise ValueError(f"{path} is not a 32-byte trace (found v1.2 records)")
+    if len(records) == 0:
+        return compute_trace_metrics([])
+
+    return TraceMetrics(
+        latency=compute_metrics(latencies(records), clock_period_ns),
+        total_transactions=len(records),
+        error_count=count_flags(records, FLAG_CORE_ERROR),
+        dropped_count=count_flags(records, FLAG_TRACE_DROPPED),
+        underflow_count=count_flags(records, FLAG_INFLIGHT_UNDER),
+        first_tx_id=int(records['tx_id'][0]),
+        last_tx_id=int(records['tx_id'][-1]),
+    )
+
+
 def main():
     """Command-line interface for metrics computation."""
     if len(sys.argv) < 2:
-        print(f"Usage: {sys.argv[0]} <traces.jsonl>", file=sys.stderr)
-        print("\nComputes latency metrics from JSONL trace records.",
+        print(f"Usage: {sys.argv[0]} <traces.jsonl | trace.bin>", file=sys.stderr)
+        print("\nComputes latency metrics from JSONL trace records or a binary trace.",
               file=sys.stderr)
         sys.exit(1)
 
     filepath = sys.argv[1]
 
     try:
+        if filepath.endswith('.bin'):
+            metrics = compute_trace_file_metrics(filepath)
+            print(json.dumps(metrics.to_dict(), indent=2))
+            return
+
         records = []
         with open(filepath, 'r') as f:
             for line in f:
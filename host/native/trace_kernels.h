@@ -0,0 +1,114 @@
+/*
+ * Trace Kernels
+ *
+ * Column kernels over packed trace records (sim/trace_record.h), run by
+ * the native decoder (trace_native.cpp) on a mapped trace file.
+ *
+ * Records are read in place at their fixed stride. The counting loops are
+ * branch-free so the compiler vectorizes them (the strided loads need
+ * AVX2 or better, hence -march=native in `make native`); the selections
+ * count in such a pass first, so the caller can size the output, and then
+ * write indices in a second pass.
+ */
+
+#ifndef SENTINEL_TRACE_KERNELS_H
+#define SENTINEL_TRACE_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "trace_record.h"
+
+// Sequence field used for gap detection: tx_id for v1.1, the 32-bit
+// wrapping seq_no for v1.2 (its tx_id is only 16 bits)
+template <typename Record>
+struct TraceSequence;
+
+template <>
+struct TraceSequence<TraceRecord> {
+    static constexpr uint64_t MASK = ~0ull;
+    static uint64_t of(const TraceRecord& r) { return r.tx_id; }
+};
+
+template <>
+struct TraceSequence<TraceRecordV12> {
+    static constexpr uint64_t MASK = 0xFFFFFFFFull;
+    static uint64_t of(const TraceRecordV12& r) { return r.seq_no; }
+};
+
+// t_egress - t_ingress, signed so a negative latency shows as one
+template <typename Record>
+void trace_latency(const Record* r, size_t n, int64_t* out) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = static_cast<int64_t>(r[i].t_egress - r[i].t_ingress);
+    }
+}
+
+// Records with every bit of mask set (all) or any of them (!all)
+template <typename Record>
+size_t trace_count_flags(const Record* r, size_t n, uint16_t mask, bool all) {
+    size_t count = 0;
+    if (all) {
+        for (size_t i = 0; i < n; i++) {
+            count += (r[i].flags & mask) == mask;
+        }
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            count += (r[i].flags & mask) != 0;
+        }
+    }
+    return count;
+}
+
+// Indices of the records trace_count_flags counts; out holds that many
+template <typename Record>
+void trace_select_flags(const Record* r, size_t n, uint16_t mask, bool all, int64_t* out) {
+    size_t k = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint16_t f = r[i].flags & mask;
+        if (all ? f == mask : f != 0) {
+            out[k++] = static_cast<int64_t>(i);
+        }
+    }
+}
+
+// Sequence discontinuities between consecutive records. A forward step of
+// more than one is a gap (records i - 1 and i have missing ones between
+// them, e.g. traces dropped on overflow); a step of zero or backwards is
+// a repeat or reorder.
+struct TraceGaps {
+    uint64_t gaps = 0;
+    uint64_t missing = 0;    // Sequence numbers skipped over all gaps
+    uint64_t reordered = 0;
+};
+
+template <typename Record>
+TraceGaps trace_count_gaps(const Record* r, size_t n) {
+    using Seq = TraceSequence<Record>;
+    const uint64_t half = Seq::MASK / 2 + 1;
+    TraceGaps g;
+    for (size_t i = 1; i < n; i++) {
+        uint64_t step = (Seq::of(r[i]) - Seq::of(r[i - 1])) & Seq::MASK;
+        uint64_t gap = step > 1 && step < half;
+        g.gaps += gap;
+        g.missing += gap * (step - 1);
+        g.reordered += step == 0 || step >= half;
+    }
+    return g;
+}
+
+// Index of the record after each gap; out holds trace_count_gaps().gaps
+template <typename Record>
+void trace_select_gaps(const Record* r, size_t n, int64_t* out) {
+    using Seq = TraceSequence<Record>;
+    const uint64_t half = Seq::MASK / 2 + 1;
+    size_t k = 0;
+    for (size_t i = 1; i < n; i++) {
+        uint64_t step = (Seq::of(r[i]) - Seq::of(r[i - 1])) & Seq::MASK;
+        if (step > 1 && step < half) {
+            out[k++] = static_cast<int64_t>(i);
+        }
+    }
+}
+
+#endif
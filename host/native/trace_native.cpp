@@ -0,0 +1,283 @@
+/*
+ * Native Trace Decoder
+ *
+ * Python extension (pybind11) that maps raw trace files and runs the
+ * column kernels of trace_kernels.h on them. Built by `make native` into
+ * host/_trace_native*.so; host/trace_array.py uses it when it imports and
+ * falls back to numpy with the same dtypes otherwise.
+ *
+ * map_trace() returns a read-only numpy structured array whose memory is
+ * the file mapping itself: no record is copied or decoded, and the mapping
+ * lives as long as any view of it. The dtypes are built from the C++
+ * layouts in sim/trace_record.h, so they cannot drift from what the
+ * drivers write.
+ *
+ *   TRACE_DTYPE, TRACE_V12_DTYPE      32- and 64-byte record dtypes
+ *   map_trace(path, record_size, offset=0)
+ *   latency(records)                  t_egress - t_ingress as int64
+ *   count_flags(records, mask, match_all=False)
+ *   select_flags(records, mask, match_all=False)  indices as int64
+ *   find_gaps(records)                (indices, missing, reordered)
+ *
+ * The kernels take any contiguous 1-D array of either dtype (a mapped
+ * view, numpy.memmap or an in-memory array) and release the GIL while
+ * they run.
+ */
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "trace_kernels.h"
+#include "trace_record.h"
+
+namespace py = pybind11;
+
+//-----------------------------------------------------------------------------
+// Dtypes
+//-----------------------------------------------------------------------------
+
+class DtypeBuilder {
+public:
+    DtypeBuilder& field(const char* name, const char* format, size_t offset) {
+        names.append(name);
+        formats.append(format);
+        offsets.append(offset);
+        return *this;
+    }
+
+    py::dtype build(size_t itemsize) {
+        return py::dtype(names, formats, offsets, static_cast<py::ssize_t>(itemsize));
+    }
+
+private:
+    py::list names;
+    py::list formats;
+    py::list offsets;
+};
+
+#define TRACE_FIELD(Record, name, format) field(#name, format, offsetof(Record, name))
+
+// Built once at import and kept for the life of the process
+static py::dtype* trace_dtype = nullptr;
+static py::dtype* trace_v12_dtype = nullptr;
+
+static void build_dtypes() {
+    trace_dtype = new py::dtype(DtypeBuilder()
+        .TRACE_FIELD(TraceRecord, tx_id, "<u8")
+        .TRACE_FIELD(TraceRecord, t_ingress, "<u8")
+        .TRACE_FIELD(TraceRecord, t_egress, "<u8")
+        .TRACE_FIELD(TraceRecord, flags, "<u2")
+        .TRACE_FIELD(TraceRecord, opcode, "<u2")
+        .TRACE_FIELD(TraceRecord, meta, "<u4")
+        .build(sizeof(TraceRecord)));
+
+    trace_v12_dtype = new py::dtype(DtypeBuilder()
+        .TRACE_FIELD(TraceRecordV12, version, "u1")
+        .TRACE_FIELD(TraceRecordV12, record_type, "u1")
+        .TRACE_FIELD(TraceRecordV12, core_id, "<u2")
+        .TRACE_FIELD(TraceRecordV12, seq_no, "<u4")
+        .TRACE_FIELD(TraceRecordV12, t_ingress, "<u8")
+        .TRACE_FIELD(TraceRecordV12, t_egress, "<u8")
+        .TRACE_FIELD(TraceRecordV12, t_host, "<u8")
+        .TRACE_FIELD(TraceRecordV12, tx_id, "<u2")
+        .TRACE_FIELD(TraceRecordV12, flags, "<u2")
+        .TRACE_FIELD(TraceRecordV12, reserved, "V12")
+        .TRACE_FIELD(TraceRecordV12, d_ingress, "<u4")
+        .TRACE_FIELD(TraceRecordV12, d_core, "<u4")
+        .TRACE_FIELD(TraceRecordV12, d_risk, "<u4")
+        .TRACE_FIELD(TraceRecordV12, d_egress, "<u4")
+        .build(sizeof(TraceRecordV12)));
+}
+
+#undef TRACE_FIELD
+
+//-----------------------------------------------------------------------------
+// File mapping
+//-----------------------------------------------------------------------------
+
+// Read-only mapping of a whole trace file, owned by the arrays viewing it
+class TraceMap {
+public:
+    explicit TraceMap(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            raise_errno(path);
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close_and_raise(fd, path);
+        }
+        length = static_cast<size_t>(st.st_size);
+        if (length > 0) {
+            void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                close_and_raise(fd, path);
+            }
+            // Access hints only; failures are harmless
+            madvise(p, length, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+            madvise(p, length, MADV_HUGEPAGE);
+#endif
+            base = static_cast<const uint8_t*>(p);
+        }
+        // The mapping keeps its own reference to the file
+        ::close(fd);
+    }
+
+    ~TraceMap() {
+        if (base) {
+            munmap(const_cast<uint8_t*>(base), length);
+        }
+    }
+
+    TraceMap(const TraceMap&) = delete;
+    TraceMap& operator=(const TraceMap&) = delete;
+
+    const uint8_t* base = nullptr;
+    size_t length = 0;
+
+private:
+    [[noreturn]] static void raise_errno(const std::string& path) {
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, path.c_str());
+        throw py::error_already_set();
+    }
+
+    [[noreturn]] static void close_and_raise(int fd, const std::string& path) {
+        int err = errno;
+        ::close(fd);
+        errno = err;
+        raise_errno(path);
+    }
+};
+
+static const py::dtype& dtype_for(size_t record_size) {
+    if (record_size == sizeof(TraceRecord)) return *trace_dtype;
+    if (record_size == sizeof(TraceRecordV12)) return *trace_v12_dtype;
+    throw py::value_error("Unsupported trace record size " + std::to_string(record_size) +
+                          " (expected 32 or 64)");
+}
+
+// Records from offset to the last whole record; a torn tail is left out
+static py::array map_trace(const std::string& path, size_t record_size, size_t offset) {
+    const py::dtype& dt = dtype_for(record_size);
+    auto map = std::make_unique<TraceMap>(path);
+    size_t n = map->length > offset ? (map->length - offset) / record_size : 0;
+    if (n == 0) {
+        return py::array(dt, std::vector<py::ssize_t>{0});
+    }
+
+    const uint8_t* first = map->base + offset;
+    py::capsule owner(map.release(), [](void* p) { delete static_cast<TraceMap*>(p); });
+    py::array view(dt, {static_cast<py::ssize_t>(n)},
+                   {static_cast<py::ssize_t>(record_size)}, first, owner);
+    view.attr("setflags")(py::arg("write") = false);
+    return view;
+}
+
+//-----------------------------------------------------------------------------
+// Kernels
+//-----------------------------------------------------------------------------
+
+// Calls f(records, n) with the array's records typed by its dtype
+template <typename F>
+static auto with_records(const py::array& a, F&& f) {
+    if (a.ndim() != 1 || (a.shape(0) > 1 && a.strides(0) != a.itemsize())) {
+        throw py::value_error("Trace kernels need a contiguous 1-D record array");
+    }
+    size_t n = static_cast<size_t>(a.shape(0));
+    if (a.dtype().equal(*trace_dtype)) {
+        return f(static_cast<const TraceRecord*>(a.data()), n);
+    }
+    if (a.dtype().equal(*trace_v12_dtype)) {
+        return f(static_cast<const TraceRecordV12*>(a.data()), n);
+    }
+    throw py::type_error("Not a trace record array (dtype must be TRACE_DTYPE or TRACE_V12_DTYPE)");
+}
+
+static py::array_t<int64_t> latency(const py::array& records) {
+    return with_records(records, [](auto* r, size_t n) {
+        py::array_t<int64_t> out(static_cast<py::ssize_t>(n));
+        int64_t* dst = out.mutable_data();
+        {
+            py::gil_scoped_release release;
+            trace_latency(r, n, dst);
+        }
+        return out;
+    });
+}
+
+static size_t count_flags(const py::array& records, uint16_t mask, bool match_all) {
+    return with_records(records, [&](auto* r, size_t n) {
+        py::gil_scoped_release release;
+        return trace_count_flags(r, n, mask, match_all);
+    });
+}
+
+static py::array_t<int64_t> select_flags(const py::array& records, uint16_t mask, bool match_all) {
+    return with_records(records, [&](auto* r, size_t n) {
+        size_t count;
+        {
+            py::gil_scoped_release release;
+            count = trace_count_flags(r, n, mask, match_all);
+        }
+        py::array_t<int64_t> out(static_cast<py::ssize_t>(count));
+        int64_t* dst = out.mutable_data();
+        {
+            py::gil_scoped_release release;
+            trace_select_flags(r, n, mask, match_all, dst);
+        }
+        return out;
+    });
+}
+
+static py::tuple find_gaps(const py::array& records) {
+    return with_records(records, [](auto* r, size_t n) {
+        TraceGaps g;
+        {
+            py::gil_scoped_release release;
+            g = trace_count_gaps(r, n);
+        }
+        py::array_t<int64_t> out(static_cast<py::ssize_t>(g.gaps));
+        int64_t* dst = out.mutable_data();
+        {
+            py::gil_scoped_release release;
+            trace_select_gaps(r, n, dst);
+        }
+        return py::make_tuple(out, g.missing, g.reordered);
+    });
+}
+
+PYBIND11_MODULE(_trace_native, m) {
+    m.doc() = "Native trace decoder: zero-copy record views and column kernels";
+
+    build_dtypes();
+    m.attr("TRACE_DTYPE") = *trace_dtype;
+    m.attr("TRACE_V12_DTYPE") = *trace_v12_dtype;
+
+    m.def("map_trace", &map_trace, py::arg("path"), py::arg("record_size"),
+          py::arg("offset") = 0,
+          "Map a raw trace file as a read-only structured array (no copy)");
+    m.def("latency", &latency, py::arg("records"),
+          "t_egress - t_ingress of every record, as int64");
+    m.def("count_flags", &count_flags, py::arg("records"), py::arg("mask"),
+          py::arg("match_all") = false,
+          "Number of records with any (or all) of the mask bits set");
+    m.def("select_flags", &select_flags, py::arg("records"), py::arg("mask"),
+          py::arg("match_all") = false,
+          "Indices of records with any (or all) of the mask bits set");
+    m.def("find_gaps", &find_gaps, py::arg("records"),
+          "Sequence gaps: (indices of the record after each gap, "
+          "sequence numbers missing, repeats or reorders)");
+}
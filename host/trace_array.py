@@ -0,0 +1,243 @@
+#!/usr/bin/env python3
+"""Vectorized access to raw trace files.
+
+Maps a trace file as a numpy structured array instead of decoding it
+record by record (see trace_decode.py), and computes latency, flag
+selections and sequence gaps as whole-array kernels. Two layouts, both
+defined in sim/trace_record.h:
+
+  trace   32-byte TraceRecord written by sim_main.cpp (TRACE_FORMAT)
+  v12     64-byte TraceRecordV12 written by sim_v12.cpp (V12_STRUCT)
+
+With the native decoder built (``make native``, host/native) files are
+mapped and the kernels run in C++; without it the same functions run on
+numpy.memmap with identical dtypes and results. Either way records are
+not copied: only kernel outputs are allocated.
+
+Compact traces (sim --format compact) cannot be mapped; they are decoded
+into an in-memory array of the trace layout.
+
+Usage:
+    python trace_array.py <trace.bin> [v12]
+
+    Prints record count, latency range, flag counts and sequence gaps.
+"""
+
+import sys
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Union
+
+import numpy as np
+
+if __package__:
+    from .trace_decode import COMPACT_MAGIC, TRACE_RECORD_SIZE, decode_compact_file_columns
+    try:
+        from . import _trace_native as _native
+    except ImportError:
+        _native = None
+else:
+    from trace_decode import COMPACT_MAGIC, TRACE_RECORD_SIZE, decode_compact_file_columns
+    try:
+        import _trace_native as _native
+    except ImportError:
+        _native = None
+
+
+# TraceRecord (must match sim/trace_record.h and TRACE_FORMAT)
+TRACE_DTYPE = np.dtype({
+    'names': ['tx_id', 't_ingress', 't_egress', 'flags', 'opcode', 'meta'],
+    'formats': ['<u8', '<u8', '<u8', '<u2', '<u2', '<u4'],
+    'offsets': [0, 8, 16, 24, 26, 28],
+    'itemsize': TRACE_RECORD_SIZE,
+})
+
+# TraceRecordV12 (must match sim/trace_record.h and V12_STRUCT)
+TRACE_V12_DTYPE = np.dtype({
+    'names': ['version', 'record_type', 'core_id', 'seq_no', 't_ingress', 't_egress',
+              't_host', 'tx_id', 'flags', 'reserved',
+              'd_ingress', 'd_core', 'd_risk', 'd_egress'],
+    'formats': ['u1', 'u1', '<u2', '<u4', '<u8', '<u8', '<u8', '<u2', '<u2', 'V12',
+                '<u4', '<u4', '<u4', '<u4'],
+    'offsets': [0, 1, 2, 4, 8, 16, 24, 32, 34, 36, 48, 52, 56, 60],
+    'itemsize': 64,
+})
+
+LAYOUTS = {'trace': TRACE_DTYPE, 'v12': TRACE_V12_DTYPE}
+
+# Optional file header (sentinel_hft/formats/file_header.py); only v1.2
+# records are read behind one, the 32-byte records it can announce are
+# the v1.0 adapter layout rather than TraceRecord
+_FILE_HEADER_MAGIC = b'SNTL'
+_FILE_HEADER_SIZE = 32
+
+# Sequence field and width used for gap detection
+_SEQUENCE = {'trace': ('tx_id', (1 << 64) - 1), 'v12': ('seq_no', (1 << 32) - 1)}
+
+
+@dataclass
+class TraceGaps:
+    """Sequence discontinuities between consecutive records."""
+    indices: np.ndarray   # Record after each forward gap
+    missing: int          # Sequence numbers skipped over all gaps
+    reordered: int        # Steps of zero or backwards (repeats, reorders)
+
+    @property
+    def count(self) -> int:
+        """Number of gaps."""
+        return len(self.indices)
+
+
+def native_available() -> bool:
+    """True if the native decoder (host/native) is built and importable."""
+    return _native is not None
+
+
+def layout_of(records: np.ndarray) -> str:
+    """Layout name ('trace' or 'v12') of a record array."""
+    for name, dtype in LAYOUTS.items():
+        if records.dtype == dtype:
+            return name
+    raise TypeError(f"Not a trace record array: {records.dtype}")
+
+
+def open_trace_array(path: Union[str, Path], layout: str = 'auto') -> np.ndarray:
+    """Map a trace file as a structured array of records.
+
+    Args:
+        path: Raw or compact trace file
+        layout: 'auto', 'trace' or 'v12'. sim_v12 writes no file header,
+            so its traces need 'v12'; 'auto' reads v1.2 behind an SNTL
+            header and the trace layout otherwise.
+
+    Returns:
+        Read-only array of TRACE_DTYPE or TRACE_V12_DTYPE records backed
+        by the file mapping (compact traces: decoded in memory). A torn
+        last record is left out with a warning, as decode_trace_file does.
+    """
+    if layout not in ('auto', *LAYOUTS):
+        raise ValueError(f"Unknown trace layout: {layout}")
+    path = Path(path)
+    size = path.stat().st_size
+    with open(path, 'rb') as f:
+        head = f.read(_FILE_HEADER_SIZE)
+
+    if head.startswith(COMPACT_MAGIC):
+        if layout == 'v12':
+            raise ValueError("Compact traces hold 32-byte trace records, not v1.2")
+        return _compact_array(path)
+
+    offset = 0
+    if head.startswith(_FILE_HEADER_MAGIC) and len(head) == _FILE_HEADER_SIZE:
+        record_size = int.from_bytes(head[6:8], 'little')
+        if record_size != TRACE_V12_DTYPE.itemsize or layout == 'trace':
+            raise ValueError(f"SNTL file of {record_size}-byte records is not a "
+                             f"{'trace' if layout == 'trace' else 'v1.2'} layout")
+        layout = 'v12'
+        offset = _FILE_HEADER_SIZE
+    elif layout == 'auto':
+        layout = 'trace'
+
+    dtype = LAYOUTS[layout]
+    count, tail = divmod(max(size - offset, 0), dtype.itemsize)
+    if tail:
+        print(f"Warning: Incomplete record ({tail} bytes) at end of file", file=sys.stderr)
+    if count == 0:
+        return np.empty(0, dtype=dtype)
+    if _native is not None:
+        return _native.map_trace(str(path), dtype.itemsize, offset)
+    return np.memmap(path, dtype=dtype, mode='r', offset=offset, shape=(count,))
+
+
+def _compact_array(path: Path) -> np.ndarray:
+    cols = decode_compact_file_columns(path.read_bytes())
+    records = np.empty(len(cols['tx_id']), dtype=TRACE_DTYPE)
+    for name, values in cols.items():
+        records[name] = values
+    records.flags.writeable = False
+    return records
+
+
+def _native_ok(records: np.ndarray) -> bool:
+    # The native kernels take contiguous 1-D arrays of the two dtypes
+    return (_native is not None and records.ndim == 1 and records.flags.c_contiguous
+            and (records.dtype == TRACE_DTYPE or records.dtype == TRACE_V12_DTYPE))
+
+
+def latencies(records: np.ndarray) -> np.ndarray:
+    """t_egress - t_ingress of every record, as int64 cycles."""
+    if _native_ok(records):
+        return _native.latency(records)
+    return (records['t_egress'] - records['t_ingress']).view(np.int64)
+
+
+def _flag_match(records: np.ndarray, mask: int, match_all: bool) -> np.ndarray:
+    masked = records['flags'] & mask
+    return masked == mask if match_all else masked != 0
+
+
+def count_flags(records: np.ndarray, mask: int, match_all: bool = False) -> int:
+    """Number of records with any of the mask bits set (all of them with match_all)."""
+    if _native_ok(records):
+        return _native.count_flags(records, mask, match_all)
+    return int(np.count_nonzero(_flag_match(records, mask, match_all)))
+
+
+def select_flags(records: np.ndarray, mask: int, match_all: bool = False) -> np.ndarray:
+    """Indices (int64) of the records count_flags counts."""
+    if _native_ok(records):
+        return _native.select_flags(records, mask, match_all)
+    return np.flatnonzero(_flag_match(records, mask, match_all)).astype(np.int64)
+
+
+def find_gaps(records: np.ndarray) -> TraceGaps:
+    """Find sequence gaps: dropped records show as forward steps of more than one.
+
+    The sequence is tx_id for the trace layout and the wrapping 32-bit
+    seq_no for v1.2.
+    """
+    if _native_ok(records):
+        indices, missing, reordered = _native.find_gaps(records)
+        return TraceGaps(indices=indices, missing=missing, reordered=reordered)
+
+    field, mask = _SEQUENCE[layout_of(records)]
+    seq = records[field].astype(np.uint64)
+    step = (seq[1:] - seq[:-1]) & np.uint64(mask)
+    half = np.uint64(mask // 2 + 1)
+    forward = (step > 1) & (step < half)
+    return TraceGaps(
+        indices=np.flatnonzero(forward).astype(np.int64) + 1,
+        missing=int((step[forward] - np.uint64(1)).sum(dtype=np.uint64)),
+        reordered=int(np.count_nonzero((step == 0) | (step >= half))),
+    )
+
+
+def main():
+    """Command-line interface: summarize a trace file."""
+    if len(sys.argv) < 2:
+        print(f"Usage: {sys.argv[0]} <trace.bin> [v12]", file=sys.stderr)
+        sys.exit(1)
+
+    try:
+        records = open_trace_array(sys.argv[1], sys.argv[2] if len(sys.argv) > 2 else 'auto')
+    except (OSError, ValueError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        sys.exit(1)
+
+    layout = layout_of(records)
+    print(f"Records: {len(records)} ({layout} layout, "
+          f"{'native' if native_available() else 'numpy'} decoder)")
+    if len(records) == 0:
+        return
+    lat = latencies(records)
+    print(f"Latency: min {int(lat.min())}, max {int(lat.max())}, mean {float(lat.mean()):.2f} cycles")
+    for bit in range(16):
+        n = count_flags(records, 1 << bit)
+        if n:
+            print(f"Flag 0x{1 << bit:04x}: {n} records")
+    gaps = find_gaps(records)
+    print(f"Gaps: {gaps.count} ({gaps.missing} missing), {gaps.reordered} repeated or reordered")
+
+
+if __name__ == '__main__':
+    main()
@@ -13,17 +13,23 @@ Trace Record Binary Format (32 bytes, little-endian):
   26      2     opcode     (uint16)
   28      4     meta       (uint32)
 
+Files written with `--format compact` (sim/compact_trace.h) are blocks of
+delta/varint-encoded records with a block index footer; they are
+detected by their "STC1" magic and decoded transparently.
+
 Usage:
     python trace_decode.py <trace.bin>
 
     Output is JSONL (one JSON object per line) to stdout.
 """
 
+import operator
 import struct
 import json
 import sys
+from itertools import accumulate, repeat
 from dataclasses import dataclass, asdict
-from typing import Iterator, BinaryIO, List, Optional
+from typing import Iterator, BinaryIO, List, Optional, Tuple
 
 
 # Trace record size in bytes (256 bits)
@@ -33,6 +39,19 @@ TRACE_RECORD_SIZE = 32
 TRACE_FORMAT = '<QQQHHI'
 
 
+# Compact trace format (sim --format compact, layout in sim/compact_trace.h)
+COMPACT_MAGIC = b'STC1'
+COMPACT_INDEX_MAGIC = b'STCI'
+COMPACT_HEADER = struct.Struct('<4sHHII')
+COMPACT_BLOCK_HEADER = struct.Struct('<III')
+COMPACT_INDEX_ENTRY = struct.Struct('<QQQII')
+COMPACT_TRAILER = struct.Struct('<QI4s')
+COMPACT_CODEC_NONE = 0
+COMPACT_CODEC_ZSTD = 1
+
+_MASK64 = (1 << 64) - 1
+
+
 # Flag bit definitions (must match trace_pkg.sv)
 class TraceFlags:
     NONE           = 0x0000
@@ -117,7 +136,7 @@ def decode_trace(data: bytes) -> TraceRecord:
 
 
 def decode_trace_file(f: BinaryIO) -> Iterator[TraceRecord]:
-    """Decode all trace records from a binary file.
+    """Decode all trace records from a binary file (raw or compact).
 
     Args:
         f: Binary file object opened for reading
@@ -125,8 +144,14 @@ def decode_trace_file(f: BinaryIO) -> Iterator[TraceRecord]:
     Yields:
         TraceRecord objects
     """
+    head = f.read(len(COMPACT_MAGIC))
+    if head == COMPACT_MAGIC:
+        yield from decode_compact(head + f.read())
+        return
+
     while True:
-        data = f.read(TRACE_RECORD_SIZE)
+        data = head + f.read(TRACE_RECORD_SIZE - len(head))
+        head = b''
         if len(data) == 0:
             break
         if len(data) < TRACE_RECORD_SIZE:
@@ -154,6 +179,285 @@ def decode_trace_list(data: bytes) -> List[TraceRecord]:
     return records
 
 
+@dataclass
+class CompactBlock:
+    """Block index entry of a compact trace file."""
+    offset: int
+    first_tx_id: int
+    first_t_ingress: int
+    count: int
+
+
+# Maps each byte to 1 if it has the varint continuation bit set
+_CONTINUATION = bytes(1 if b & 0x80 else 0 for b in range(256))
+
+
+def _decode_varints(buf: bytes) -> List[int]:
+    # Most fields are single-byte varints: copy runs of them in one slice
+    # and only loop over the bytes of the rare multi-byte values.
+    marks = buf.translate(_CONTINUATION)
+    vals = []
+    pos = 0
+    n = len(buf)
+    while pos < n:
+        nxt = marks.find(1, pos)
+        if nxt < 0:
+            vals.extend(buf[pos:])
+            break
+        vals.extend(buf[pos:nxt])
+        v = 0
+        shift = 0
+        while buf[nxt] & 0x80:
+            v |= (buf[nxt] & 0x7F) << shift
+            shift += 7
+            nxt += 1
+        vals.append(v | (buf[nxt] << shift))
+        pos = nxt + 1
+    return vals
+
+
+# Zigzag decode table for small deltas (the common case)
+_UNZIGZAG = [(v >> 1) ^ -(v & 1) for v in range(1 << 12)]
+
+
+def _unzigzag(col: List[int]) -> List[int]:
+    if not col or max(col) < len(_UNZIGZAG):
+        return list(map(_UNZIGZAG.__getitem__, col))
+    return [(v >> 1) ^ -(v & 1) for v in col]
+
+
+def _wrap64(col: List[int]) -> List[int]:
+    if col and (min(col) < 0 or max(col) > _MASK64):
+        return [v & _MASK64 for v in col]
+    return col
+
+
+def decode_compact_columns(payload: bytes, count: int) -> dict:
+    """Decode one (uncompressed) compact block into field columns.
+
+    Fields are decoded column-wise: varints, zigzag and the running sums
+    that undo the deltas each run as one C-level pass over the block.
+    Cheaper than building TraceRecord objects when only a few fields
+    are needed (e.g. latency quantiles).
+
+    Args:
+        payload: Block payload
+        count: Number of records in the block
+
+    Returns:
+        Dict of lists keyed by tx_id, t_ingress, t_egress, flags, opcode, meta
+    """
+    vals = _decode_varints(payload)
+    if len(vals) < 6 * count:
+        raise ValueError(f"Compact block holds {len(vals) // 6} records, expected {count}")
+    vals = vals[:6 * count]
+
+    # tx_id[i] = tx_id[i-1] + 1 + delta[i], starting from tx_id[-1] = -1
+    tx_id = [v - 1 for v in accumulate(map(operator.add, _unzigzag(vals[0::6]), repeat(1)))]
+    t_ingress = list(accumulate(_unzigzag(vals[1::6])))
+    t_egress = list(map(operator.add, t_ingress, accumulate(_unzigzag(vals[2::6]))))
+
+    return {
+        'tx_id': _wrap64(tx_id),
+        't_ingress': _wrap64(t_ingress),
+        't_egress': _wrap64(t_egress),
+        'flags': vals[3::6],
+        'opcode': list(accumulate(_unzigzag(vals[4::6]))),
+        'meta': list(accumulate(_unzigzag(vals[5::6]))),
+    }
+
+
+def decode_compact_block(payload: bytes, count: int) -> List[TraceRecord]:
+    """Decode the varint payload of one (uncompressed) compact block.
+
+    Args:
+        payload: Block payload
+        count: Number of records in the block
+
+    Returns:
+        List of TraceRecord objects
+    """
+    c = decode_compact_columns(payload, count)
+    return list(map(TraceRecord, c['tx_id'], c['t_ingress'], c['t_egress'],
+                    c['flags'], c['opcode'], c['meta']))
+
+
+def _decompress_block(codec: int, payload: bytes, raw_size: int) -> bytes:
+    # stored_size == raw_size means the writer kept the block uncompressed
+    if codec == COMPACT_CODEC_NONE or len(payload) == raw_size:
+        return payload
+    if codec == COMPACT_CODEC_ZSTD:
+        try:
+            import zstandard
+        except ImportError:
+            raise RuntimeError("zstd-compressed trace needs the 'zstandard' package")
+        return zstandard.ZstdDecompressor().decompress(payload, max_output_size=raw_size)
+    raise ValueError(f"Unknown compact trace codec {codec}")
+
+
+def read_compact_index(data: bytes) -> Optional[List[CompactBlock]]:
+    """Read the block index from a complete compact trace.
+
+    Args:
+        data: Compact trace file contents
+
+    Returns:
+        Index entries, or None if the file has no trailer (still being
+        written or truncated)
+    """
+    if len(data) < COMPACT_HEADER.size + COMPACT_TRAILER.size:
+        return None
+    index_offset, num_blocks, magic = COMPACT_TRAILER.unpack_from(data, len(data) - COMPACT_TRAILER.size)
+    if magic != COMPACT_INDEX_MAGIC:
+        return None
+    return [CompactBlock(*COMPACT_INDEX_ENTRY.unpack_from(data, index_offset + i * COMPACT_INDEX_ENTRY.size)[:4])
+            for i in range(num_blocks)]
+
+
+def _read_compact_header(data: bytes) -> int:
+    magic, version, codec, record_size, _ = COMPACT_HEADER.unpack_from(data, 0)
+    if magic != COMPACT_MAGIC:
+        raise ValueError("Not a compact trace file")
+    if version != 1 or record_size != TRACE_RECORD_SIZE:
+        raise ValueError(f"Unsupported compact trace (version {version}, record size {record_size})")
+    return codec
+
+
+def _compact_block_payloads(data: bytes) -> Iterator[Tuple[bytes, int]]:
+    # (payload, count) of each complete block, in file order
+    codec = _read_compact_header(data)
+    index = read_compact_index(data)
+    end = (len(data) if index is None else
+           COMPACT_TRAILER.unpack_from(data, len(data) - COMPACT_TRAILER.size)[0])
+
+    offset = COMPACT_HEADER.size
+    while offset + COMPACT_BLOCK_HEADER.size <= end:
+        stored_size, raw_size, count = COMPACT_BLOCK_HEADER.unpack_from(data, offset)
+        start = offset + COMPACT_BLOCK_HEADER.size
+        if start + stored_size > end:
+            print("Warning: Incomplete block at end of compact trace", file=sys.stderr)
+            break
+        yield _decompress_block(codec, data[start:start + stored_size], raw_size), count
+        offset = start + stored_size
+
+
+def decode_compact(data: bytes) -> List[TraceRecord]:
+    """Decode every record of a compact trace.
+
+    Files without an index (partially written) are decoded block by
+    block up to the last complete block.
+
+    Args:
+        data: Compact trace file contents
+
+    Returns:
+        List of TraceRecord objects
+    """
+    records = []
+    for payload, count in _compact_block_payloads(data):
+        records.extend(decode_compact_block(payload, count))
+    return records
+
+
+def decode_compact_file_columns(data: bytes) -> dict:
+    """Decode a whole compact trace into field columns (see decode_compact_columns).
+
+    Args:
+        data: Compact trace file contents
+
+    Returns:
+        Dict of lists keyed by field name
+    """
+    cols = {k: [] for k in ('tx_id', 't_ingress', 't_egress', 'flags', 'opcode', 'meta')}
+    for payload, count in _compact_block_payloads(data):
+        for k, v in decode_compact_columns(payload, count).items():
+            cols[k].extend(v)
+    return cols
+
+
+def decode_compact_from(data: bytes, tx_id: int) -> List[TraceRecord]:
+    """Decode records from tx_id onwards using the block index.
+
+    Only the block containing tx_id and the blocks after it are decoded.
+
+    Args:
+        data: Compact trace file contents (with index)
+        tx_id: First transaction ID wanted
+
+    Returns:
+        Records with tx_id >= the requested ID
+    """
+    codec = _read_compact_header(data)
+    index = read_compact_index(data)
+    if index is None:
+        return [r for r in decode_compact(data) if r.tx_id >= tx_id]
+
+    first = 0
+    for i, blk in enumerate(index):
+        if blk.first_tx_id <= tx_id:
+            first = i
+        else:
+            break
+
+    records = []
+    for blk in index[first:]:
+        stored_size, raw_size, count = COMPACT_BLOCK_HEADER.unpack_from(data, blk.offset)
+        start = blk.offset + COMPACT_BLOCK_HEADER.size
+        payload = _decompress_block(codec, data[start:start + stored_size], raw_size)
+        records.extend(r for r in decode_compact_block(payload, count) if r.tx_id >= tx_id)
+    return records
+
+
+def _put_varint(out: bytearray, v: int) -> None:
+    while v >= 0x80:
+        out.append((v & 0x7F) | 0x80)
+        v >>= 7
+    out.append(v)
+
+
+def encode_compact(records: List[TraceRecord], block_records: int = 4096) -> bytes:
+    """Encode records as an uncompressed compact trace.
+
+    Produces the same layout as the simulator's --format compact, e.g.
+    to convert an existing raw trace.
+
+    Args:
+        records: Records to encode
+        block_records: Maximum records per block
+
+    Returns:
+        Compact trace file contents
+    """
+    out = bytearray(COMPACT_HEADER.pack(COMPACT_MAGIC, 1, COMPACT_CODEC_NONE, TRACE_RECORD_SIZE, 0))
+    index = []
+
+    def zz(v: int) -> int:
+        # 64-bit zigzag of a wrapped difference
+        v = (v + (1 << 63)) % (1 << 64) - (1 << 63)
+        return ((v << 1) ^ (v >> 63)) & _MASK64
+
+    for start in range(0, len(records), block_records):
+        block = records[start:start + block_records]
+        payload = bytearray()
+        next_tx = t_in = lat = opcode = meta = 0
+        for r in block:
+            r_lat = r.t_egress - r.t_ingress
+            for v in (zz(r.tx_id - next_tx), zz(r.t_ingress - t_in), zz(r_lat - lat),
+                      r.flags, zz(r.opcode - opcode), zz(r.meta - meta)):
+                _put_varint(payload, v)
+            next_tx, t_in, lat, opcode, meta = r.tx_id + 1, r.t_ingress, r_lat, r.opcode, r.meta
+
+        index.append((len(out), block[0].tx_id, block[0].t_ingress, len(block)))
+        out += COMPACT_BLOCK_HEADER.pack(len(payload), len(payload), len(block))
+        out += payload
+
+    index_offset = len(out)
+    for entry in index:
+        out += COMPACT_INDEX_ENTRY.pack(*entry, 0)
+    out += COMPACT_TRAILER.pack(index_offset, len(index), COMPACT_INDEX_MAGIC)
+    return bytes(out)
+
+
 def main():
     """Command-line interface for trace decoding."""
     if len(sys.argv) < 2:
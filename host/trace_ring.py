@@ -0,0 +1,291 @@
+#!/usr/bin/env python3
+"""Read trace records from the simulator's shared-memory ring.
+
+With ``--output shm://NAME`` the shell testbench publishes trace records
+into a single-producer/single-consumer ring in POSIX shared memory (see
+sim/trace_ring.h for the layout) instead of writing a file. This module
+is the consumer: it attaches to the segment, reads records as they are
+published and releases their slots, so analysis runs while the
+simulation does and nothing goes through disk.
+
+The ring is lossless: a reader that falls behind stalls the simulator
+rather than losing records. A ring left full for longer than the
+simulator's --shm-timeout-ms (no reader, or a dead one) fails the run
+instead. Once the producer has closed the ring and
+every record has been read, the reader unlinks the segment.
+
+The indices are read and written as aligned 8-byte words. That gives the
+ordering the protocol needs on x86-64 (loads are not reordered with
+other loads, stores not with other stores), the platform the simulator
+runs on.
+
+Usage:
+    python trace_ring.py shm://NAME [--timeout SECONDS]
+
+    Prints each record as JSON, like trace_decode.py.
+"""
+
+import json
+import mmap
+import os
+import struct
+import sys
+import time
+from pathlib import Path
+from typing import Callable, Iterator, List, Optional
+
+if __package__:
+    from .trace_decode import TRACE_RECORD_SIZE, TraceRecord, decode_trace
+else:
+    from trace_decode import TRACE_RECORD_SIZE, TraceRecord, decode_trace
+
+
+SHM_PREFIX = 'shm://'
+SHM_DIR = Path('/dev/shm')   # Where Linux keeps POSIX shared memory
+
+RING_MAGIC = b'STR1'
+RING_VERSION = 1
+RING_HEADER_SIZE = 192
+
+# magic, version, record_size, capacity, header_size, closed
+_HEADER = struct.Struct('<4sHHIII')
+_HEAD_OFFSET = 64
+_TAIL_OFFSET = 128
+_INDEX = struct.Struct('<Q')
+
+
+def is_shm_output(output: str) -> bool:
+    """True if output names a shared-memory ring (shm://NAME)."""
+    return str(output).startswith(SHM_PREFIX)
+
+
+def ring_name(output: str) -> str:
+    """Segment name of an shm://NAME output."""
+    name = str(output)[len(SHM_PREFIX):] if is_shm_output(output) else str(output)
+    if not name or '/' in name:
+        raise ValueError(f"Invalid shared memory output: {output} (expected shm://NAME)")
+    return name
+
+
+def remove_ring(output: str) -> bool:
+    """Unlink a leftover segment (e.g. from a reader that never finished).
+
+    Returns:
+        True if a segment was removed
+    """
+    try:
+        (SHM_DIR / ring_name(output)).unlink()
+        return True
+    except FileNotFoundError:
+        return False
+
+
+class TraceRingReader:
+    """Consumer side of a shared-memory trace ring."""
+
+    def __init__(self, output: str, unlink: bool = True):
+        """Initialize reader.
+
+        Args:
+            output: Ring to read, shm://NAME (or just NAME)
+            unlink: Remove the segment once the closed ring is drained
+        """
+        self.name = ring_name(output)
+        self.path = SHM_DIR / self.name
+        self.unlink = unlink
+        self.records_read = 0
+
+        self._mm: Optional[mmap.mmap] = None
+        self._capacity = 0
+        self._tail = 0
+
+    def attach(self, done: Optional[Callable[[], bool]] = None,
+               poll_interval: float = 0.01, timeout: Optional[float] = None) -> bool:
+        """Wait for the producer to create the ring and map it.
+
+        Args:
+            done: Returns True once the producer has exited (it will not
+                create the ring any more)
+            poll_interval: Seconds between attempts
+            timeout: Give up after this many seconds (None = no limit)
+
+        Returns:
+            True once attached, False if the producer exited or timed out
+        """
+        deadline = None if timeout is None else time.monotonic() + timeout
+        while self._mm is None:
+            if self._try_attach():
+                return True
+            # Checked after the attempt: the ring may appear as it exits
+            if (done is not None and done()) or (
+                    deadline is not None and time.monotonic() >= deadline):
+                return self._try_attach()
+            time.sleep(poll_interval)
+        return True
+
+    def _try_attach(self) -> bool:
+        try:
+            fd = os.open(self.path, os.O_RDWR)
+        except FileNotFoundError:
+            return False
+        try:
+            size = os.fstat(fd).st_size
+            if size < RING_HEADER_SIZE:
+                return False   # Created but not sized yet
+            mm = mmap.mmap(fd, size)
+        finally:
+            os.close(fd)
+
+        magic, version, record_size, capacity, header_size, _ = _HEADER.unpack_from(mm, 0)
+        if magic != RING_MAGIC:
+            mm.close()         # Producer still filling in the header
+            return False
+        if (version != RING_VERSION or record_size != TRACE_RECORD_SIZE or
+                header_size != RING_HEADER_SIZE or
+                size < header_size + capacity * record_size):
+            mm.close()
+            raise ValueError(f"{self.path}: unsupported ring (version {version}, "
+                             f"{record_size}-byte records, capacity {capacity})")
+
+        self._mm = mm
+        self._capacity = capacity
+        self._tail = _INDEX.unpack_from(mm, _TAIL_OFFSET)[0]
+        return True
+
+    @property
+    def attached(self) -> bool:
+        return self._mm is not None
+
+    @property
+    def closed(self) -> bool:
+        """True once the producer has published its last record."""
+        return self._mm is not None and _HEADER.unpack_from(self._mm, 0)[5] != 0
+
+    def read_available(self, max_records: Optional[int] = None) -> bytes:
+        """Take whole records published since the last read.
+
+        Their slots are handed back to the producer before returning.
+
+        Args:
+            max_records: Upper bound on records taken (None = all available)
+
+        Returns:
+            Raw records (a multiple of TRACE_RECORD_SIZE bytes, maybe empty)
+        """
+        mm = self._mm
+        head = _INDEX.unpack_from(mm, _HEAD_OFFSET)[0]
+        count = head - self._tail
+        if max_records is not None:
+            count = min(count, max_records)
+        if count == 0:
+            return b''
+
+        # At most two runs: up to the end of the ring, then from its start
+        first = self._tail % self._capacity
+        run = min(count, self._capacity - first)
+        start = RING_HEADER_SIZE + first * TRACE_RECORD_SIZE
+        data = mm[start:start + run * TRACE_RECORD_SIZE]
+        if run < count:
+            data += mm[RING_HEADER_SIZE:RING_HEADER_SIZE + (count - run) * TRACE_RECORD_SIZE]
+
+        # Copied out above, so the slots can be reused
+        self._tail += count
+        _INDEX.pack_into(mm, _TAIL_OFFSET, self._tail)
+        self.records_read += count
+        return data
+
+    def follow(
+        self,
+        done: Optional[Callable[[], bool]] = None,
+        poll_interval: float = 0.001,
+        timeout: Optional[float] = None,
+        batch_records: int = 4096,
+    ) -> Iterator[bytes]:
+        """Yield batches of raw records until the ring is closed and drained.
+
+        Args:
+            done: Returns True once the producer has exited. Covers a
+                producer that died without closing the ring: it is read
+                to its end and following stops.
+            poll_interval: Seconds to sleep when the ring is empty
+            timeout: Give up after this many seconds (None = no limit)
+            batch_records: Most records per yielded batch
+
+        Yields:
+            Raw record batches, in publication order
+        """
+        deadline = None if timeout is None else time.monotonic() + timeout
+
+        def expired() -> bool:
+            return deadline is not None and time.monotonic() >= deadline
+
+        if not self.attach(done, timeout=timeout):
+            return
+
+        while True:
+            data = self.read_available(batch_records)
+            if data:
+                yield data
+                continue
+            # Closed (or the producer is gone) and one more read found nothing
+            if self.closed or (done is not None and done()):
+                data = self.read_available()
+                if data:
+                    yield data
+                    continue
+                break
+            if expired():
+                break
+            time.sleep(poll_interval)
+
+        self.close(drained=self.closed)
+
+    def records(self, **kwargs) -> Iterator[TraceRecord]:
+        """Decoded records; takes the arguments of follow()."""
+        for data in self.follow(**kwargs):
+            for i in range(0, len(data), TRACE_RECORD_SIZE):
+                yield decode_trace(data[i:i + TRACE_RECORD_SIZE])
+
+    def read_all(self, **kwargs) -> List[TraceRecord]:
+        """Every record until the ring is closed; takes the arguments of follow()."""
+        return list(self.records(**kwargs))
+
+    def close(self, drained: bool = False) -> None:
+        """Unmap the ring, and unlink it if it was drained and unlink is set."""
+        if self._mm is not None:
+            self._mm.close()
+            self._mm = None
+        if drained and self.unlink:
+            try:
+                self.path.unlink()
+            except FileNotFoundError:
+                pass
+
+    def __enter__(self) -> 'TraceRingReader':
+        return self
+
+    def __exit__(self, *exc) -> None:
+        self.close()
+
+
+def main():
+    """Command-line interface: print records from a ring as JSON lines."""
+    import argparse
+
+    parser = argparse.ArgumentParser(description='Read traces from a shared-memory ring')
+    parser.add_argument('output', help='Ring name (shm://NAME)')
+    parser.add_argument('--timeout', type=float, default=None,
+                        help='Stop after this many seconds (default: until closed)')
+    args = parser.parse_args()
+
+    try:
+        reader = TraceRingReader(args.output)
+        for rec in reader.records(timeout=args.timeout):
+            print(json.dumps(rec.to_dict()))
+    except (OSError, ValueError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -26,6 +26,12 @@ module sentinel_shell
   input  logic clk,
   input  logic rst_n,
 
+  // ===== Simulation Time Skip =====
+  // Extra cycles added to the cycle counter on this clock, on top of the
+  // normal increment. Lets a testbench jump over idle stretches with one
+  // evaluated cycle. Tie to '0 in hardware.
+  input  logic [CYCLE_WIDTH-1:0]  cycle_skip,
+
   // ===== Input Stream (from upstream) =====
   input  logic                    in_valid,
   output logic                    in_ready,
@@ -82,7 +88,7 @@ module sentinel_shell
     if (!rst_n)
       cycle_counter <= '0;
     else
-      cycle_counter <= cycle_counter + 1'b1;
+      cycle_counter <= cycle_counter + 1'b1 + cycle_skip;
   end
 
   // =========================================================================
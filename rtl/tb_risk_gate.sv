@@ -2,11 +2,13 @@
 
 `include "risk_pkg.sv"
 `include "risk_gate.sv"
+`include "risk_audit_log.sv"
 
 module tb_risk_gate
   import risk_pkg::*;
 #(
-  parameter int DATA_WIDTH = 64
+  parameter int DATA_WIDTH = 64,
+  parameter int AUDIT_FIFO_DEPTH = 256
 )(
   input  logic        clk,
   input  logic        rst_n,
@@ -45,6 +47,7 @@ module tb_risk_gate
   output logic        out_valid,
   input  logic        out_ready,
   output logic [DATA_WIDTH-1:0] out_data,
+  output logic [63:0] out_order_id,
   output logic        out_rejected,
   output logic [7:0]  out_reject_reason,
 
@@ -70,7 +73,17 @@ module tb_risk_gate
   output logic [63:0] stat_passed,
   output logic [63:0] stat_rejected_rate,
   output logic [63:0] stat_rejected_pos,
-  output logic [63:0] stat_rejected_kill
+  output logic [63:0] stat_rejected_kill,
+
+  // Audit log: one record per decision handed off on out_valid/out_ready
+  input  logic [63:0]  audit_timestamp_ns,
+  input  logic [127:0] audit_prev_hash_lo,
+  output logic         audit_rec_valid,
+  output logic [767:0] audit_rec_data,
+  input  logic         audit_rec_ready,
+  output logic [63:0]  stat_audit_emitted,
+  output logic [63:0]  stat_audit_dropped,
+  output logic         audit_fifo_full
 );
 
   // Pack order struct
@@ -144,8 +157,34 @@ module tb_risk_gate
     .stat_rejected_kill     (stat_rejected_kill)
   );
 
+  // Audit log of every decision the consumer takes
+  risk_audit_log #(
+    .DATA_WIDTH(DATA_WIDTH),
+    .FIFO_DEPTH(AUDIT_FIFO_DEPTH)
+  ) u_audit_log (
+    .clk                  (clk),
+    .rst_n                (rst_n),
+    .timestamp_ns         (audit_timestamp_ns),
+    .dec_valid            (out_valid && out_ready),
+    .dec_order            (out_order_packed),
+    .dec_passed           (!out_rejected),
+    .dec_reject_reason    (reject_reason),
+    .dec_kill_triggered   (kill_switch_active),
+    .dec_tokens_remaining (status.tokens_remaining),
+    .dec_position_after   (status.current_position),
+    .dec_notional_after   (status.current_notional),
+    .prev_hash_lo         (audit_prev_hash_lo),
+    .rec_valid            (audit_rec_valid),
+    .rec_data             (audit_rec_data),
+    .rec_ready            (audit_rec_ready),
+    .stat_records_emitted (stat_audit_emitted),
+    .stat_records_dropped (stat_audit_dropped),
+    .stat_fifo_full       (audit_fifo_full)
+  );
+
   // Unpack outputs
   assign out_reject_reason = reject_reason;
+  assign out_order_id      = out_order_packed.order_id;
   assign status_passed     = status.passed;
   assign status_tokens     = status.tokens_remaining;
   // current_position is signed [64:0] (net_position_t). Truncate to 64 bits
@@ -0,0 +1,179 @@
+/*
+ * Open-Loop Arrival Processes
+ *
+ * Arrival schedules for the shell's open-loop load generator (--test
+ * load). A process yields the intended arrival time of every transaction
+ * regardless of what the shell does: a transaction that cannot be
+ * accepted yet waits in the generator, and its latency is measured from
+ * when it was meant to arrive. Back-pressure therefore shows up in the
+ * latency quantiles instead of silently slowing the offered load
+ * (coordinated omission).
+ *
+ * Rates are percent of line rate (one transaction per cycle) and may
+ * exceed 100 to overload the shell. Specs, as given to --load:
+ *
+ *   constant:PCT                           Evenly spaced arrivals
+ *   poisson:PCT[:SEED]                     Exponential inter-arrival times
+ *   mmpp:LOW:HIGH:LOW_CYC:HIGH_CYC[:SEED]  Two-state Markov-modulated
+ *                                          Poisson: LOW% for stretches of
+ *                                          mean LOW_CYC cycles, then HIGH%
+ *                                          for stretches of mean HIGH_CYC
+ *                                          (exponential), e.g. bursts
+ *
+ * Times are continuous, in cycles from start(); a transaction arrives in
+ * the first cycle at or after its time, so several can share a cycle.
+ */
+
+#ifndef SENTINEL_ARRIVAL_PROCESS_H
+#define SENTINEL_ARRIVAL_PROCESS_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+class ArrivalProcess {
+public:
+    enum Kind { CONSTANT, POISSON, MMPP };
+
+    ArrivalProcess() = default;
+
+    bool parse(const std::string& text) {
+        spec = text;
+        std::vector<std::string> f = split(text);
+        const std::string& k = f[0];
+        bool ok = true;
+        seeded = false;
+        if (k == "constant" && f.size() == 2) {
+            kind = CONSTANT;
+            ok = to_pct(f[1], rate);
+        } else if (k == "poisson" && (f.size() == 2 || f.size() == 3)) {
+            kind = POISSON;
+            ok = to_pct(f[1], rate) && (f.size() == 2 || to_u64(f[2], seed));
+            seeded = f.size() == 3;
+        } else if (k == "mmpp" && (f.size() == 5 || f.size() == 6)) {
+            kind = MMPP;
+            ok = to_double(f[1], low_rate) && low_rate >= 0.0 && to_pct(f[2], rate) &&
+                 to_double(f[3], low_cycles) && low_cycles > 0.0 &&
+                 to_double(f[4], high_cycles) && high_cycles > 0.0 &&
+                 (f.size() == 5 || to_u64(f[5], seed));
+            low_rate /= 100.0;
+            seeded = f.size() == 6;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            fprintf(stderr, "Error: Invalid load %s (expected constant:PCT, poisson:PCT[:SEED] "
+                    "or mmpp:LOW:HIGH:LOW_CYC:HIGH_CYC[:SEED], rates in %% of line rate)\n",
+                    text.c_str());
+        }
+        return ok;
+    }
+
+    // Restart the schedule at time 0; default_seed is used by an unseeded
+    // poisson/mmpp process
+    void start(uint64_t default_seed = 1) {
+        rng.seed(seeded ? seed : default_seed);
+        unit.reset();
+        t = 0.0;
+        arrivals = 0;
+        high = false;
+        state_end = kind == MMPP ? low_cycles * unit(rng) : INFINITY;
+    }
+
+    // Time of the next arrival, in cycles since start()
+    double next() {
+        switch (kind) {
+        case CONSTANT:
+            // From the count rather than accumulated, so there is no drift
+            t = ++arrivals / rate;
+            return t;
+        case POISSON:
+            t += unit(rng) / rate;
+            return t;
+        case MMPP:
+        default:
+            for (;;) {
+                double r = high ? rate : low_rate;
+                double dt = r > 0.0 ? unit(rng) / r : INFINITY;
+                if (t + dt <= state_end) {
+                    t += dt;
+                    return t;
+                }
+                // Memoryless: the draw is simply discarded at a switch
+                t = state_end;
+                high = !high;
+                state_end = t + (high ? high_cycles : low_cycles) * unit(rng);
+            }
+        }
+    }
+
+    // Mean offered load, as a fraction of line rate
+    double offered_load() const {
+        if (kind != MMPP) {
+            return rate;
+        }
+        return (low_rate * low_cycles + rate * high_cycles) / (low_cycles + high_cycles);
+    }
+
+    Kind process_kind() const { return kind; }
+    const std::string& text() const { return spec; }
+
+private:
+    static std::vector<std::string> split(const std::string& s) {
+        std::vector<std::string> out;
+        size_t pos = 0;
+        for (;;) {
+            size_t colon = s.find(':', pos);
+            out.push_back(s.substr(pos, colon - pos));
+            if (colon == std::string::npos) {
+                return out;
+            }
+            pos = colon + 1;
+        }
+    }
+
+    static bool to_u64(const std::string& s, uint64_t& v) {
+        char* end = nullptr;
+        v = strtoull(s.c_str(), &end, 0);
+        return !s.empty() && *end == '\0';
+    }
+
+    static bool to_double(const std::string& s, double& v) {
+        char* end = nullptr;
+        v = strtod(s.c_str(), &end);
+        return !s.empty() && *end == '\0' && std::isfinite(v);
+    }
+
+    // Percent of line rate (> 0) to transactions per cycle
+    static bool to_pct(const std::string& s, double& v) {
+        if (!to_double(s, v) || v <= 0.0) {
+            return false;
+        }
+        v /= 100.0;
+        return true;
+    }
+
+    Kind kind = POISSON;
+    std::string spec = "poisson:50";
+
+    double rate = 0.5;        // Per cycle (mmpp: the high state)
+    double low_rate = 0.0;    // mmpp low state, per cycle
+    double low_cycles = 0.0;  // mmpp mean state durations
+    double high_cycles = 0.0;
+
+    uint64_t seed = 1;
+    bool seeded = false;
+    std::mt19937_64 rng;
+    std::exponential_distribution<double> unit{1.0};
+
+    double t = 0.0;
+    uint64_t arrivals = 0;
+    bool high = false;
+    double state_end = INFINITY;
+};
+
+#endif
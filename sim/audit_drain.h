@@ -0,0 +1,323 @@
+/*
+ * Audit Log Drain
+ *
+ * Host side of rtl/risk_audit_log.sv for the risk gate testbench. The
+ * RTL serialises one 96-byte record per decision but computes no hash:
+ * the host chains them (BLAKE2b-256 of each record's first 80 bytes, see
+ * blake2b.h and sentinel_hft/audit/record.py) and feeds the low 128 bits
+ * back on prev_hash_lo. The drain splits that work over two threads:
+ *
+ *   sim thread     Before every clock edge, step(): take the head record
+ *                  with rec_ready high and copy it into a single-producer
+ *                  /single-consumer ring; drive prev_hash_lo with the
+ *                  newest chain head the hasher has published
+ *   hasher thread  Pop records, check seq_no is gapless, chain them, and
+ *                  write them to the log file in batches
+ *
+ * rec_ready drops only when the ring is full, and every such cycle is
+ * counted (ready_stalls): a run with none shows the host keeping up with
+ * the RTL without ever back-pressuring it. host_ns_per_record is the
+ * hasher's busy time per record, to hold against the clock period.
+ *
+ * The chain written to the file is the host's: each record's
+ * prev_hash_lo is set to the hash of the one before it, so the file
+ * verifies with sentinel_hft.audit.verify. The on-chip value the record
+ * carried lags by however many records the hasher was behind when it
+ * was written; prev_hash_matches counts the records where it was
+ * already current. The file starts with the SAUD header of
+ * sentinel_hft/audit/record.py.
+ */
+
+#ifndef SENTINEL_AUDIT_DRAIN_H
+#define SENTINEL_AUDIT_DRAIN_H
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "blake2b.h"
+
+struct AuditDrainStats {
+    uint64_t records = 0;            // Chained (and written)
+    uint64_t overflow_markers = 0;   // REC_OVERFLOW records: the RTL dropped decisions
+    uint64_t seq_gaps = 0;           // seq_no not one past the previous record's
+    uint64_t prev_hash_matches = 0;  // On-chip prev_hash_lo already the chain head
+    uint64_t ready_stalls = 0;       // Cycles rec_ready was held low, ring full
+    uint64_t peak_queue = 0;         // Ring occupancy high-water mark (records)
+    uint64_t batches = 0;            // File writes
+    double host_ns_per_record = 0.0;
+    uint8_t head_hash_lo[16] = {};   // Last record's hash, low 128 bits
+};
+
+class AuditDrain {
+public:
+    static constexpr size_t RECORD_BYTES = 96;
+    static constexpr size_t PAYLOAD_BYTES = 80;  // Hashed: all but prev_hash_lo
+    static constexpr uint16_t FORMAT_VERSION = 1;
+    static constexpr uint16_t FLAG_OVERFLOW = 0x8000;
+
+    AuditDrain() = default;
+
+    ~AuditDrain() {
+        close();
+    }
+
+    AuditDrain(const AuditDrain&) = delete;
+    AuditDrain& operator=(const AuditDrain&) = delete;
+
+    // Start the hasher; path may be empty to chain without writing.
+    // queue_records is rounded up to a power of two.
+    bool open(const std::string& path, size_t queue_records = 1u << 14,
+              size_t batch_records = 4096) {
+        size_t capacity = 2 * PUBLISH_BATCH;
+        while (capacity < queue_records) capacity <<= 1;
+        ring.assign(capacity * RECORD_BYTES, 0);
+        mask = capacity - 1;
+        batch_limit = batch_records > 0 ? batch_records : 1;
+        batch.reserve(batch_limit * RECORD_BYTES);
+        if (!path.empty()) {
+            out = fopen(path.c_str(), "wb");
+            if (!out) {
+                fprintf(stderr, "Error: Could not open %s: %s\n", path.c_str(), strerror(errno));
+                return false;
+            }
+            uint8_t header[16] = {'S', 'A', 'U', 'D'};
+            put_u16(header + 4, FORMAT_VERSION);
+            put_u16(header + 6, RECORD_BYTES);
+            if (fwrite(header, sizeof(header), 1, out) != 1) {
+                write_failed = true;
+            }
+        }
+        hasher = std::thread([this] { run_hasher(); });
+        return true;
+    }
+
+    // Once per cycle, after the inputs are settled and before the clock
+    // edge: drive rec_ready and prev_hash_lo, and take the head record if
+    // it leaves on this edge
+    template <typename Dut>
+    void step(Dut& d) {
+        load_prev(d.audit_prev_hash_lo);
+        if (!d.audit_rec_valid) {
+            d.audit_rec_ready = 1;
+            return;
+        }
+        if (head - cached_tail > mask) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (head - cached_tail > mask) {
+                head_pub.store(head, std::memory_order_release);
+                d.audit_rec_ready = 0;
+                stats.ready_stalls++;
+                return;
+            }
+        }
+        d.audit_rec_ready = 1;
+        uint8_t* slot = &ring[(head & mask) * RECORD_BYTES];
+        for (int w = 0; w < static_cast<int>(RECORD_BYTES / 4); w++) {
+            put_u32(slot + 4 * w, d.audit_rec_data[w]);
+        }
+        head++;
+        publish_head();
+    }
+
+    // Wait for the hasher to chain everything taken, flush and close the
+    // file. False if a write failed.
+    bool close() {
+        if (!hasher.joinable()) {
+            return !write_failed;
+        }
+        head_pub.store(head, std::memory_order_release);
+        done.store(true, std::memory_order_release);
+        hasher.join();
+        if (out) {
+            if (fclose(out) != 0) write_failed = true;
+            out = nullptr;
+        }
+        stats.records = chain.records;
+        stats.overflow_markers = chain.overflow_markers;
+        stats.seq_gaps = chain.seq_gaps;
+        stats.prev_hash_matches = chain.prev_hash_matches;
+        stats.batches = chain.batches;
+        stats.host_ns_per_record = chain.records > 0 ? chain.busy_ns / chain.records : 0.0;
+        memcpy(stats.head_hash_lo, chain.prev, sizeof(chain.prev));
+        if (write_failed) {
+            fprintf(stderr, "Error: Audit log write failed\n");
+        }
+        return !write_failed;
+    }
+
+    // Complete once close() has returned
+    const AuditDrainStats& result() const { return stats; }
+
+    // Records taken so far (sim thread)
+    uint64_t taken() const { return head; }
+
+private:
+    // Hasher side of the ring and the chain; touched by the hasher only
+    // until close() has joined it
+    struct Chain {
+        uint8_t prev[16] = {};  // Seed: all zeros
+        uint64_t records = 0;
+        uint64_t next_seq = 0;
+        uint64_t overflow_markers = 0;
+        uint64_t seq_gaps = 0;
+        uint64_t prev_hash_matches = 0;
+        uint64_t batches = 0;
+        double busy_ns = 0.0;
+    };
+
+    static void put_u16(uint8_t* p, uint16_t v) {
+        p[0] = static_cast<uint8_t>(v);
+        p[1] = static_cast<uint8_t>(v >> 8);
+    }
+
+    static void put_u32(uint8_t* p, uint32_t v) {
+        for (int b = 0; b < 4; b++) p[b] = static_cast<uint8_t>(v >> (8 * b));
+    }
+
+    static uint64_t get_u64(const uint8_t* p) {
+        uint64_t v = 0;
+        for (int b = 7; b >= 0; b--) v = (v << 8) | p[b];
+        return v;
+    }
+
+    // Records are released to the hasher in groups of PUBLISH_BATCH, so a
+    // run of back-to-back decisions costs one shared cache line write per
+    // group; a full ring and close() release the rest
+    void publish_head() {
+        if ((head & (PUBLISH_BATCH - 1)) == 0) {
+            head_pub.store(head, std::memory_order_release);
+        }
+        uint64_t depth = head - cached_tail;
+        if (depth > stats.peak_queue) {
+            // Refresh before recording a new peak so it is not a stale overestimate
+            cached_tail = tail.load(std::memory_order_acquire);
+            depth = head - cached_tail;
+            if (depth > stats.peak_queue) stats.peak_queue = depth;
+        }
+    }
+
+    // Newest chain head, via a seqlock: the hasher bumps version to odd,
+    // stores the hash, then bumps it to even
+    template <typename Wide>
+    void load_prev(Wide& port) {
+        uint64_t v = published_version.load(std::memory_order_acquire);
+        if (v == seen_version || (v & 1)) {
+            return;  // Unchanged, or mid-update: keep driving the last value
+        }
+        uint64_t lo = published_lo.load(std::memory_order_relaxed);
+        uint64_t hi = published_hi.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (published_version.load(std::memory_order_relaxed) != v) {
+            return;
+        }
+        seen_version = v;
+        port[0] = static_cast<uint32_t>(lo);
+        port[1] = static_cast<uint32_t>(lo >> 32);
+        port[2] = static_cast<uint32_t>(hi);
+        port[3] = static_cast<uint32_t>(hi >> 32);
+    }
+
+    void publish_prev(const uint8_t* prev) {
+        uint64_t v = published_version.load(std::memory_order_relaxed);
+        published_version.store(v + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        published_lo.store(get_u64(prev), std::memory_order_relaxed);
+        published_hi.store(get_u64(prev + 8), std::memory_order_relaxed);
+        published_version.store(v + 2, std::memory_order_release);
+    }
+
+    void run_hasher() {
+        uint64_t pos = 0;
+        for (;;) {
+            uint64_t avail = head_pub.load(std::memory_order_acquire);
+            if (pos == avail) {
+                if (done.load(std::memory_order_acquire) &&
+                    pos == head_pub.load(std::memory_order_acquire)) {
+                    break;
+                }
+                flush_batch();
+                std::this_thread::yield();
+                continue;
+            }
+            auto start = std::chrono::steady_clock::now();
+            for (; pos < avail; pos++) {
+                chain_record(&ring[(pos & mask) * RECORD_BYTES]);
+            }
+            tail.store(pos, std::memory_order_release);
+            publish_prev(chain.prev);
+            if (batch.size() >= batch_limit * RECORD_BYTES) {
+                flush_batch();
+            }
+            chain.busy_ns += std::chrono::duration<double, std::nano>(
+                                 std::chrono::steady_clock::now() - start).count();
+        }
+        flush_batch();
+    }
+
+    void chain_record(const uint8_t* rec) {
+        uint64_t seq = get_u64(rec);
+        uint16_t flags = static_cast<uint16_t>(rec[30] | (rec[31] << 8));
+        if (seq != chain.next_seq) chain.seq_gaps++;
+        chain.next_seq = seq + 1;
+        if (flags & FLAG_OVERFLOW) chain.overflow_markers++;
+        if (memcmp(rec + PAYLOAD_BYTES, chain.prev, sizeof(chain.prev)) == 0) {
+            chain.prev_hash_matches++;
+        }
+
+        size_t at = batch.size();
+        batch.resize(at + RECORD_BYTES);
+        memcpy(&batch[at], rec, PAYLOAD_BYTES);
+        memcpy(&batch[at + PAYLOAD_BYTES], chain.prev, sizeof(chain.prev));
+
+        uint8_t digest[32];
+        Blake2b::hash(digest, sizeof(digest), rec, PAYLOAD_BYTES);
+        memcpy(chain.prev, digest, sizeof(chain.prev));
+        chain.records++;
+    }
+
+    void flush_batch() {
+        if (batch.empty()) {
+            return;
+        }
+        if (out && fwrite(batch.data(), 1, batch.size(), out) != batch.size()) {
+            write_failed = true;
+        }
+        chain.batches++;
+        batch.clear();
+    }
+
+    static constexpr uint64_t PUBLISH_BATCH = 16;
+
+    std::vector<uint8_t> ring;
+    uint64_t mask = 0;
+
+    // Sim thread
+    uint64_t head = 0;
+    uint64_t cached_tail = 0;
+    uint64_t seen_version = 0;
+    AuditDrainStats stats;
+
+    alignas(64) std::atomic<uint64_t> head_pub{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+    alignas(64) std::atomic<uint64_t> published_version{0};
+    std::atomic<uint64_t> published_lo{0};
+    std::atomic<uint64_t> published_hi{0};
+    std::atomic<bool> done{false};
+
+    // Hasher thread
+    Chain chain;
+    std::vector<uint8_t> batch;
+    size_t batch_limit = 1;
+    FILE* out = nullptr;
+    bool write_failed = false;
+    std::thread hasher;
+};
+
+#endif
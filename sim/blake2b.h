@@ -0,0 +1,142 @@
+/*
+ * BLAKE2b
+ *
+ * Unkeyed BLAKE2b (RFC 7693) for the audit log drain (audit_drain.h).
+ * The host chains risk_audit_log records with BLAKE2b-256 of each
+ * record's first 80 bytes, as hashlib.blake2b(payload, digest_size=32)
+ * does in sentinel_hft/audit/record.py, so chains built here verify
+ * there.
+ *
+ * An 80-byte payload is a single compression; nothing is allocated.
+ */
+
+#ifndef SENTINEL_BLAKE2B_H
+#define SENTINEL_BLAKE2B_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class Blake2b {
+public:
+    static constexpr size_t BLOCK_BYTES = 128;
+    static constexpr size_t MAX_DIGEST_BYTES = 64;
+
+    explicit Blake2b(size_t digest_bytes = 32) : digest_len(digest_bytes) {
+        for (int i = 0; i < 8; i++) {
+            h[i] = IV[i];
+        }
+        h[0] ^= 0x01010000u ^ digest_len;
+    }
+
+    void update(const void* data, size_t len) {
+        const uint8_t* in = static_cast<const uint8_t*>(data);
+        while (len > 0) {
+            // The last block is compressed in final(), so keep one back
+            if (fill == BLOCK_BYTES) {
+                count += BLOCK_BYTES;
+                compress(false);
+                fill = 0;
+            }
+            size_t n = BLOCK_BYTES - fill < len ? BLOCK_BYTES - fill : len;
+            memcpy(block + fill, in, n);
+            fill += n;
+            in += n;
+            len -= n;
+        }
+    }
+
+    void final(uint8_t* digest) {
+        count += fill;
+        memset(block + fill, 0, BLOCK_BYTES - fill);
+        compress(true);
+        for (size_t i = 0; i < digest_len; i++) {
+            digest[i] = static_cast<uint8_t>(h[i / 8] >> (8 * (i % 8)));
+        }
+    }
+
+    // One-shot digest of data into digest[digest_bytes]
+    static void hash(uint8_t* digest, size_t digest_bytes, const void* data, size_t len) {
+        Blake2b b(digest_bytes);
+        b.update(data, len);
+        b.final(digest);
+    }
+
+private:
+    static constexpr uint64_t IV[8] = {
+        0x6a09e667f3bcc908ull, 0xbb67ae8584caa73bull, 0x3c6ef372fe94f82bull,
+        0xa54ff53a5f1d36f1ull, 0x510e527fade682d1ull, 0x9b05688c2b3e6c1full,
+        0x1f83d9abfb41bd6bull, 0x5be0cd19137e2179ull,
+    };
+
+    static constexpr uint8_t SIGMA[12][16] = {
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+        {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+        {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+        {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+        {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+        {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+        {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+        {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+        {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+        {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+        {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+    };
+
+    static uint64_t rotr(uint64_t x, int n) {
+        return (x >> n) | (x << (64 - n));
+    }
+
+    static void mix(uint64_t* v, int a, int b, int c, int d, uint64_t x, uint64_t y) {
+        v[a] = v[a] + v[b] + x;
+        v[d] = rotr(v[d] ^ v[a], 32);
+        v[c] = v[c] + v[d];
+        v[b] = rotr(v[b] ^ v[c], 24);
+        v[a] = v[a] + v[b] + y;
+        v[d] = rotr(v[d] ^ v[a], 16);
+        v[c] = v[c] + v[d];
+        v[b] = rotr(v[b] ^ v[c], 63);
+    }
+
+    void compress(bool last) {
+        uint64_t m[16];
+        for (int i = 0; i < 16; i++) {
+            m[i] = 0;
+            for (int b = 7; b >= 0; b--) {
+                m[i] = (m[i] << 8) | block[8 * i + b];
+            }
+        }
+        uint64_t v[16];
+        for (int i = 0; i < 8; i++) {
+            v[i] = h[i];
+            v[i + 8] = IV[i];
+        }
+        v[12] ^= count;  // Byte counts stay far below 2^64
+        if (last) {
+            v[14] = ~v[14];
+        }
+        for (int r = 0; r < 12; r++) {
+            const uint8_t* s = SIGMA[r];
+            mix(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+            mix(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+            mix(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+            mix(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+            mix(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+            mix(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            mix(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+            mix(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+        }
+        for (int i = 0; i < 8; i++) {
+            h[i] ^= v[i] ^ v[i + 8];
+        }
+    }
+
+    uint64_t h[8];
+    uint64_t count = 0;
+    uint8_t block[BLOCK_BYTES];
+    size_t fill = 0;
+    size_t digest_len;
+};
+
+#endif
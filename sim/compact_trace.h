@@ -0,0 +1,180 @@
+/*
+ * Compact Trace Format
+ *
+ * Block-based, delta-encoded alternative to raw 32-byte trace records
+ * (--format compact). tx_id is sequential and timestamps are monotonic,
+ * so most fields delta-encode to a single varint byte.
+ *
+ * File layout (all integers little-endian):
+ *
+ *   header   "STC1" | u16 version | u16 codec | u32 record_size | u32 0
+ *   block*   u32 stored_size | u32 raw_size | u32 count | payload
+ *   index    per block: u64 offset | u64 first_tx_id | u64 first_t_ingress
+ *                       | u32 count | u32 0
+ *   trailer  u64 index_offset | u32 num_blocks | "STCI"
+ *
+ * A block payload is count records of six varints; every block starts
+ * from zeroed state so any block can be decoded on its own:
+ *
+ *   zigzag(tx_id - (prev_tx_id + 1))
+ *   zigzag(t_ingress - prev_t_ingress)
+ *   zigzag(latency - prev_latency)          latency = t_egress - t_ingress
+ *   flags
+ *   zigzag(opcode - prev_opcode)
+ *   zigzag(meta - prev_meta)
+ *
+ * With codec zstd the payload is compressed; a block whose stored_size
+ * equals raw_size was left uncompressed. The index and trailer make
+ * random access a seek; a file without a trailer (still being written)
+ * can be read block by block from the header.
+ *
+ * Decoder: host/trace_decode.py (decode_compact_file).
+ */
+
+#ifndef SENTINEL_COMPACT_TRACE_H
+#define SENTINEL_COMPACT_TRACE_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef SENTINEL_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "trace_sink.h"
+
+enum CompactCodec : uint16_t {
+    COMPACT_CODEC_NONE = 0,
+    COMPACT_CODEC_ZSTD = 1,
+};
+
+// True if this build can write codec
+inline bool compact_codec_available(CompactCodec codec) {
+#ifdef SENTINEL_HAVE_ZSTD
+    return codec == COMPACT_CODEC_NONE || codec == COMPACT_CODEC_ZSTD;
+#else
+    return codec == COMPACT_CODEC_NONE;
+#endif
+}
+
+template <typename Record>
+class CompactTraceEncoder : public TraceBlockEncoder<Record> {
+public:
+    explicit CompactTraceEncoder(CompactCodec codec = COMPACT_CODEC_NONE, int level = 3)
+        : codec(codec), level(level) {}
+
+    void header(std::vector<uint8_t>& out) override {
+        index.clear();
+        offset = 0;
+        size_t start = out.size();
+        put_bytes(out, "STC1", 4);
+        put_u16(out, 1);
+        put_u16(out, codec);
+        put_u32(out, sizeof(Record));
+        put_u32(out, 0);
+        offset += out.size() - start;
+    }
+
+    void encode(const Record* recs, size_t count, std::vector<uint8_t>& out) override {
+        if (count == 0) {
+            return;
+        }
+
+        raw.clear();
+        uint64_t next_tx = 0;
+        uint64_t prev_in = 0;
+        int64_t prev_lat = 0;
+        uint32_t prev_opcode = 0;
+        uint32_t prev_meta = 0;
+        for (size_t i = 0; i < count; i++) {
+            const Record& r = recs[i];
+            int64_t lat = static_cast<int64_t>(r.t_egress - r.t_ingress);
+            put_varint(raw, zigzag(static_cast<int64_t>(r.tx_id - next_tx)));
+            put_varint(raw, zigzag(static_cast<int64_t>(r.t_ingress - prev_in)));
+            put_varint(raw, zigzag(lat - prev_lat));
+            put_varint(raw, r.flags);
+            put_varint(raw, zigzag(static_cast<int64_t>(r.opcode) - prev_opcode));
+            put_varint(raw, zigzag(static_cast<int64_t>(r.meta) - prev_meta));
+            next_tx = r.tx_id + 1;
+            prev_in = r.t_ingress;
+            prev_lat = lat;
+            prev_opcode = r.opcode;
+            prev_meta = r.meta;
+        }
+
+        const std::vector<uint8_t>* payload = &raw;
+#ifdef SENTINEL_HAVE_ZSTD
+        if (codec == COMPACT_CODEC_ZSTD) {
+            packed.resize(ZSTD_compressBound(raw.size()));
+            size_t n = ZSTD_compress(packed.data(), packed.size(), raw.data(), raw.size(), level);
+            // Keep the raw payload if compression failed or did not help
+            if (!ZSTD_isError(n) && n < raw.size()) {
+                packed.resize(n);
+                payload = &packed;
+            }
+        }
+#endif
+
+        index.push_back({offset, recs[0].tx_id, recs[0].t_ingress, static_cast<uint32_t>(count)});
+
+        size_t start = out.size();
+        put_u32(out, static_cast<uint32_t>(payload->size()));
+        put_u32(out, static_cast<uint32_t>(raw.size()));
+        put_u32(out, static_cast<uint32_t>(count));
+        put_bytes(out, payload->data(), payload->size());
+        offset += out.size() - start;
+    }
+
+    void footer(std::vector<uint8_t>& out) override {
+        uint64_t index_offset = offset;
+        for (const IndexEntry& e : index) {
+            put_u64(out, e.offset);
+            put_u64(out, e.first_tx_id);
+            put_u64(out, e.first_t_ingress);
+            put_u32(out, e.count);
+            put_u32(out, 0);
+        }
+        put_u64(out, index_offset);
+        put_u32(out, static_cast<uint32_t>(index.size()));
+        put_bytes(out, "STCI", 4);
+    }
+
+private:
+    struct IndexEntry {
+        uint64_t offset;
+        uint64_t first_tx_id;
+        uint64_t first_t_ingress;
+        uint32_t count;
+    };
+
+    static uint64_t zigzag(int64_t v) {
+        return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+    }
+
+    static void put_varint(std::vector<uint8_t>& out, uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<uint8_t>(v) | 0x80);
+            v >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(v));
+    }
+
+    static void put_bytes(std::vector<uint8_t>& out, const void* p, size_t n) {
+        const uint8_t* b = static_cast<const uint8_t*>(p);
+        out.insert(out.end(), b, b + n);
+    }
+
+    static void put_u16(std::vector<uint8_t>& out, uint16_t v) { put_bytes(out, &v, 2); }
+    static void put_u32(std::vector<uint8_t>& out, uint32_t v) { put_bytes(out, &v, 4); }
+    static void put_u64(std::vector<uint8_t>& out, uint64_t v) { put_bytes(out, &v, 8); }
+
+    CompactCodec codec;
+    int level;
+    uint64_t offset = 0;
+    std::vector<IndexEntry> index;
+    std::vector<uint8_t> raw;
+    std::vector<uint8_t> packed;
+};
+
+#endif
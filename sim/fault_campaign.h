@@ -0,0 +1,191 @@
+/*
+ * Fault Campaign Specs
+ *
+ * Trials for the fault-injection campaign of sim_t2t.cpp (--faults),
+ * which arms rtl/fault_injector.sv in tb_tick_to_trade.sv. A campaign
+ * file holds one trial per line, each 1 to NUM_FAULTS comma-separated
+ * faults (# comments, blank lines skipped):
+ *
+ *   TYPE:CYCLE:DURATION[:PARAM]
+ *
+ * TYPE is a fault_pkg.sv fault_type_t name without the FAULT_ prefix
+ * (backpressure, fifo_overflow, kill_switch, corrupt_data,
+ * clock_stretch, burst, reorder, reset) or its number. The fault is in
+ * effect from replay cycle CYCLE for DURATION cycles (0 = one cycle);
+ * PARAM is fault_config_t.fault_param (bit mask, stall rate, burst
+ * length or displacement, by type; default 0).
+ *
+ *   backpressure:5000:200
+ *   corrupt_data:100:10:0x3ff,kill_switch:20000:0
+ */
+
+#ifndef SENTINEL_FAULT_CAMPAIGN_H
+#define SENTINEL_FAULT_CAMPAIGN_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// fault_injector NUM_CONFIGS in tb_tick_to_trade.sv
+static constexpr int NUM_FAULTS = 4;
+
+// fault_pkg::fault_type_t
+enum FaultType : uint8_t {
+    FAULT_NONE = 0,
+    FAULT_BACKPRESSURE = 1,
+    FAULT_FIFO_OVERFLOW = 2,
+    FAULT_KILL_SWITCH = 3,
+    FAULT_CORRUPT_DATA = 4,
+    FAULT_CLOCK_STRETCH = 5,
+    FAULT_BURST = 6,
+    FAULT_REORDER = 7,
+    FAULT_RESET = 8,
+    NUM_FAULT_TYPES
+};
+
+static const char* const FAULT_TYPE_NAMES[NUM_FAULT_TYPES] = {
+    "none", "backpressure", "fifo_overflow", "kill_switch", "corrupt_data",
+    "clock_stretch", "burst", "reorder", "reset",
+};
+
+struct FaultSpec {
+    uint8_t type = FAULT_NONE;
+    uint32_t cycle = 0;
+    uint32_t duration = 0;
+    uint32_t param = 0;
+};
+
+struct FaultTrial {
+    std::string text;              // As written; empty for the baseline
+    std::vector<FaultSpec> faults;
+
+    // Drive the injector's config ports. base is the shell cycle_counter
+    // at replay cycle 0 (the injector triggers on it, one cycle ahead of
+    // the effect).
+    template <typename Dut>
+    void arm(Dut& d, uint64_t base) const {
+        d.fault_valid = 0;
+        d.fault_type = 0;
+        for (size_t i = 0; i < faults.size(); i++) {
+            const FaultSpec& f = faults[i];
+            uint64_t trigger = base + f.cycle - 1;
+            d.fault_type |= static_cast<uint16_t>(f.type) << (4 * i);
+            d.fault_trigger_cycle[i] = static_cast<uint32_t>(trigger);
+            d.fault_duration[i] = f.duration;
+            d.fault_param[i] = f.param;
+            d.fault_valid |= 1u << i;
+        }
+    }
+};
+
+namespace fault_campaign_detail {
+
+inline bool to_u32(const std::string& s, uint32_t& out) {
+    if (s.empty()) return false;
+    char* endp = nullptr;
+    errno = 0;
+    unsigned long long v = strtoull(s.c_str(), &endp, 0);
+    if (errno != 0 || *endp != '\0' || v > UINT32_MAX) return false;
+    out = static_cast<uint32_t>(v);
+    return true;
+}
+
+inline std::vector<std::string> split(const std::string& s, char sep) {
+    std::vector<std::string> out(1);
+    for (char ch : s) {
+        if (ch == sep) {
+            out.emplace_back();
+        } else if (ch != ' ' && ch != '\t' && ch != '\r') {
+            out.back() += ch;
+        }
+    }
+    return out;
+}
+
+}  // namespace fault_campaign_detail
+
+// Parse one TYPE:CYCLE:DURATION[:PARAM]
+inline bool parse_fault_spec(const std::string& text, FaultSpec& spec) {
+    using namespace fault_campaign_detail;
+    std::vector<std::string> f = split(text, ':');
+    bool ok = f.size() == 3 || f.size() == 4;
+    if (ok) {
+        uint32_t type = NUM_FAULT_TYPES;
+        for (uint32_t k = 1; k < NUM_FAULT_TYPES; k++) {
+            if (f[0] == FAULT_TYPE_NAMES[k]) type = k;
+        }
+        if (type == NUM_FAULT_TYPES && !to_u32(f[0], type)) {
+            type = NUM_FAULT_TYPES;
+        }
+        ok = type > FAULT_NONE && type < NUM_FAULT_TYPES && to_u32(f[1], spec.cycle) &&
+             spec.cycle > 0 && to_u32(f[2], spec.duration) &&
+             (f.size() == 3 || to_u32(f[3], spec.param));
+        spec.type = static_cast<uint8_t>(type);
+        if (f.size() == 3) spec.param = 0;
+    }
+    if (!ok) {
+        fprintf(stderr, "Error: Invalid fault spec: %s (expected TYPE:CYCLE:DURATION[:PARAM], "
+                "CYCLE from 1)\n", text.c_str());
+    }
+    return ok;
+}
+
+// Parse one trial line
+inline bool parse_fault_trial(const std::string& text, FaultTrial& trial) {
+    trial.text = text;
+    trial.faults.clear();
+    for (const std::string& s : fault_campaign_detail::split(text, ',')) {
+        FaultSpec spec;
+        if (!parse_fault_spec(s, spec)) {
+            return false;
+        }
+        trial.faults.push_back(spec);
+    }
+    if (trial.faults.size() > static_cast<size_t>(NUM_FAULTS)) {
+        fprintf(stderr, "Error: Trial %s has more than %d faults\n", text.c_str(), NUM_FAULTS);
+        return false;
+    }
+    return true;
+}
+
+// Append the trials of a campaign file; a file that adds none is an error
+inline bool load_fault_trials(const std::string& path, std::vector<FaultTrial>& trials) {
+    size_t before = trials.size();
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) {
+        fprintf(stderr, "Error: Could not open %s: %s\n", path.c_str(), strerror(errno));
+        return false;
+    }
+    char buf[1024];
+    int line = 0;
+    bool ok = true;
+    while (ok && fgets(buf, sizeof(buf), f)) {
+        line++;
+        std::string text(buf);
+        size_t hash = text.find('#');
+        if (hash != std::string::npos) text.resize(hash);
+        while (!text.empty() && strchr(" \t\r\n", text.back())) text.pop_back();
+        size_t lead = text.find_first_not_of(" \t");
+        if (lead == std::string::npos) {
+            continue;
+        }
+        FaultTrial trial;
+        ok = parse_fault_trial(text.substr(lead), trial);
+        if (!ok) {
+            fprintf(stderr, "Error: %s:%d: Invalid trial\n", path.c_str(), line);
+        }
+        trials.push_back(std::move(trial));
+    }
+    fclose(f);
+    if (ok && trials.size() == before) {
+        fprintf(stderr, "Error: %s holds no trials\n", path.c_str());
+        return false;
+    }
+    return ok;
+}
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Log-Bucketed Latency Histogram
+ *
+ * HDR-style histogram of non-negative cycle counts. Values below
+ * 2 * 2^SubBucketBits are counted exactly; above that every power-of-two
+ * range is split into 2^SubBucketBits linear sub-buckets, so a reported
+ * quantile is within 1 / 2^SubBucketBits of the true value (0.8% at the
+ * default 7 bits) over the full 64-bit range.
+ *
+ * record() is O(1) (one clz, one shift, one increment) and the counts
+ * live in a fixed array, so it is safe to call on every trace record.
+ * Quantiles are computed at the end of the run by walking the array.
+ */
+
+#ifndef SENTINEL_LATENCY_HISTOGRAM_H
+#define SENTINEL_LATENCY_HISTOGRAM_H
+
+#include <cstdint>
+#include <cstring>
+
+template <unsigned SubBucketBits = 7>
+class LatencyHistogram {
+public:
+    static constexpr uint64_t SubBuckets = 1ull << SubBucketBits;
+    static constexpr size_t NumBuckets = (65 - SubBucketBits) * SubBuckets;
+
+    LatencyHistogram() {
+        clear();
+    }
+
+    void clear() {
+        memset(counts, 0, sizeof(counts));
+        total = 0;
+        min_v = 0;
+        max_v = 0;
+        sum = 0;
+    }
+
+    void record(uint64_t v) {
+        counts[index_of(v)]++;
+        if (total == 0 || v < min_v) min_v = v;
+        if (v > max_v) max_v = v;
+        sum += v;
+        total++;
+    }
+
+    // Combine another histogram into this one (e.g. per-run into overall)
+    void add(const LatencyHistogram& other) {
+        if (other.total == 0) return;
+        for (size_t i = 0; i < NumBuckets; i++) {
+            counts[i] += other.counts[i];
+        }
+        if (total == 0 || other.min_v < min_v) min_v = other.min_v;
+        if (other.max_v > max_v) max_v = other.max_v;
+        sum += other.sum;
+        total += other.total;
+    }
+
+    // Value at quantile q in [0, 1] (nearest rank). Reports the highest
+    // value equivalent to the bucket, clamped to the recorded range.
+    uint64_t quantile(double q) const {
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(q * total + 0.999999);
+        if (rank < 1) rank = 1;
+        if (rank > total) rank = total;
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < NumBuckets; i++) {
+            seen += counts[i];
+            if (seen >= rank) {
+                uint64_t v = highest_equivalent(i);
+                if (v > max_v) v = max_v;
+                if (v < min_v) v = min_v;
+                return v;
+            }
+        }
+        return max_v;
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t min() const { return min_v; }
+    uint64_t max() const { return max_v; }
+    double mean() const { return total ? double(sum) / total : 0.0; }
+
+private:
+    static size_t index_of(uint64_t v) {
+        unsigned msb = 63 - __builtin_clzll(v | 1);
+        unsigned shift = msb > SubBucketBits ? msb - SubBucketBits : 0;
+        return shift * SubBuckets + (v >> shift);
+    }
+
+    static uint64_t highest_equivalent(size_t idx) {
+        if (idx < 2 * SubBuckets) return idx;
+        unsigned shift = static_cast<unsigned>(idx / SubBuckets) - 1;
+        uint64_t mantissa = idx - shift * SubBuckets;
+        return (mantissa << shift) + ((1ull << shift) - 1);
+    }
+
+    uint64_t counts[NumBuckets];
+    uint64_t total;
+    uint64_t min_v;
+    uint64_t max_v;
+    uint64_t sum;
+};
+
+#endif
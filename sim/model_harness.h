@@ -0,0 +1,112 @@
+/*
+ * Model Harness
+ *
+ * What every testbench driver wraps around its Verilated model: an owned
+ * context, the model, the waveform capture and the phase profiler, and
+ * the two clock edges of a cycle. The model type and a waveform policy
+ * are template parameters, so the drivers share one clocking path
+ * (Vtb_sentinel_shell, Vtb_sentinel_shell_v12, Vtb_risk_gate,
+ * Vtb_tick_to_trade) and a build without waveforms carries no per-edge
+ * tracing checks:
+ *
+ *   NoWaves    Nothing is dumped; clock_edges() is two evals
+ *   DumpWaves  Both edges are dumped to waves, which the driver opens
+ *              before the first cycle
+ *
+ * --trace is a run-time flag, so a driver that supports it instantiates
+ * its testbench for both policies and picks one in main() before the
+ * model is built (with_wave_policy()).
+ */
+
+#ifndef SENTINEL_MODEL_HARNESS_H
+#define SENTINEL_MODEL_HARNESS_H
+
+#include <cstdint>
+#include <memory>
+
+#include <verilated.h>
+
+#include "phase_profiler.h"
+#include "wave_capture.h"
+
+struct NoWaves {
+    static constexpr bool enabled = false;
+};
+
+struct DumpWaves {
+    static constexpr bool enabled = true;
+};
+
+template <typename Model, typename Waves = NoWaves>
+class ModelHarness {
+public:
+    static constexpr bool tracing = Waves::enabled;
+
+    // Simulation time per clock cycle (10ns, 100MHz), split evenly
+    // between the high and low phase of clk
+    static constexpr uint64_t CYCLE_TIME = 10;
+
+    // Each testbench owns its context, so simulation time lives here rather
+    // than in a process-wide sc_time_stamp() (required for --threads models)
+    std::unique_ptr<VerilatedContext> contextp;
+    Model* dut;
+
+    // Waveforms; only opened and dumped with DumpWaves
+    WaveCapture<Model> waves;
+
+    // Where the wall time goes (PROFILE=1 builds, see phase_profiler.h)
+    PhaseProfiler profiler;
+
+    // argc/argv carry Verilator runtime plusargs (e.g. +verilator+threads+N)
+    // and must reach the context before the model is constructed
+    explicit ModelHarness(int argc = 0, char** argv = nullptr) : contextp(new VerilatedContext) {
+        if (argc > 0) {
+            contextp->commandArgs(argc, argv);
+        }
+        dut = new Model{contextp.get()};
+    }
+
+    ModelHarness(const ModelHarness&) = delete;
+    ModelHarness& operator=(const ModelHarness&) = delete;
+
+    ~ModelHarness() {
+        // Lets a threaded model join its workers before teardown
+        dut->final();
+        delete dut;
+    }
+
+    // Rising and falling edge, CYCLE_TIME of simulation time.
+    // Inputs must be stable before the call and outputs are only read
+    // after it returns; eval() is the only point where a threaded model
+    // runs its worker threads, so this stays race-free with --threads.
+    void clock_edges() {
+        dut->clk = 1;
+        eval_model();
+        if constexpr (tracing) dump_waves();
+        contextp->timeInc(CYCLE_TIME / 2);
+
+        dut->clk = 0;
+        eval_model();
+        if constexpr (tracing) dump_waves();
+        contextp->timeInc(CYCLE_TIME / 2);
+    }
+
+    void eval_model() {
+        PROFILE_PHASE(profiler, PHASE_EVAL);
+        dut->eval();
+    }
+
+    void dump_waves() {
+        PROFILE_PHASE(profiler, PHASE_WAVES);
+        waves.dump(contextp->time());
+    }
+};
+
+// Call f(NoWaves{}) or f(DumpWaves{}), so a driver can pick the
+// instantiation of its testbench from a run-time --trace flag
+template <typename F>
+auto with_wave_policy(bool trace, F&& f) {
+    return trace ? f(DumpWaves{}) : f(NoWaves{});
+}
+
+#endif
@@ -0,0 +1,161 @@
+/*
+ * Model Snapshots
+ *
+ * In-memory checkpoint of a Verilator model built with --savable
+ * (make SAVABLE=1). A testbench captures the model once it is out of
+ * reset, then restores that state instead of re-simulating the warm-up
+ * for every later test or rerun.
+ *
+ * Verilator's VerilatedSave/VerilatedRestore stream to a file; the two
+ * adapters below stream to and from a byte vector instead, so a restore
+ * costs a copy of the model state (a few KB for the shells). Top-level
+ * ports are part of that state, so inputs come back exactly as they were
+ * at capture. Simulation time is stored alongside and rewound on restore,
+ * which keeps a restored run's timestamps identical to the original.
+ *
+ * Without SENTINEL_SAVABLE, available() is false, capture() is a no-op
+ * and restore() fails, so callers fall back to simulating warm-up.
+ */
+
+#ifndef SENTINEL_MODEL_SNAPSHOT_H
+#define SENTINEL_MODEL_SNAPSHOT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <verilated.h>
+
+#ifdef SENTINEL_SAVABLE
+#include <verilated_save.h>
+
+// VerilatedSerialize that appends to a byte vector
+class SnapshotWriter : public VerilatedSerialize {
+public:
+    explicit SnapshotWriter(std::vector<uint8_t>& out) : out(out) {
+        m_isOpen = true;
+        header();
+    }
+
+    ~SnapshotWriter() override {
+        close();
+    }
+
+    void close() override {
+        if (!isOpen()) return;
+        trailer();
+        flush();
+        m_isOpen = false;
+    }
+
+    void flush() override {
+        out.insert(out.end(), m_bufp, m_cp);
+        m_cp = m_bufp;
+    }
+
+private:
+    std::vector<uint8_t>& out;
+};
+
+// VerilatedDeserialize that reads from a byte vector
+class SnapshotReader : public VerilatedDeserialize {
+public:
+    explicit SnapshotReader(const std::vector<uint8_t>& in) : in(in) {
+        m_isOpen = true;
+        header();
+    }
+
+    ~SnapshotReader() override {
+        close();
+    }
+
+    void close() override {
+        if (!isOpen()) return;
+        trailer();
+        m_isOpen = false;
+    }
+
+    void fill() override {
+        // Keep the unread tail, then top the buffer up from the snapshot
+        uint8_t* rp = m_bufp;
+        for (uint8_t* sp = m_cp; sp < m_endp; *rp++ = *sp++) {}
+        m_endp = m_bufp + (m_endp - m_cp);
+        m_cp = m_bufp;
+        size_t room = bufferSize() - static_cast<size_t>(m_endp - m_bufp);
+        size_t n = std::min(room, in.size() - pos);
+        memcpy(m_endp, in.data() + pos, n);
+        m_endp += n;
+        pos += n;
+    }
+
+private:
+    const std::vector<uint8_t>& in;
+    size_t pos = 0;
+};
+#endif
+
+template <typename Model>
+class ModelSnapshot {
+public:
+    static constexpr bool available() {
+#ifdef SENTINEL_SAVABLE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool valid() const { return captured; }
+    size_t size_bytes() const { return state.size(); }
+    uint64_t restores() const { return restore_count; }
+
+    void clear() {
+        state.clear();
+        captured = false;
+    }
+
+    // Record the model's current state (no-op without SENTINEL_SAVABLE)
+    void capture(Model& model, VerilatedContext& ctx) {
+#ifdef SENTINEL_SAVABLE
+        state.clear();
+        {
+            SnapshotWriter os(state);
+            os << model;
+        }
+        time = ctx.time();
+        captured = true;
+#else
+        (void)model;
+        (void)ctx;
+#endif
+    }
+
+    // Put the model back into the captured state; false if nothing to restore
+    bool restore(Model& model, VerilatedContext& ctx) {
+#ifdef SENTINEL_SAVABLE
+        if (!captured) {
+            return false;
+        }
+        {
+            SnapshotReader is(state);
+            is >> model;
+        }
+        ctx.time(time);
+        restore_count++;
+        return true;
+#else
+        (void)model;
+        (void)ctx;
+        return false;
+#endif
+    }
+
+private:
+    std::vector<uint8_t> state;
+    uint64_t time = 0;
+    bool captured = false;
+    uint64_t restore_count = 0;
+};
+
+#endif
@@ -0,0 +1,41 @@
+/*
+ * Risk Order Stimulus Record
+ *
+ * 48-byte packed order/fill record replayed by the risk gate driver
+ * (sim_risk.cpp --orders). Layout must match wind_tunnel/order_stimulus.py
+ * (OrderStimulus.to_binary), which converts the CSV and 24-byte stimulus
+ * formats into it.
+ *
+ * Records are in timestamp order. An order record drives the gate's order
+ * port (side and type use the risk_pkg.sv encodings); a fill record
+ * drives the fill port, using side, quantity and notional.
+ */
+
+#ifndef SENTINEL_ORDER_RECORD_H
+#define SENTINEL_ORDER_RECORD_H
+
+#include <cstdint>
+
+enum OrderRecordKind : uint8_t {
+    ORDER_RECORD_ORDER = 0,
+    ORDER_RECORD_FILL  = 1,
+};
+
+#pragma pack(push, 1)
+struct OrderRecord {
+    uint64_t timestamp_ns;  // When to present (relative to start)
+    uint64_t order_id;
+    uint64_t quantity;
+    uint64_t price;         // Fixed point, as the exchange sends it
+    uint64_t notional;      // Pre-computed quantity * price
+    uint32_t symbol_id;
+    uint8_t  kind;          // OrderRecordKind
+    uint8_t  side;          // 1 = buy, 2 = sell
+    uint8_t  order_type;    // 1 = new, 2 = cancel, 3 = modify, 15 = heartbeat
+    uint8_t  _padding;      // Align to 48 bytes
+};
+#pragma pack(pop)
+
+static_assert(sizeof(OrderRecord) == 48, "OrderRecord must be 48 bytes");
+
+#endif
@@ -0,0 +1,273 @@
+/*
+ * Testbench Phase Profiler
+ *
+ * Scoped timers that split a testbench's wall time into phases, to tell
+ * whether a slow run is spending its time in the model or in the
+ * testbench around it:
+ *
+ *   tick      One clock cycle, including its evals and waveform dumps
+ *   eval      dut->eval()
+ *   waves     Waveform dump
+ *   stimulus  Fetching the next stimulus/order and driving the inputs
+ *   collect   Sampling outputs: trace records, decisions
+ *   output    Trace sink/ring writes and test log text
+ *   golden    Golden model run in lockstep (risk gate)
+ *
+ * Times are inclusive (tick contains eval and waves), so shares do not
+ * add up to 100%.
+ *
+ * Compiled in only with -DSENTINEL_PROFILE (make PROFILE=1). Otherwise
+ * PhaseProfiler is an empty class whose members do nothing and
+ * PROFILE_PHASE expands to nothing, so the instrumented code is
+ * identical to uninstrumented code. When enabled a scope costs two
+ * rdtsc reads and two adds; the TSC rate is calibrated against
+ * steady_clock over the profiled run.
+ *
+ * Sampled timeline. With set_timeline(every, window) every phase scope
+ * in cycles [k * every, k * every + window) is also recorded as an event
+ * (up to max_events), and write_chrome_trace() writes them in Chrome
+ * trace event format, for chrome://tracing or ui.perfetto.dev. Each
+ * merged profiler (one per risk test job) gets its own track.
+ */
+
+#ifndef SENTINEL_PHASE_PROFILER_H
+#define SENTINEL_PHASE_PROFILER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+enum ProfilePhase {
+    PHASE_TICK,
+    PHASE_EVAL,
+    PHASE_WAVES,
+    PHASE_STIMULUS,
+    PHASE_COLLECT,
+    PHASE_OUTPUT,
+    PHASE_GOLDEN,
+    PHASE_COUNT
+};
+
+static constexpr const char* PHASE_NAMES[PHASE_COUNT] = {
+    "tick", "eval", "waves", "stimulus", "collect", "output", "golden",
+};
+
+#ifdef SENTINEL_PROFILE
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+inline uint64_t profile_clock() {
+    return __rdtsc();
+}
+#else
+inline uint64_t profile_clock() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+class PhaseProfiler {
+public:
+    static constexpr bool enabled = true;
+
+    PhaseProfiler() {
+        begin();
+    }
+
+    // Restart the counters and the calibration interval
+    void begin() {
+        for (int p = 0; p < PHASE_COUNT; p++) {
+            ticks[p] = 0;
+            calls[p] = 0;
+        }
+        events.clear();
+        tracks.clear();
+        tsc_start = profile_clock();
+        wall_start = std::chrono::steady_clock::now();
+    }
+
+    // Record scopes as timeline events in cycles [k * every, k * every + window)
+    void set_timeline(uint64_t every, uint64_t window, size_t max_events = 1u << 20) {
+        timeline_every = every;
+        timeline_window = window;
+        event_limit = max_events;
+        events.reserve(std::min<size_t>(max_events, 1u << 16));
+        recording = timeline_every > 0 && timeline_window > 0;
+    }
+
+    // Cycle about to be simulated, for the timeline sampling
+    void at_cycle(uint64_t cycle) {
+        current_cycle = cycle;
+        if (timeline_every > 0) {
+            recording = cycle % timeline_every < timeline_window;
+        }
+    }
+
+    void add(ProfilePhase phase, uint64_t start, uint64_t end) {
+        ticks[phase] += end - start;
+        calls[phase]++;
+        if (recording && events.size() < event_limit) {
+            events.push_back({start, end, current_cycle, static_cast<uint32_t>(phase), 0});
+        }
+    }
+
+    // Fold another profiler (e.g. one test job's) into this one; its
+    // events go on their own track named name
+    void merge(const PhaseProfiler& other, const std::string& name) {
+        for (int p = 0; p < PHASE_COUNT; p++) {
+            ticks[p] += other.ticks[p];
+            calls[p] += other.calls[p];
+        }
+        uint32_t track = static_cast<uint32_t>(tracks.size()) + 1;
+        tracks.push_back(name);
+        for (Event e : other.events) {
+            if (events.size() >= event_limit) break;
+            e.track = track;
+            events.push_back(e);
+        }
+    }
+
+    // Nanoseconds per profile_clock() tick, measured since begin()
+    double ns_per_tick() const {
+        uint64_t dt = profile_clock() - tsc_start;
+        double ns = std::chrono::duration<double, std::nano>(
+                        std::chrono::steady_clock::now() - wall_start).count();
+        return dt > 0 ? ns / dt : 1.0;
+    }
+
+    double phase_ns(int phase) const {
+        return ticks[phase] * ns_per_tick();
+    }
+
+    // "phase_profile" member for --json stats (with a trailing ", ")
+    void print_json(double wall_seconds) const {
+        double scale = ns_per_tick();
+        printf("\"phase_profile\": {");
+        const char* sep = "";
+        for (int p = 0; p < PHASE_COUNT; p++) {
+            if (calls[p] == 0) continue;
+            double ns = ticks[p] * scale;
+            printf("%s\"%s\": {\"calls\": %lu, \"ns\": %.0f, \"ns_per_call\": %.2f, "
+                   "\"share\": %.4f}", sep, PHASE_NAMES[p], (unsigned long)calls[p], ns,
+                   ns / calls[p], wall_seconds > 0 ? ns / (wall_seconds * 1e9) : 0.0);
+            sep = ", ";
+        }
+        printf("}, ");
+        printf("\"profile_events\": %zu, ", events.size());
+    }
+
+    void print_summary(double wall_seconds) const {
+        double scale = ns_per_tick();
+        printf("\n=== Phase Profile (inclusive) ===\n");
+        for (int p = 0; p < PHASE_COUNT; p++) {
+            if (calls[p] == 0) continue;
+            double ns = ticks[p] * scale;
+            printf("%-9s %12lu calls %10.3f s %8.1f ns/call %6.1f%%\n", PHASE_NAMES[p],
+                   (unsigned long)calls[p], ns / 1e9, ns / calls[p],
+                   wall_seconds > 0 ? 100.0 * ns / (wall_seconds * 1e9) : 0.0);
+        }
+        printf("=================================\n");
+    }
+
+    // Chrome trace event format; timestamps in microseconds since begin()
+    bool write_chrome_trace(const std::string& path, const char* process_name) const {
+        FILE* f = fopen(path.c_str(), "w");
+        if (!f) {
+            fprintf(stderr, "Error: Could not write %s: %s\n", path.c_str(), strerror(errno));
+            return false;
+        }
+        double us = ns_per_tick() / 1000.0;
+        fprintf(f, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+        fprintf(f, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, "
+                "\"args\": {\"name\": \"%s\"}}", process_name);
+        for (size_t i = 0; i < tracks.size(); i++) {
+            fprintf(f, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %zu, "
+                    "\"args\": {\"name\": \"%s\"}}", i + 1, tracks[i].c_str());
+        }
+        for (const Event& e : events) {
+            uint64_t start = e.start > tsc_start ? e.start - tsc_start : 0;
+            fprintf(f, ",\n{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, "
+                    "\"ts\": %.3f, \"dur\": %.3f, \"args\": {\"cycle\": %lu}}",
+                    PHASE_NAMES[e.phase], e.track, start * us, (e.end - e.start) * us,
+                    (unsigned long)e.cycle);
+        }
+        fprintf(f, "\n]}\n");
+        return fclose(f) == 0;
+    }
+
+    size_t event_count() const { return events.size(); }
+
+private:
+    struct Event {
+        uint64_t start;
+        uint64_t end;
+        uint64_t cycle;
+        uint32_t phase;
+        uint32_t track;
+    };
+
+    uint64_t ticks[PHASE_COUNT];
+    uint64_t calls[PHASE_COUNT];
+    uint64_t tsc_start = 0;
+    std::chrono::steady_clock::time_point wall_start;
+
+    uint64_t timeline_every = 0;
+    uint64_t timeline_window = 0;
+    size_t event_limit = 0;
+    bool recording = false;
+    uint64_t current_cycle = 0;
+    std::vector<Event> events;
+    std::vector<std::string> tracks;
+};
+
+class PhaseScope {
+public:
+    PhaseScope(PhaseProfiler& profiler, ProfilePhase phase)
+        : profiler(profiler), phase(phase), start(profile_clock()) {}
+
+    ~PhaseScope() {
+        profiler.add(phase, start, profile_clock());
+    }
+
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+
+private:
+    PhaseProfiler& profiler;
+    ProfilePhase phase;
+    uint64_t start;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+// Time the rest of the enclosing scope as phase
+#define PROFILE_PHASE(profiler, phase) \
+    PhaseScope PROFILE_CONCAT(profile_scope_, __LINE__)((profiler), (phase))
+
+#else
+
+class PhaseProfiler {
+public:
+    static constexpr bool enabled = false;
+
+    void begin() {}
+    void set_timeline(uint64_t, uint64_t, size_t = 0) {}
+    void at_cycle(uint64_t) {}
+    void merge(const PhaseProfiler&, const std::string&) {}
+    void print_json(double) const {}
+    void print_summary(double) const {}
+    bool write_chrome_trace(const std::string&, const char*) const { return true; }
+    size_t event_count() const { return 0; }
+};
+
+#define PROFILE_PHASE(profiler, phase) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,36 @@
+/*
+ * Process Resource Statistics
+ *
+ * Peak resident set size of the running driver, for the --json summaries
+ * (wind_tunnel/sim_bench.py). Taken from the VmHWM line of
+ * /proc/self/status: the high-water mark of this image's own address
+ * space. getrusage() and wait4() are no use here, since ru_maxrss carries
+ * over execve() and so includes whatever the launcher had mapped.
+ */
+
+#ifndef SENTINEL_PROCESS_STATS_H
+#define SENTINEL_PROCESS_STATS_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// Peak RSS in KiB, or 0 where /proc is not available
+inline uint64_t peak_rss_kb() {
+    FILE* f = fopen("/proc/self/status", "r");
+    if (!f) {
+        return 0;
+    }
+    char line[256];
+    unsigned long long kb = 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "VmHWM:", 6) == 0) {
+            sscanf(line + 6, "%llu", &kb);
+            break;
+        }
+    }
+    fclose(f);
+    return static_cast<uint64_t>(kb);
+}
+
+#endif
@@ -0,0 +1,416 @@
+/*
+ * Risk Gate Golden Model
+ *
+ * Cycle-accurate, bit-exact C++ model of rtl/risk_gate.sv and its
+ * sub-gates (rate_limiter.sv, position_limiter.sv, kill_switch.sv),
+ * including the single-entry skid buffer and every statistics counter
+ * tb_risk_gate exposes.
+ *
+ * Ports use the tb_risk_gate names, so a testbench can run the model in
+ * lockstep with the Verilator DUT:
+ *
+ *   model.load_inputs(*dut);   // before the edge
+ *   model.tick();
+ *   dut tick
+ *   model.eval();
+ *   model.compare(*dut, ...)   // first output that differs, if any
+ *
+ * The model has no Verilator dependency and also runs standalone, e.g. to
+ * fuzz limit configurations far faster than RTL simulation.
+ *
+ * Widths follow the RTL: the token bucket is 32 bits and wraps like the
+ * RTL does (a heartbeat on an empty bucket consumes), net position and
+ * net notional are 65-bit signed, and every compare uses the RTL operand
+ * widths.
+ */
+
+#ifndef SENTINEL_RISK_MODEL_H
+#define SENTINEL_RISK_MODEL_H
+
+#include <cstdint>
+
+class RiskGateModel {
+public:
+    // Reject reasons and encodings (risk_pkg.sv)
+    static constexpr uint8_t REJECT_OK            = 0x00;
+    static constexpr uint8_t REJECT_RATE_LIMITED  = 0x01;
+    static constexpr uint8_t REJECT_POSITION      = 0x02;
+    static constexpr uint8_t REJECT_NOTIONAL      = 0x03;
+    static constexpr uint8_t REJECT_ORDER_SIZE    = 0x04;
+    static constexpr uint8_t REJECT_KILL_SWITCH   = 0x05;
+    static constexpr uint8_t SIDE_BUY             = 1;
+    static constexpr uint8_t SIDE_SELL            = 2;
+    static constexpr uint8_t TYPE_NEW             = 0x1;
+    static constexpr uint8_t TYPE_CANCEL          = 0x2;
+    static constexpr uint8_t TYPE_HEARTBEAT       = 0xF;
+
+    // Inputs
+    uint8_t  rst_n = 0;
+    uint32_t cfg_rate_max_tokens = 0;
+    uint32_t cfg_rate_refill_rate = 0;
+    uint16_t cfg_rate_refill_period = 0;
+    uint8_t  cfg_rate_enabled = 0;
+    uint64_t cfg_pos_max_long = 0;
+    uint64_t cfg_pos_max_short = 0;
+    uint64_t cfg_pos_max_notional = 0;
+    uint64_t cfg_pos_max_order_qty = 0;
+    uint8_t  cfg_pos_enabled = 0;
+    uint8_t  cfg_kill_armed = 0;
+    uint8_t  cfg_kill_auto_enabled = 0;
+    uint64_t cfg_kill_loss_threshold = 0;
+    uint8_t  cmd_kill_trigger = 0;
+    uint8_t  cmd_kill_reset = 0;
+    uint8_t  in_valid = 0;
+    uint64_t in_data = 0;
+    uint64_t in_order_id = 0;
+    uint32_t in_symbol_id = 0;   // Carried with the order; no check reads it
+    uint64_t in_price = 0;       // Likewise (notional is pre-computed)
+    uint8_t  in_side = 0;        // 2 bits
+    uint8_t  in_order_type = 0;  // 4 bits
+    uint64_t in_quantity = 0;
+    uint64_t in_notional = 0;
+    uint8_t  out_ready = 0;
+    uint8_t  fill_valid = 0;
+    uint8_t  fill_side = 0;      // 2 bits
+    uint64_t fill_qty = 0;
+    uint64_t fill_notional = 0;
+    uint64_t current_pnl = 0;    // Reinterpreted as signed, like the tb
+
+    // Outputs (valid after eval() or tick())
+    uint8_t  in_ready = 0;
+    uint8_t  out_valid = 0;
+    uint64_t out_data = 0;
+    uint64_t out_order_id = 0;
+    uint8_t  out_rejected = 0;
+    uint8_t  out_reject_reason = 0;
+    uint8_t  status_passed = 0;
+    uint32_t status_tokens = 0;
+    uint64_t status_position = 0;
+    uint64_t status_notional = 0;
+    uint8_t  kill_switch_active = 0;
+    uint64_t stat_total = 0;
+    uint64_t stat_passed = 0;
+    uint64_t stat_rejected_rate = 0;
+    uint64_t stat_rejected_pos = 0;
+    uint64_t stat_rejected_kill = 0;
+
+    RiskGateModel() {
+        reset_state();
+        eval();
+    }
+
+    // Settle combinational outputs for the current inputs and state
+    void eval() {
+        decide();
+        update_outputs();
+    }
+
+    // One rising clock edge. Outputs are updated except status_passed,
+    // which still holds the decision taken before the edge; call eval() to
+    // settle it (the lockstep check does)
+    void tick() {
+        decide();
+        if (!rst_n) {
+            update_outputs();
+            return;
+        }
+        in_ready = !buf_valid || out_ready;
+
+        bool accept = in_valid && in_ready;
+
+        // rate_limiter: refill counter and bucket
+        bool period_ok = cfg_rate_refill_period != 0;
+        bool enable_edge = cfg_rate_enabled && !rate_enabled_d;
+        bool do_refill = cfg_rate_enabled && period_ok && refill_counter == 0 &&
+                         cfg_rate_refill_rate > 0;
+        bool consume = accept && rate_passed && cfg_rate_enabled && period_ok;
+        uint64_t plus_refill = static_cast<uint64_t>(bucket) + cfg_rate_refill_rate;
+        bool caps_out = plus_refill > cfg_rate_max_tokens;
+
+        uint16_t next_counter;
+        if (enable_edge) {
+            next_counter = period_ok ? cfg_rate_refill_period : 1;
+        } else if (!cfg_rate_enabled || !period_ok) {
+            next_counter = 1;
+        } else if (refill_counter == 0) {
+            next_counter = cfg_rate_refill_period;
+        } else {
+            next_counter = refill_counter - 1;
+        }
+
+        uint32_t next_bucket = bucket;
+        if (enable_edge) {
+            next_bucket = cfg_rate_max_tokens;
+        } else if (cfg_rate_enabled && period_ok) {
+            if (consume && do_refill) {
+                next_bucket = caps_out ? cfg_rate_max_tokens - 1
+                                       : static_cast<uint32_t>(plus_refill) - 1;
+            } else if (consume) {
+                next_bucket = bucket - 1;
+            } else if (do_refill) {
+                next_bucket = caps_out ? cfg_rate_max_tokens : static_cast<uint32_t>(plus_refill);
+            }
+        }
+        if (accept && !rate_passed) {
+            stat_rejected_rate++;
+        }
+
+        // position_limiter: fills and (ungated) stats
+        if (fill_valid) {
+            if (fill_side == SIDE_BUY) {
+                net_position = wrap65(net_position + fill_qty);
+                net_notional = wrap65(net_notional + fill_notional);
+            } else if (fill_side == SIDE_SELL) {
+                net_position = wrap65(net_position - fill_qty);
+                net_notional = wrap65(net_notional - fill_notional);
+            }
+        }
+        if (in_valid && rate_passed && !pos_passed) {
+            pos_total_rejected++;
+        }
+
+        // kill_switch
+        __int128 pnl = static_cast<int64_t>(current_pnl);
+        bool auto_trigger = cfg_kill_auto_enabled &&
+                            pnl <= -static_cast<__int128>(cfg_kill_loss_threshold);
+        if (accept && trigger_latched) {
+            stat_rejected_kill++;
+        }
+        if (cmd_kill_reset) {
+            kill_active = false;
+            trigger_latched = false;
+        } else if ((cmd_kill_trigger || auto_trigger) && cfg_kill_armed && !trigger_latched) {
+            kill_active = true;
+            trigger_latched = true;
+        }
+
+        // Skid buffer and gate statistics
+        if (out_ready && buf_valid) {
+            buf_valid = false;
+        }
+        if (accept) {
+            buf_valid = true;
+            buf_passed = all_passed;
+            buf_reject = first_reject;
+            buf_order_id = in_order_id;
+            buf_data = in_data;
+            stat_total++;
+            if (all_passed) stat_passed++;
+        }
+
+        refill_counter = next_counter;
+        bucket = next_bucket;
+        rate_enabled_d = cfg_rate_enabled;
+
+        update_outputs();
+    }
+
+    // Copy every input port from a tb_risk_gate model
+    template <typename Dut>
+    void load_inputs(const Dut& d) {
+        rst_n = d.rst_n & 1;
+        cfg_rate_max_tokens = d.cfg_rate_max_tokens;
+        cfg_rate_refill_rate = d.cfg_rate_refill_rate;
+        cfg_rate_refill_period = d.cfg_rate_refill_period;
+        cfg_rate_enabled = d.cfg_rate_enabled & 1;
+        cfg_pos_max_long = d.cfg_pos_max_long;
+        cfg_pos_max_short = d.cfg_pos_max_short;
+        cfg_pos_max_notional = d.cfg_pos_max_notional;
+        cfg_pos_max_order_qty = d.cfg_pos_max_order_qty;
+        cfg_pos_enabled = d.cfg_pos_enabled & 1;
+        cfg_kill_armed = d.cfg_kill_armed & 1;
+        cfg_kill_auto_enabled = d.cfg_kill_auto_enabled & 1;
+        cfg_kill_loss_threshold = d.cfg_kill_loss_threshold;
+        cmd_kill_trigger = d.cmd_kill_trigger & 1;
+        cmd_kill_reset = d.cmd_kill_reset & 1;
+        in_valid = d.in_valid & 1;
+        in_data = d.in_data;
+        in_order_id = d.in_order_id;
+        in_symbol_id = d.in_symbol_id;
+        in_price = d.in_price;
+        in_side = d.in_side & 0x3;
+        in_order_type = d.in_order_type & 0xF;
+        in_quantity = d.in_quantity;
+        in_notional = d.in_notional;
+        out_ready = d.out_ready & 1;
+        fill_valid = d.fill_valid & 1;
+        fill_side = d.fill_side & 0x3;
+        fill_qty = d.fill_qty;
+        fill_notional = d.fill_notional;
+        current_pnl = d.current_pnl;
+    }
+
+    // Compare every output port against a tb_risk_gate model. Returns the
+    // name of the first mismatching port (nullptr if all match) and its
+    // two values.
+    template <typename Dut>
+    const char* compare(const Dut& d, uint64_t& dut_value, uint64_t& model_value) const {
+#define RISK_MODEL_CHECK(port)                            \
+        if (static_cast<uint64_t>(d.port) != static_cast<uint64_t>(port)) { \
+            dut_value = d.port;                           \
+            model_value = port;                           \
+            return #port;                                 \
+        }
+        RISK_MODEL_CHECK(in_ready)
+        RISK_MODEL_CHECK(out_valid)
+        RISK_MODEL_CHECK(out_data)
+        RISK_MODEL_CHECK(out_order_id)
+        RISK_MODEL_CHECK(out_rejected)
+        RISK_MODEL_CHECK(out_reject_reason)
+        RISK_MODEL_CHECK(status_passed)
+        RISK_MODEL_CHECK(status_tokens)
+        RISK_MODEL_CHECK(status_position)
+        RISK_MODEL_CHECK(status_notional)
+        RISK_MODEL_CHECK(kill_switch_active)
+        RISK_MODEL_CHECK(stat_total)
+        RISK_MODEL_CHECK(stat_passed)
+        RISK_MODEL_CHECK(stat_rejected_rate)
+        RISK_MODEL_CHECK(stat_rejected_pos)
+        RISK_MODEL_CHECK(stat_rejected_kill)
+#undef RISK_MODEL_CHECK
+        return nullptr;
+    }
+
+private:
+    // Register state
+    uint32_t bucket;
+    uint16_t refill_counter;
+    bool rate_enabled_d;
+    __int128 net_position;  // 65-bit signed
+    __int128 net_notional;  // 65-bit signed
+    uint64_t pos_total_rejected;
+    bool kill_active;
+    bool trigger_latched;
+    bool buf_valid;
+    bool buf_passed;
+    uint8_t buf_reject;
+    uint64_t buf_order_id;
+    uint64_t buf_data;
+
+    // Combinational values shared by eval() and tick()
+    bool rate_passed = true;
+    bool pos_passed = true;
+    bool all_passed = true;
+    uint8_t first_reject = REJECT_OK;
+
+    // Position projection of the current order (64-bit views of the
+    // 65-bit values), kept for RiskSweep
+    bool order_qty_ok = true;
+    uint64_t projected_long = 0;
+    uint64_t projected_short = 0;
+    uint64_t projected_notional = 0;  // Magnitude, valid when notional_fits
+    bool notional_fits = true;
+
+    friend class RiskSweep;
+
+    // Combinational decision on the current inputs and state
+    void decide() {
+        if (!rst_n) {
+            reset_state();  // Asynchronous, active-low
+        }
+
+        // rate_limiter
+        bool period_ok = cfg_rate_refill_period != 0;
+        rate_passed = !cfg_rate_enabled ? true
+                    : !period_ok        ? false
+                    : in_order_type == TYPE_HEARTBEAT ? true
+                    : bucket >= 1;
+
+        // position_limiter: projection if this order were to fill
+        __int128 projected_net = net_position;
+        __int128 projected_signed = net_notional;
+        if (in_order_type == TYPE_NEW) {
+            if (in_side == SIDE_BUY) {
+                projected_net = wrap65(net_position + in_quantity);
+                projected_signed = wrap65(net_notional + in_notional);
+            } else if (in_side == SIDE_SELL) {
+                projected_net = wrap65(net_position - in_quantity);
+                projected_signed = wrap65(net_notional - in_notional);
+            }
+        }
+        __int128 projected_abs = projected_signed < 0 ? wrap65(-projected_signed)
+                                                      : projected_signed;
+        projected_long = projected_net > 0 ? static_cast<uint64_t>(projected_net) : 0;
+        projected_short = projected_net < 0 ? static_cast<uint64_t>(-projected_net) : 0;
+        projected_notional = static_cast<uint64_t>(projected_abs);
+        notional_fits = !bit64(projected_abs);
+
+        order_qty_ok = in_quantity <= cfg_pos_max_order_qty;
+        bool long_ok = projected_long <= cfg_pos_max_long;
+        bool short_ok = projected_short <= cfg_pos_max_short;
+        bool notional_ok = notional_fits && projected_notional <= cfg_pos_max_notional;
+        pos_passed = !cfg_pos_enabled || in_order_type == TYPE_CANCEL ||
+                     (order_qty_ok && long_ok && short_ok && notional_ok);
+        uint8_t pos_reject = (!cfg_pos_enabled || pos_passed) ? REJECT_OK
+                           : !order_qty_ok                   ? REJECT_ORDER_SIZE
+                           : (!long_ok || !short_ok)         ? REJECT_POSITION
+                           :                                   REJECT_NOTIONAL;
+
+        // kill_switch
+        bool kill_passed = !trigger_latched;
+
+        // risk_gate
+        all_passed = rate_passed && pos_passed && kill_passed;
+        first_reject = !kill_passed ? REJECT_KILL_SWITCH
+                     : !rate_passed ? REJECT_RATE_LIMITED
+                     : !pos_passed  ? pos_reject
+                     :                REJECT_OK;
+    }
+
+    // Output ports that are views of state (plus in_ready/status_passed)
+    void update_outputs() {
+        in_ready = !buf_valid || out_ready;
+
+        out_valid = buf_valid;
+        out_data = buf_data;
+        out_order_id = buf_order_id;
+        out_rejected = !buf_passed;
+        out_reject_reason = buf_reject;
+
+        uint64_t long_view = net_position > 0 ? static_cast<uint64_t>(net_position) : 0;
+        uint64_t short_view = net_position < 0 ? static_cast<uint64_t>(-net_position) : 0;
+        __int128 abs_notional = net_notional < 0 ? wrap65(-net_notional) : net_notional;
+        status_passed = all_passed;
+        status_tokens = bucket;
+        status_position = long_view - short_view;
+        status_notional = bit64(abs_notional) ? UINT64_MAX : static_cast<uint64_t>(abs_notional);
+        kill_switch_active = kill_active;
+        stat_rejected_pos = pos_total_rejected;
+    }
+
+    void reset_state() {
+        bucket = 0;
+        refill_counter = 1;
+        rate_enabled_d = false;
+        net_position = 0;
+        net_notional = 0;
+        pos_total_rejected = 0;
+        kill_active = false;
+        trigger_latched = false;
+        buf_valid = false;
+        buf_passed = false;
+        buf_reject = REJECT_OK;
+        buf_order_id = 0;
+        buf_data = 0;
+        stat_total = 0;
+        stat_passed = 0;
+        stat_rejected_rate = 0;
+        stat_rejected_kill = 0;
+    }
+
+    // Truncate to 65 bits and sign-extend, as a logic signed [64:0] would
+    static __int128 wrap65(__int128 v) {
+        const unsigned __int128 mask = (static_cast<unsigned __int128>(1) << 65) - 1;
+        unsigned __int128 u = static_cast<unsigned __int128>(v) & mask;
+        if (u >> 64) {
+            u |= ~mask;
+        }
+        return static_cast<__int128>(u);
+    }
+
+    static bool bit64(__int128 v) {
+        return (static_cast<unsigned __int128>(v) >> 64) & 1;
+    }
+};
+
+#endif
@@ -0,0 +1,425 @@
+/*
+ * Risk Limit Config Sweep
+ *
+ * Runs one recorded order stream against many risk limit configurations
+ * at once and histograms every decision's reject reason per config.
+ *
+ * The swept limits (token bucket size and refill, position and notional
+ * caps) only change which orders pass. They do not change the skid
+ * buffer's occupancy, the position (driven by fills), the kill switch
+ * or the refill timer. So a single scalar pass of the golden model
+ * (risk_model.h) precomputes those shared values per cycle. Each config
+ * then only needs its token bucket and limit compares. Configs run in
+ * blocks of LANES, one config per lane. The per-lane loop is branch-free
+ * selects over fixed-size arrays, which the compiler vectorizes (wider
+ * with -march=native).
+ *
+ *   RiskSweep sweep(base, stream);          // shared pass (RiskCycleVector or
+ *                                           // any source with rewind/next)
+ *   sweep.run(limits, results, count);      // any number of configs
+ *
+ * risk_base_config() and parse_sweep() give the drivers one base config
+ * and one "name=lo[:hi:step],..." syntax for --sweep and --limits.
+ *
+ * Every cfg_* that is not swept comes from the base model. Decisions are
+ * counted when an order is accepted, exactly as the gate records them.
+ */
+
+#ifndef SENTINEL_RISK_SWEEP_H
+#define SENTINEL_RISK_SWEEP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "risk_model.h"
+
+// Inputs of one clock cycle of an order stream (out of reset)
+struct RiskCycleInputs {
+    uint8_t  in_valid = 0;
+    uint8_t  in_side = 0;
+    uint8_t  in_order_type = 0;
+    uint8_t  out_ready = 1;
+    uint8_t  fill_valid = 0;
+    uint8_t  fill_side = 0;
+    uint8_t  cmd_kill_trigger = 0;
+    uint8_t  cmd_kill_reset = 0;
+    uint64_t in_order_id = 0;
+    uint64_t in_data = 0;
+    uint32_t in_symbol_id = 1;
+    uint64_t in_quantity = 0;
+    uint64_t in_price = 100;
+    uint64_t in_notional = 0;
+    uint64_t fill_qty = 0;
+    uint64_t fill_notional = 0;
+    uint64_t current_pnl = 0;
+
+    // Drive these inputs onto a tb_risk_gate DUT or a RiskGateModel
+    template <typename Ports>
+    void apply(Ports& p) const {
+        p.in_valid = in_valid;
+        p.in_side = in_side;
+        p.in_order_type = in_order_type;
+        p.out_ready = out_ready;
+        p.fill_valid = fill_valid;
+        p.fill_side = fill_side;
+        p.cmd_kill_trigger = cmd_kill_trigger;
+        p.cmd_kill_reset = cmd_kill_reset;
+        p.in_order_id = in_order_id;
+        p.in_data = in_data;
+        p.in_symbol_id = in_symbol_id;
+        p.in_quantity = in_quantity;
+        p.in_price = in_price;
+        p.in_notional = in_notional;
+        p.fill_qty = fill_qty;
+        p.fill_notional = fill_notional;
+        p.current_pnl = current_pnl;
+    }
+};
+
+// Stream source over an in-memory vector. Any type with the same two
+// members can feed RiskSweep and RiskGateTestbench::replay_stream, e.g. a
+// cursor over a recorded order file
+class RiskCycleVector {
+public:
+    explicit RiskCycleVector(const std::vector<RiskCycleInputs>& cycles) : cycles(cycles) {}
+
+    void rewind() { pos = 0; }
+
+    bool next(RiskCycleInputs& c) {
+        if (pos == cycles.size()) return false;
+        c = cycles[pos++];
+        return true;
+    }
+
+private:
+    const std::vector<RiskCycleInputs>& cycles;
+    size_t pos = 0;
+};
+
+// The swept limits of one configuration
+struct RiskSweepLimits {
+    uint32_t rate_max_tokens = 0;
+    uint32_t rate_refill_rate = 0;
+    uint64_t pos_max_long = 0;
+    uint64_t pos_max_short = 0;
+    uint64_t pos_max_notional = 0;
+
+    // The base model's own limits
+    static RiskSweepLimits of(const RiskGateModel& base) {
+        RiskSweepLimits l;
+        l.rate_max_tokens = base.cfg_rate_max_tokens;
+        l.rate_refill_rate = base.cfg_rate_refill_rate;
+        l.pos_max_long = base.cfg_pos_max_long;
+        l.pos_max_short = base.cfg_pos_max_short;
+        l.pos_max_notional = base.cfg_pos_max_notional;
+        return l;
+    }
+
+    // Drive the base model's config with these limits substituted
+    template <typename Ports>
+    void apply(Ports& p, const RiskGateModel& base) const {
+        p.cfg_rate_enabled = base.cfg_rate_enabled;
+        p.cfg_rate_max_tokens = rate_max_tokens;
+        p.cfg_rate_refill_rate = rate_refill_rate;
+        p.cfg_rate_refill_period = base.cfg_rate_refill_period;
+        p.cfg_pos_enabled = base.cfg_pos_enabled;
+        p.cfg_pos_max_long = pos_max_long;
+        p.cfg_pos_max_short = pos_max_short;
+        p.cfg_pos_max_notional = pos_max_notional;
+        p.cfg_pos_max_order_qty = base.cfg_pos_max_order_qty;
+        p.cfg_kill_armed = base.cfg_kill_armed;
+        p.cfg_kill_auto_enabled = base.cfg_kill_auto_enabled;
+        p.cfg_kill_loss_threshold = base.cfg_kill_loss_threshold;
+    }
+};
+
+// Decisions of one configuration, by reject reason (index = reason code)
+struct RiskSweepResult {
+    static constexpr int NUM_REASONS = RiskGateModel::REJECT_KILL_SWITCH + 1;
+    uint64_t reasons[NUM_REASONS] = {};
+
+    uint64_t decisions() const {
+        uint64_t n = 0;
+        for (uint64_t r : reasons) n += r;
+        return n;
+    }
+
+    bool operator==(const RiskSweepResult& o) const {
+        for (int r = 0; r < NUM_REASONS; r++) {
+            if (reasons[r] != o.reasons[r]) return false;
+        }
+        return true;
+    }
+};
+
+class RiskSweep {
+public:
+    static constexpr size_t LANES = 16;
+
+    // Shared pass: reset a copy of base and run the stream through it
+    template <typename Source>
+    RiskSweep(const RiskGateModel& base, Source& stream) {
+        RiskGateModel m = base;
+        m.rst_n = 0;
+        m.tick();
+        m.rst_n = 1;
+
+        bool period_ok = base.cfg_rate_refill_period != 0;
+        rate_active = base.cfg_rate_enabled && period_ok;
+
+        stream.rewind();
+        RiskCycleInputs c;
+        while (stream.next(c)) {
+            c.apply(m);
+            m.decide();
+
+            bool accept = m.in_valid && (!m.buf_valid || m.out_ready);
+            bool heartbeat = m.in_order_type == RiskGateModel::TYPE_HEARTBEAT;
+            uint8_t f = 0;
+            if (accept) f |= ACCEPT;
+            if (!m.cfg_rate_enabled || (period_ok && heartbeat)) f |= RATE_FREE;
+            if (m.cfg_rate_enabled && !m.rate_enabled_d) f |= ENABLE_EDGE;
+            if (rate_active && m.refill_counter == 0) f |= REFILL_DUE;
+            if (!m.cfg_pos_enabled || m.in_order_type == RiskGateModel::TYPE_CANCEL) f |= POS_FREE;
+            if (m.order_qty_ok) f |= QTY_OK;
+            if (m.notional_fits) f |= NOTIONAL_FITS;
+            if (m.trigger_latched) f |= KILL;
+
+            flags.push_back(f);
+            projected_long.push_back(m.projected_long);
+            projected_short.push_back(m.projected_short);
+            projected_notional.push_back(m.projected_notional);
+            if (accept) accepted++;
+
+            m.tick();
+        }
+    }
+
+    size_t cycles() const { return flags.size(); }
+    uint64_t decisions() const { return accepted; }
+
+    // Evaluate count configs; safe to call concurrently on disjoint ranges
+    void run(const RiskSweepLimits* limits, RiskSweepResult* results, size_t count) const {
+        for (size_t first = 0; first < count; first += LANES) {
+            size_t n = count - first < LANES ? count - first : LANES;
+            run_block(limits + first, results + first, n);
+        }
+    }
+
+private:
+    enum : uint8_t {
+        ACCEPT        = 1 << 0,  // Order accepted this cycle (a decision)
+        RATE_FREE     = 1 << 1,  // Rate check passes without a token
+        ENABLE_EDGE   = 1 << 2,  // Rate limiter just enabled: bucket fills
+        REFILL_DUE    = 1 << 3,  // Refill timer expired
+        POS_FREE      = 1 << 4,  // Position check bypassed
+        QTY_OK        = 1 << 5,  // Order size within cfg_pos_max_order_qty
+        NOTIONAL_FITS = 1 << 6,  // Projected notional below 2^64
+        KILL          = 1 << 7,  // Kill switch latched
+    };
+
+    std::vector<uint8_t> flags;
+    std::vector<uint64_t> projected_long;
+    std::vector<uint64_t> projected_short;
+    std::vector<uint64_t> projected_notional;
+    bool rate_active = false;
+    uint64_t accepted = 0;
+
+    // One config per lane; n <= LANES, unused lanes repeat the last config.
+    // Lane state is all 64-bit and every condition a 0/1 value, so the lane
+    // loop is straight-line selects the compiler can vectorize
+    void run_block(const RiskSweepLimits* limits, RiskSweepResult* results, size_t n) const {
+        uint64_t max_tokens[LANES];
+        uint64_t refill_rate[LANES];
+        uint64_t max_long[LANES];
+        uint64_t max_short[LANES];
+        uint64_t max_notional[LANES];
+        uint64_t bucket[LANES];  // 32-bit bucket, wraps like the RTL
+        uint64_t rate_rejects[LANES];
+        uint64_t position_rejects[LANES];
+        uint64_t notional_rejects[LANES];
+        uint64_t size_rejects[LANES];
+        for (size_t l = 0; l < LANES; l++) {
+            const RiskSweepLimits& lim = limits[l < n ? l : n - 1];
+            max_tokens[l] = lim.rate_max_tokens;
+            refill_rate[l] = lim.rate_refill_rate;
+            max_long[l] = lim.pos_max_long;
+            max_short[l] = lim.pos_max_short;
+            max_notional[l] = lim.pos_max_notional;
+            bucket[l] = 0;
+            rate_rejects[l] = 0;
+            position_rejects[l] = 0;
+            notional_rejects[l] = 0;
+            size_rejects[l] = 0;
+        }
+        uint64_t kill_rejects = 0;
+
+        const uint64_t active = rate_active;
+        for (size_t c = 0; c < flags.size(); c++) {
+            const uint8_t f = flags[c];
+            const uint64_t accept = f & ACCEPT ? 1 : 0;
+            const uint64_t rate_free = f & RATE_FREE ? 1 : 0;
+            const uint64_t edge_mask = f & ENABLE_EDGE ? ~0ull : 0;
+            const uint64_t refill_due = f & REFILL_DUE ? 1 : 0;
+            const uint64_t pos_free = f & POS_FREE ? 1 : 0;
+            const uint64_t qty_ok = f & QTY_OK ? 1 : 0;
+            const uint64_t fits = f & NOTIONAL_FITS ? 1 : 0;
+            const uint64_t kill = f & KILL ? 1 : 0;
+            const uint64_t plong = projected_long[c];
+            const uint64_t pshort = projected_short[c];
+            const uint64_t pnotional = projected_notional[c];
+            const uint64_t counted = accept & (kill ^ 1);
+            const uint64_t size_ok = pos_free | qty_ok;
+            kill_rejects += accept & kill;
+
+            for (size_t l = 0; l < LANES; l++) {
+                // rate_limiter decision and bucket update (RiskGateModel::tick)
+                uint64_t b = bucket[l];
+                uint64_t rate_ok = rate_free | (active & (b != 0));
+                uint64_t consume = accept & rate_ok & active;
+                uint64_t refill = refill_due & (refill_rate[l] != 0);
+                uint64_t plus = b + refill_rate[l];
+                uint64_t capped = plus > max_tokens[l] ? max_tokens[l] : plus;
+                uint64_t next = b + ((capped - b) & (0 - refill));
+                next = (next - consume) & 0xFFFFFFFFu;
+                bucket[l] = next + ((max_tokens[l] - next) & edge_mask);
+
+                // position_limiter decision
+                uint64_t limits_ok = (plong <= max_long[l]) & (pshort <= max_short[l]);
+                uint64_t notional_ok = fits & (pnotional <= max_notional[l]);
+                uint64_t pos_ok = pos_free | (qty_ok & limits_ok & notional_ok);
+
+                // Reason priority: kill > rate > order size > position > notional
+                uint64_t pos_reject = counted & rate_ok & (pos_ok ^ 1);
+                rate_rejects[l] += counted & (rate_ok ^ 1);
+                size_rejects[l] += pos_reject & (size_ok ^ 1);
+                position_rejects[l] += pos_reject & size_ok & (limits_ok ^ 1);
+                notional_rejects[l] += pos_reject & size_ok & limits_ok;
+            }
+        }
+
+        for (size_t l = 0; l < n; l++) {
+            RiskSweepResult& r = results[l];
+            r.reasons[RiskGateModel::REJECT_RATE_LIMITED] = rate_rejects[l];
+            r.reasons[RiskGateModel::REJECT_POSITION] = position_rejects[l];
+            r.reasons[RiskGateModel::REJECT_NOTIONAL] = notional_rejects[l];
+            r.reasons[RiskGateModel::REJECT_ORDER_SIZE] = size_rejects[l];
+            r.reasons[RiskGateModel::REJECT_KILL_SWITCH] = kill_rejects;
+            r.reasons[RiskGateModel::REJECT_OK] =
+                accepted - kill_rejects - rate_rejects[l] - position_rejects[l] -
+                notional_rejects[l] - size_rejects[l];
+        }
+    }
+};
+
+// Limits of --orders replays, of every sweep config and of the
+// tick-to-trade co-simulation; --limits and the sweep grid override the
+// swept ones
+inline RiskGateModel risk_base_config() {
+    RiskGateModel base;
+    base.cfg_rate_enabled = 1;
+    base.cfg_rate_max_tokens = 200;
+    base.cfg_rate_refill_rate = 10;
+    base.cfg_rate_refill_period = 20;
+    base.cfg_pos_enabled = 1;
+    base.cfg_pos_max_long = 20000;
+    base.cfg_pos_max_short = 20000;
+    base.cfg_pos_max_notional = 2000000;
+    base.cfg_pos_max_order_qty = 1000;
+    base.cfg_kill_armed = 1;
+    return base;
+}
+
+// Expand "name=lo[:hi:step],..." into the cartesian product of the listed
+// values; parameters not listed keep the base value
+inline bool parse_sweep(const std::string& spec, const RiskGateModel& base,
+                       std::vector<RiskSweepLimits>& grid) {
+    static const char* const names[] = {
+        "rate_max_tokens", "rate_refill_rate", "pos_max_long", "pos_max_short",
+        "pos_max_notional",
+    };
+    const int num_params = 5;
+    std::vector<uint64_t> values[num_params] = {
+        {base.cfg_rate_max_tokens}, {base.cfg_rate_refill_rate}, {base.cfg_pos_max_long},
+        {base.cfg_pos_max_short}, {base.cfg_pos_max_notional},
+    };
+
+    size_t start = 0;
+    while (start < spec.size()) {
+        size_t end = spec.find(',', start);
+        if (end == std::string::npos) end = spec.size();
+        std::string item = spec.substr(start, end - start);
+        start = end + 1;
+
+        size_t eq = item.find('=');
+        int param = -1;
+        for (int p = 0; p < num_params && eq != std::string::npos; p++) {
+            if (item.compare(0, eq, names[p]) == 0 && strlen(names[p]) == eq) param = p;
+        }
+        if (param < 0) {
+            fprintf(stderr, "Error: Unknown sweep parameter in '%s'\n", item.c_str());
+            return false;
+        }
+
+        const char* p = item.c_str() + eq + 1;
+        char* rest = nullptr;
+        uint64_t lo = strtoull(p, &rest, 0);
+        uint64_t hi = lo;
+        uint64_t step = 1;
+        if (*rest == ':') {
+            hi = strtoull(rest + 1, &rest, 0);
+            if (*rest != ':') {
+                fprintf(stderr, "Error: Sweep range '%s' needs lo:hi:step\n", item.c_str());
+                return false;
+            }
+            step = strtoull(rest + 1, &rest, 0);
+        }
+        uint64_t limit = param < 2 ? UINT32_MAX : UINT64_MAX;
+        if (*rest != '\0' || rest == p || step == 0 || hi < lo || hi > limit) {
+            fprintf(stderr, "Error: Invalid sweep range '%s'\n", item.c_str());
+            return false;
+        }
+        if ((hi - lo) / step >= (1u << 20)) {
+            fprintf(stderr, "Error: Sweep range '%s' has too many values\n", item.c_str());
+            return false;
+        }
+        values[param].clear();
+        for (uint64_t v = lo; ; v += step) {
+            values[param].push_back(v);
+            if (hi - v < step) break;
+        }
+    }
+
+    size_t total = 1;
+    for (const std::vector<uint64_t>& v : values) {
+        total *= v.size();
+        if (total > (1u << 20)) {
+            fprintf(stderr, "Error: Sweep grid exceeds %u configs\n", 1u << 20);
+            return false;
+        }
+    }
+
+    // Last parameter varies fastest
+    grid.resize(total);
+    for (size_t i = 0; i < total; i++) {
+        size_t k = i;
+        uint64_t v[num_params];
+        for (int p = num_params - 1; p >= 0; p--) {
+            v[p] = values[p][k % values[p].size()];
+            k /= values[p].size();
+        }
+        grid[i].rate_max_tokens = static_cast<uint32_t>(v[0]);
+        grid[i].rate_refill_rate = static_cast<uint32_t>(v[1]);
+        grid[i].pos_max_long = v[2];
+        grid[i].pos_max_short = v[3];
+        grid[i].pos_max_notional = v[4];
+    }
+    return true;
+}
+
+#endif
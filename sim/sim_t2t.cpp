@@ -0,0 +1,844 @@
+/*
+ * Tick-to-Trade Co-Simulation Driver
+ *
+ * Drives tb_tick_to_trade.sv, the shell, stub core and risk gate in one
+ * model, with a single order stream: a recorded order/fill file
+ * (--orders, order_record.h, written by wind_tunnel/order_stimulus.py)
+ * or a generated one whose arrivals follow --load (arrival_process.h).
+ *
+ * Orders arrive open loop: each is due at the cycle its timestamp falls
+ * in and waits, in order, until the shell accepts it, so back-pressure
+ * from the gate or the egress consumer (--out-pattern, stall_pattern.h)
+ * shows up as queueing instead of slowing the stream. Fills go straight
+ * to the gate's fill port, one per cycle.
+ *
+ * Every order's tick-to-trade latency is split at its handshakes:
+ *
+ *   queue   due -> shell ingress      Waiting for the shell to accept
+ *   shell   ingress -> shell egress   Shell and strategy core (the part
+ *                                     the shell's trace records time)
+ *   risk    shell egress -> decision  Risk gate, including any stall of
+ *                                     the decided order at the egress
+ *   total   due -> decision
+ *
+ * The shell's trace records are checked against the shell component, so
+ * the two clocks cannot drift apart unnoticed.
+ *
+ * --faults runs a fault-injection campaign instead: a fault-free baseline
+ * and then one trial per line of a campaign file (fault_campaign.h), each
+ * arming the testbench's fault_injector and replaying the same stream.
+ * Trials share no state and run on --jobs worker threads, each starting
+ * from the post-reset state (restored from a snapshot in SAVABLE=1
+ * builds). Every trial becomes one row of a table (--campaign-out, CSV):
+ * trace drops, inflight underflows, decisions out of sequence, kill
+ * switch trips and the change in tick-to-trade latency from the baseline.
+ * A trial is "hung" if it stops making progress for --drain-limit cycles.
+ *
+ * Build: make t2t
+ * Run:   ./obj_dir/Vtb_tick_to_trade --orders orders.bin --max-gap 100 --json
+ *        ./obj_dir/Vtb_tick_to_trade --num-orders 100000 --load poisson:80
+ *        ./obj_dir/Vtb_tick_to_trade --num-orders 20000 --faults fault_campaign.txt
+ */
+
+#include <verilated.h>
+#include "Vtb_tick_to_trade.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arrival_process.h"
+#include "fault_campaign.h"
+#include "latency_histogram.h"
+#include "mapped_records.h"
+#include "model_harness.h"
+#include "model_snapshot.h"
+#include "order_record.h"
+#include "phase_profiler.h"
+#include "process_stats.h"
+#include "risk_sweep.h"
+#include "stall_pattern.h"
+#include "wave_capture.h"
+
+// Build parameters, reported with the results
+#ifndef SENTINEL_CORE_LATENCY
+#define SENTINEL_CORE_LATENCY 1
+#endif
+#ifndef SENTINEL_TRACE_FIFO_DEPTH
+#define SENTINEL_TRACE_FIFO_DEPTH 64
+#endif
+#ifndef SENTINEL_INFLIGHT_DEPTH
+#define SENTINEL_INFLIGHT_DEPTH 16
+#endif
+
+// Order word layout (tb_tick_to_trade.sv)
+static constexpr int ORDER_PRICE_BITS = 21;
+static constexpr int ORDER_QTY_BITS = 21;
+static constexpr int ORDER_SYMBOL_BITS = 16;
+
+static bool order_fits(const OrderRecord& r) {
+    return r.price < (1ull << ORDER_PRICE_BITS) && r.quantity < (1ull << ORDER_QTY_BITS) &&
+           r.symbol_id < (1u << ORDER_SYMBOL_BITS) && r.side < 4 && r.order_type < 16;
+}
+
+static uint64_t pack_order(const OrderRecord& r) {
+    return static_cast<uint64_t>(r.side) << 62 |
+           static_cast<uint64_t>(r.order_type) << 58 |
+           static_cast<uint64_t>(r.symbol_id) << 42 |
+           r.quantity << ORDER_PRICE_BITS |
+           r.price;
+}
+
+struct T2TOptions {
+    std::string orders_path;     // Recorded stream; empty = generated
+    uint64_t num_orders = 10000;
+    std::string load = "poisson:50";
+    uint32_t seed = 1;
+    double clock_period_ns = 10.0;
+    uint64_t max_gap = 0;        // Cap idle stretches at this many cycles (0 = off)
+    std::string out_pattern = "ready";
+    std::string limits;          // "name=value,..." over risk_base_config()
+    uint64_t drain_limit = 1ull << 24;  // Cycles without progress before giving up
+    bool json = false;
+    bool tracing = false;
+    std::string trace_file;
+    std::string faults_path;     // Fault campaign file; empty = one replay
+    std::string campaign_out = "fault_campaign.csv";
+    unsigned jobs = 0;           // Campaign worker threads (0 = one per hardware thread)
+};
+
+// Generated stream: new orders at the --load arrival times, random side,
+// 1-100 lots at 100-200 over 16 symbols, with a fill of every 4th order
+static std::vector<OrderRecord> generate_orders(const T2TOptions& opt, ArrivalProcess& load) {
+    std::mt19937 rng(opt.seed);
+    load.start(opt.seed);
+    std::vector<OrderRecord> records;
+    records.reserve(opt.num_orders + opt.num_orders / 4);
+    for (uint64_t i = 0; i < opt.num_orders; i++) {
+        OrderRecord r{};
+        r.timestamp_ns = static_cast<uint64_t>(std::ceil(load.next() * opt.clock_period_ns));
+        r.order_id = i + 1;
+        r.quantity = 1 + rng() % 100;
+        r.price = 100 + rng() % 101;
+        r.notional = r.quantity * r.price;
+        r.symbol_id = 1 + rng() % 16;
+        r.kind = ORDER_RECORD_ORDER;
+        r.side = (rng() & 1) ? RiskGateModel::SIDE_BUY : RiskGateModel::SIDE_SELL;
+        r.order_type = RiskGateModel::TYPE_NEW;
+        records.push_back(r);
+        if (i % 4 == 3) {
+            r.kind = ORDER_RECORD_FILL;
+            records.push_back(r);
+        }
+    }
+    return records;
+}
+
+// Replay results
+struct T2TResult {
+    static constexpr int NUM_REASONS = RiskSweepResult::NUM_REASONS;
+
+    uint64_t orders = 0;
+    uint64_t fills = 0;
+    uint64_t skipped = 0;           // Unknown kind
+    uint64_t cycles = 0;
+    uint64_t decisions = 0;
+    uint64_t next_order = 0;        // Order the next in-sequence decision carries
+    uint64_t sequence_errors = 0;   // Decisions carrying any other order
+    uint64_t reasons[NUM_REASONS] = {};
+    uint64_t other_reasons = 0;
+    uint64_t traces = 0;
+    uint64_t trace_drops = 0;
+    uint64_t trace_mismatches = 0;  // Shell trace latency != shell component
+    uint64_t inflight_underflows = 0;  // Shell egress with no traced ingress
+    uint64_t queue_peak = 0;
+    uint64_t kill_trips = 0;        // Rising edges of kill_switch_active
+    uint64_t reset_cycles = 0;      // Cycles the fault injector asked for a RESET record
+    uint64_t fault_injections = 0;
+    bool timed_out = false;
+    std::string error;              // First order out of sequence
+
+    LatencyHistogram<> queue;
+    LatencyHistogram<> shell;
+    LatencyHistogram<> risk;
+    LatencyHistogram<> total;
+};
+
+// Campaign trials always run NoWaves; --trace is for a single replay
+template <typename Waves>
+class TickToTradeTestbench : public ModelHarness<Vtb_tick_to_trade, Waves> {
+    using Harness = ModelHarness<Vtb_tick_to_trade, Waves>;
+
+public:
+    using Harness::contextp;
+    using Harness::dut;
+    using Harness::waves;
+    using Harness::profiler;
+    using Harness::tracing;
+    using Harness::eval_model;
+
+    uint64_t cycles = 0;
+
+    // Post-reset state, shared by campaign trials (SAVABLE=1 builds)
+    ModelSnapshot<Vtb_tick_to_trade> post_reset;
+    uint64_t post_reset_cycles = 0;
+
+    TickToTradeTestbench(int argc, char** argv) : Harness(argc, argv) {}
+
+    ~TickToTradeTestbench() {
+        waves.close(cycles);
+    }
+
+    bool start_waves(const std::string& file) {
+        static_assert(tracing, "Waveforms need a DumpWaves testbench");
+        WaveOptions opt;
+        opt.file = file.empty() ? "tb_tick_to_trade" : file;
+        if (!waves.open(*dut, *contextp, opt, cycles)) {
+            return false;
+        }
+        printf("Waveform: %s\n", waves.file().c_str());
+        return true;
+    }
+
+    // One clock cycle (see ModelHarness::clock_edges)
+    void tick() {
+        profiler.at_cycle(cycles);
+        PROFILE_PHASE(profiler, PHASE_TICK);
+        this->clock_edges();
+        cycles++;
+    }
+
+    // Restore the post-reset snapshot when one exists, otherwise simulate
+    // (and capture) reset
+    void reset(const RiskGateModel& base, const RiskSweepLimits& limits) {
+        if (post_reset.restore(*dut, *contextp)) {
+            cycles = post_reset_cycles;
+            return;
+        }
+        simulate_reset(base, limits);
+        post_reset.capture(*dut, *contextp);
+        post_reset_cycles = cycles;
+    }
+
+    void simulate_reset(const RiskGateModel& base, const RiskSweepLimits& limits) {
+        limits.apply(*dut, base);
+        dut->rst_n = 0;
+        dut->ts_skip_cycles = 0;
+        dut->in_valid = 0;
+        dut->in_data = 0;
+        dut->in_opcode = 0;
+        dut->in_meta = 0;
+        dut->trace_ready = 1;
+        dut->out_ready = 1;
+        dut->cmd_kill_trigger = 0;
+        dut->cmd_kill_reset = 0;
+        dut->fill_valid = 0;
+        dut->fill_side = 0;
+        dut->fill_qty = 0;
+        dut->fill_notional = 0;
+        dut->current_pnl = 0;
+        dut->pnl_is_loss = 0;
+        FaultTrial().arm(*dut, 0);
+
+        for (int i = 0; i < 10; i++) {
+            tick();
+        }
+        dut->rst_n = 1;
+        tick();
+    }
+
+    // Replay records (in timestamp order) from cycle 0 until every order
+    // is decided, every trace record collected and no fault is in effect
+    void replay(const OrderRecord* begin, const OrderRecord* end, const T2TOptions& opt,
+                StallPattern& egress, T2TResult& r) {
+        std::vector<const OrderRecord*> orders;
+        for (const OrderRecord* p = begin; p != end; p++) {
+            if (p->kind == ORDER_RECORD_ORDER) orders.push_back(p);
+        }
+        const uint64_t n = orders.size();
+        std::vector<uint64_t> due(n), ingress(n), handoff(n);
+
+        const uint64_t start = cycles;
+        egress.start(0, opt.seed);
+        const OrderRecord* pos = begin;
+        std::vector<const OrderRecord*> fills;
+        uint64_t skew = 0;
+        uint64_t admitted = 0, sent = 0, handed = 0, fills_sent = 0;
+        uint64_t last_progress = 0;
+        uint8_t killed = dut->kill_switch_active;
+
+        for (;;) {
+            uint64_t c = cycles - start;
+            uint8_t prev_valid = dut->in_valid;
+            uint8_t prev_ready = dut->out_ready;
+            {
+                PROFILE_PHASE(profiler, PHASE_STIMULUS);
+                if (opt.max_gap > 0 && pos != end) {
+                    uint64_t d = due_cycle(*pos, opt.clock_period_ns, skew);
+                    if (d > c + opt.max_gap) skew += d - c - opt.max_gap;
+                }
+                while (pos != end && due_cycle(*pos, opt.clock_period_ns, skew) <= c) {
+                    if (pos->kind == ORDER_RECORD_ORDER) {
+                        due[admitted++] = c;
+                    } else if (pos->kind == ORDER_RECORD_FILL) {
+                        fills.push_back(pos);
+                        r.fills++;
+                    } else {
+                        r.skipped++;
+                    }
+                    pos++;
+                }
+                if (admitted - sent > r.queue_peak) r.queue_peak = admitted - sent;
+
+                dut->in_valid = sent < admitted;
+                if (dut->in_valid) {
+                    const OrderRecord& o = *orders[sent];
+                    dut->in_data = pack_order(o);
+                    dut->in_opcode = o.order_type;
+                    dut->in_meta = static_cast<uint32_t>(sent);
+                }
+                dut->fill_valid = fills_sent < fills.size();
+                if (dut->fill_valid) {
+                    const OrderRecord& f = *fills[fills_sent];
+                    dut->fill_side = f.side;
+                    dut->fill_qty = f.quantity;
+                    dut->fill_notional = f.notional;
+                }
+                dut->out_ready = egress.ready(c);
+            }
+            if (dut->in_valid != prev_valid || dut->out_ready != prev_ready) {
+                eval_model();
+            }
+
+            {
+                PROFILE_PHASE(profiler, PHASE_COLLECT);
+                bool accept = dut->in_valid && dut->in_ready;
+                bool handed_off = dut->shell_out_valid && dut->shell_out_ready;
+                if (dut->out_valid && dut->out_ready) {
+                    decide(c, due, ingress, handoff, handed, r);
+                    last_progress = c;
+                }
+                if (handed_off && handed < n) {
+                    handoff[handed++] = c;
+                }
+                if (accept) {
+                    ingress[sent++] = c;
+                    last_progress = c;
+                }
+                if (dut->trace_valid && dut->trace_ready) {
+                    check_trace(ingress, handoff, handed, r);
+                }
+                if (dut->fill_valid) {
+                    fills_sent++;
+                }
+            }
+            tick();
+
+            r.trace_drops = dut->trace_drop_count;
+            r.inflight_underflows = dut->inflight_underflow_count;
+            r.kill_trips += dut->kill_switch_active && !killed;
+            killed = dut->kill_switch_active;
+            r.reset_cycles += dut->fault_emit_reset;
+            // A burst fault can add decisions, so wait for the gate to empty
+            if (pos == end && handed == n && r.decisions >= n && !dut->out_valid &&
+                !dut->fault_active && fills_sent == fills.size() &&
+                r.traces + r.trace_drops + r.inflight_underflows >= handed && !dut->trace_valid) {
+                break;
+            }
+            if (cycles - start - last_progress > opt.drain_limit) {
+                r.timed_out = true;
+                break;
+            }
+        }
+        r.orders = n;
+        r.cycles = cycles - start;
+        r.fault_injections = dut->fault_injections;
+    }
+
+private:
+    // First cycle whose time reaches the record, less the idle skew (as
+    // sim_risk.cpp's OrderReplay)
+    static uint64_t due_cycle(const OrderRecord& rec, double clock_period_ns, uint64_t skew) {
+        uint64_t t_ns = rec.timestamp_ns;
+        uint64_t c = static_cast<uint64_t>(std::ceil(t_ns / clock_period_ns));
+        while (c * clock_period_ns < t_ns) c++;
+        while (c > 0 && (c - 1) * clock_period_ns >= t_ns) c--;
+        return c > skew ? c - skew : 0;
+    }
+
+    void decide(uint64_t c, const std::vector<uint64_t>& due, const std::vector<uint64_t>& ingress,
+                const std::vector<uint64_t>& handoff, uint64_t handed, T2TResult& r) {
+        uint64_t k = dut->out_order_id;
+        if (k != r.next_order || k >= handed) {
+            if (r.error.empty()) {
+                char msg[128];
+                snprintf(msg, sizeof(msg), "decision %lu carried order %lu (%lu handed off)",
+                         r.decisions, k, handed);
+                r.error = msg;
+            }
+            r.sequence_errors++;
+            // Resynchronise on a later order that was handed off; anything
+            // else (not handed off, or already decided) is not timed
+            if (k >= handed || k < r.next_order) {
+                r.decisions++;
+                return;
+            }
+        }
+        r.next_order = k + 1;
+        r.queue.record(ingress[k] - due[k]);
+        r.shell.record(handoff[k] - ingress[k]);
+        r.risk.record(c - handoff[k]);
+        r.total.record(c - due[k]);
+        uint8_t reason = dut->out_reject_reason;
+        if (reason < T2TResult::NUM_REASONS) {
+            r.reasons[reason]++;
+        } else {
+            r.other_reasons++;
+        }
+        r.decisions++;
+    }
+
+    // The shell stamps its own cycle counter; only differences compare
+    void check_trace(const std::vector<uint64_t>& ingress, const std::vector<uint64_t>& handoff,
+                     uint64_t handed, T2TResult& r) {
+        uint64_t tx = dut->trace_tx_id;
+        uint64_t lat = dut->trace_t_egress - dut->trace_t_ingress;
+        if (tx >= handed || lat != handoff[tx] - ingress[tx]) {
+            r.trace_mismatches++;
+        }
+        r.traces++;
+    }
+};
+
+static void print_component_json(const char* name, const LatencyHistogram<>& h, const char* sep) {
+    printf("\"%s\": {\"min\": %lu, \"p50\": %lu, \"p99\": %lu, \"p999\": %lu, \"p9999\": %lu, "
+           "\"max\": %lu, \"mean\": %.3f}%s", name, h.min(), h.quantile(0.50), h.quantile(0.99),
+           h.quantile(0.999), h.quantile(0.9999), h.max(), h.mean(), sep);
+}
+
+static const char* const REASON_NAMES[T2TResult::NUM_REASONS] = {
+    "ok", "rate_limited", "position", "notional", "order_size", "kill_switch",
+};
+
+// One trial of a fault campaign, as tabulated
+struct FaultTrialRow {
+    uint64_t injections = 0;
+    uint64_t cycles = 0;
+    uint64_t orders = 0;
+    uint64_t decisions = 0;
+    uint64_t sequence_errors = 0;
+    uint64_t trace_drops = 0;
+    uint64_t inflight_underflows = 0;
+    uint64_t trace_mismatches = 0;
+    uint64_t kill_trips = 0;
+    uint64_t kill_rejects = 0;
+    uint64_t rejected = 0;
+    uint64_t reset_cycles = 0;
+    uint64_t p50 = 0;
+    uint64_t p99 = 0;
+    uint64_t max = 0;
+    bool timed_out = false;
+
+    // hung: no progress for --drain-limit cycles; missed: a fault never
+    // triggered (its cycle is past the end of the stream); degraded: any
+    // loss, misordering, mismatch or kill switch activity, or rejections
+    // other than the baseline's; else ok
+    const char* status(size_t faults, const FaultTrialRow& baseline) const {
+        if (timed_out) return "hung";
+        if (injections < faults) return "missed";
+        if (trace_drops || inflight_underflows || trace_mismatches || sequence_errors ||
+            kill_trips || kill_rejects || decisions != orders || rejected != baseline.rejected) {
+            return "degraded";
+        }
+        return "ok";
+    }
+};
+
+static FaultTrialRow tabulate(const T2TResult& r) {
+    FaultTrialRow row;
+    row.injections = r.fault_injections;
+    row.cycles = r.cycles;
+    row.orders = r.orders;
+    row.decisions = r.decisions;
+    row.sequence_errors = r.sequence_errors;
+    row.trace_drops = r.trace_drops;
+    row.inflight_underflows = r.inflight_underflows;
+    row.trace_mismatches = r.trace_mismatches;
+    row.kill_trips = r.kill_trips;
+    row.kill_rejects = r.reasons[RiskGateModel::REJECT_KILL_SWITCH];
+    row.rejected = r.decisions - r.reasons[RiskGateModel::REJECT_OK];
+    row.reset_cycles = r.reset_cycles;
+    row.p50 = r.total.quantile(0.50);
+    row.p99 = r.total.quantile(0.99);
+    row.max = r.total.max();
+    row.timed_out = r.timed_out;
+    return row;
+}
+
+// Baseline (trial 0, no faults) and one trial per campaign line, each from
+// the post-reset state, tabulated to opt.campaign_out
+static int run_fault_campaign(int argc, char** argv, const T2TOptions& opt,
+                              const RiskGateModel& base, const RiskSweepLimits& limits,
+                              const StallPattern& egress, const OrderRecord* begin,
+                              const OrderRecord* end, const std::string& source) {
+    std::vector<FaultTrial> trials(1);
+    if (!load_fault_trials(opt.faults_path, trials)) {
+        return 1;
+    }
+    FILE* out = fopen(opt.campaign_out.c_str(), "w");
+    if (!out) {
+        fprintf(stderr, "Error: Cannot open campaign output %s\n", opt.campaign_out.c_str());
+        return 1;
+    }
+    unsigned jobs = opt.jobs == 0 ? std::thread::hardware_concurrency() : opt.jobs;
+    if (jobs == 0) jobs = 1;
+    if (jobs > trials.size()) jobs = static_cast<unsigned>(trials.size());
+
+    printf("\n=== Tick-to-Trade Fault Campaign ===\n\n");
+    // Simulate reset once; SAVABLE=1 builds hand every worker the snapshot
+    TickToTradeTestbench<NoWaves> proto(argc, argv);
+    proto.reset(base, limits);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<FaultTrialRow> rows(trials.size());
+    std::vector<std::string> errors(trials.size());
+    std::atomic<size_t> next_trial{0};
+    std::atomic<uint64_t> warm_starts{0};
+    auto worker = [&] {
+        // One model per worker, back in the post-reset state for each trial
+        TickToTradeTestbench<NoWaves> tb(argc, argv);
+        tb.post_reset = proto.post_reset;
+        tb.post_reset_cycles = proto.post_reset_cycles;
+        for (size_t i = next_trial++; i < trials.size(); i = next_trial++) {
+            tb.reset(base, limits);
+            trials[i].arm(*tb.dut, tb.dut->cycle_counter);
+            StallPattern pattern = egress;
+            T2TResult r;
+            tb.replay(begin, end, opt, pattern, r);
+            rows[i] = tabulate(r);
+            errors[i] = r.error;
+        }
+        warm_starts += tb.post_reset.restores();
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < jobs; t++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& t : pool) {
+        t.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const FaultTrialRow& baseline = rows[0];
+    bool baseline_ok = !baseline.timed_out && errors[0].empty() &&
+                       baseline.decisions == baseline.orders && baseline.trace_mismatches == 0;
+    if (!baseline_ok) {
+        printf("FAIL: The fault-free baseline did not replay cleanly%s%s\n",
+               errors[0].empty() ? "" : ": ", errors[0].c_str());
+    }
+
+    fprintf(out, "trial,faults,status,injections,cycles,orders,decisions,sequence_errors,"
+            "trace_drops,inflight_underflows,trace_mismatches,kill_trips,kill_rejects,rejected,"
+            "reset_cycles,p50,p99,max,p99_delta,max_delta\n");
+    printf("Orders: %lu from %s\n", baseline.orders, source.c_str());
+    printf("Core latency: %d, inflight depth: %d, trace FIFO depth: %d, egress: %s\n\n",
+           SENTINEL_CORE_LATENCY, SENTINEL_INFLIGHT_DEPTH, SENTINEL_TRACE_FIFO_DEPTH,
+           egress.text().c_str());
+    printf("%6s  %-8s %8s %10s %8s %6s %8s %8s %9s  %s\n", "trial", "status", "drops",
+           "underflows", "seq_err", "kills", "rejected", "p99", "p99_delta", "faults");
+    uint64_t hung = 0, missed = 0, degraded = 0;
+    for (size_t i = 0; i < trials.size(); i++) {
+        const FaultTrialRow& row = rows[i];
+        const char* status = row.status(trials[i].faults.size(), baseline);
+        hung += strcmp(status, "hung") == 0;
+        missed += strcmp(status, "missed") == 0;
+        degraded += strcmp(status, "degraded") == 0;
+        int64_t p99_delta = static_cast<int64_t>(row.p99) - static_cast<int64_t>(baseline.p99);
+        int64_t max_delta = static_cast<int64_t>(row.max) - static_cast<int64_t>(baseline.max);
+        const char* faults = i == 0 ? "baseline" : trials[i].text.c_str();
+        fprintf(out, "%zu,\"%s\",%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,"
+                "%lu,%ld,%ld\n", i, i == 0 ? "" : faults, status, row.injections, row.cycles,
+                row.orders, row.decisions, row.sequence_errors, row.trace_drops,
+                row.inflight_underflows, row.trace_mismatches, row.kill_trips, row.kill_rejects,
+                row.rejected, row.reset_cycles, row.p50, row.p99, row.max, p99_delta, max_delta);
+        printf("%6zu  %-8s %8lu %10lu %8lu %6lu %8lu %8lu %+9ld  %s\n", i, status,
+               row.trace_drops, row.inflight_underflows, row.sequence_errors, row.kill_trips,
+               row.rejected, row.p99, p99_delta, faults);
+    }
+    bool write_ok = fclose(out) == 0;
+    if (!write_ok) {
+        fprintf(stderr, "Error: Campaign output write failed\n");
+    }
+
+    bool pass = baseline_ok && hung == 0 && write_ok;
+    size_t faulted = trials.size() - 1;
+    printf("\nTrials: %zu plus baseline: %lu ok, %lu degraded, %lu missed, %lu hung\n", faulted,
+           faulted - degraded - missed - hung, degraded, missed, hung);
+    printf("Table: %s\n", opt.campaign_out.c_str());
+    printf("Worker threads: %u, post-reset snapshot: ", jobs);
+    if (proto.post_reset.valid()) {
+        printf("%zu bytes, %lu warm starts\n", proto.post_reset.size_bytes(),
+               (unsigned long)warm_starts.load());
+    } else {
+        printf("none (reset simulated per trial; build with SAVABLE=1)\n");
+    }
+    printf("Wall time: %.3f s, %.1f trials/s\n", seconds,
+           seconds > 0 ? trials.size() / seconds : 0.0);
+    printf("Overall: %s\n", pass ? "PASS" : "FAIL");
+
+    if (opt.json) {
+        printf("{\"trials\": %zu, \"ok\": %lu, \"degraded\": %lu, \"missed\": %lu, "
+               "\"hung\": %lu, ", faulted, faulted - degraded - missed - hung, degraded, missed,
+               hung);
+        printf("\"baseline\": {\"orders\": %lu, \"decisions\": %lu, \"cycles\": %lu, "
+               "\"p50\": %lu, \"p99\": %lu, \"max\": %lu}, ", baseline.orders,
+               baseline.decisions, baseline.cycles, baseline.p50, baseline.p99, baseline.max);
+        printf("\"campaign_out\": \"%s\", \"worker_threads\": %u, \"snapshot_bytes\": %zu, "
+               "\"warm_starts\": %lu, ", opt.campaign_out.c_str(), jobs,
+               proto.post_reset.size_bytes(), (unsigned long)warm_starts.load());
+        printf("\"wall_time_s\": %.6f, \"trials_per_sec\": %.1f, \"peak_rss_kb\": %lu, "
+               "\"overall\": \"%s\"}\n", seconds, seconds > 0 ? trials.size() / seconds : 0.0,
+               (unsigned long)peak_rss_kb(), pass ? "PASS" : "FAIL");
+    }
+    return pass ? 0 : 1;
+}
+
+static int run_tick_to_trade(int argc, char** argv, const T2TOptions& opt) {
+    if (opt.clock_period_ns <= 0) {
+        fprintf(stderr, "Error: --clock-ns must be positive\n");
+        return 1;
+    }
+    RiskGateModel base = risk_base_config();
+    std::vector<RiskSweepLimits> limits;
+    if (!parse_sweep(opt.limits, base, limits)) {
+        return 1;
+    }
+    if (limits.size() != 1) {
+        fprintf(stderr, "Error: --limits takes one value per limit\n");
+        return 1;
+    }
+    StallPattern egress;
+    if (!egress.parse(opt.out_pattern, "out_ready")) {
+        return 1;
+    }
+    if (!egress.drains()) {
+        fprintf(stderr, "Error: out_ready pattern 'stall' never drains the risk gate\n");
+        return 1;
+    }
+
+    MappedRecords<OrderRecord> mapped;
+    std::vector<OrderRecord> generated;
+    const OrderRecord* begin;
+    const OrderRecord* end;
+    std::string source;
+    if (!opt.orders_path.empty()) {
+        if (!mapped.open(opt.orders_path, "order")) {
+            return 1;
+        }
+        begin = mapped.begin();
+        end = mapped.end();
+        source = opt.orders_path;
+    } else {
+        ArrivalProcess load;
+        if (!load.parse(opt.load)) {
+            return 1;
+        }
+        generated = generate_orders(opt, load);
+        begin = generated.data();
+        end = generated.data() + generated.size();
+        source = opt.load + " (generated)";
+    }
+    for (const OrderRecord* p = begin; p != end; p++) {
+        if (p->kind == ORDER_RECORD_ORDER && !order_fits(*p)) {
+            fprintf(stderr, "Error: Order %lu does not fit the order word (price and quantity "
+                    "< 2^%d, symbol_id < 2^%d)\n", (unsigned long)p->order_id, ORDER_PRICE_BITS,
+                    ORDER_SYMBOL_BITS);
+            return 1;
+        }
+    }
+    if (!opt.faults_path.empty()) {
+        if (opt.tracing) {
+            fprintf(stderr, "Error: --trace records one replay, not a --faults campaign\n");
+            return 1;
+        }
+        return run_fault_campaign(argc, argv, opt, base, limits[0], egress, begin, end, source);
+    }
+
+    printf("\n=== Tick-to-Trade Co-Simulation ===\n\n");
+    T2TResult r;
+    PhaseProfiler profiler;
+    double seconds = 0;
+    bool started = with_wave_policy(opt.tracing, [&](auto waves) {
+        TickToTradeTestbench<decltype(waves)> tb(argc, argv);
+        if constexpr (decltype(waves)::enabled) {
+            if (!tb.start_waves(opt.trace_file)) {
+                return false;
+            }
+        }
+        tb.reset(base, limits[0]);
+
+        auto start = std::chrono::steady_clock::now();
+        tb.profiler.begin();
+        tb.replay(begin, end, opt, egress, r);
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        profiler = tb.profiler;
+        return true;
+    });
+    if (!started) {
+        return 1;
+    }
+
+    bool pass = !r.timed_out && r.error.empty() && r.decisions == r.orders &&
+                r.trace_mismatches == 0;
+    if (r.timed_out) {
+        printf("FAIL: No progress for %lu cycles (%lu of %lu orders decided)\n",
+               opt.drain_limit, r.decisions, r.orders);
+    }
+    if (!r.error.empty()) {
+        printf("FAIL: Decisions out of order: %s\n", r.error.c_str());
+    }
+    if (r.trace_mismatches > 0) {
+        printf("FAIL: %lu shell trace records disagree with the shell handshakes\n",
+               r.trace_mismatches);
+    }
+
+    printf("Orders: %lu, fills: %lu from %s", r.orders, r.fills, source.c_str());
+    if (r.skipped > 0) {
+        printf(" (%lu of unknown kind skipped)", r.skipped);
+    }
+    printf("\n");
+    printf("Core latency: %d, inflight depth: %d, trace FIFO depth: %d, egress: %s\n",
+           SENTINEL_CORE_LATENCY, SENTINEL_INFLIGHT_DEPTH, SENTINEL_TRACE_FIFO_DEPTH,
+           egress.text().c_str());
+    printf("Cycles: %lu at %.3f ns", r.cycles, opt.clock_period_ns);
+    if (opt.max_gap > 0) {
+        printf(", idle stretches capped at %lu cycles", opt.max_gap);
+    }
+    printf("\n");
+    printf("Decisions:");
+    for (int k = 0; k < T2TResult::NUM_REASONS; k++) {
+        printf(" %s=%lu", REASON_NAMES[k], r.reasons[k]);
+    }
+    printf("\n");
+    printf("Shell traces: %lu collected, %lu dropped", r.traces, r.trace_drops);
+    if (r.inflight_underflows > 0) {
+        printf(", %lu inflight underflows (a CORE_LATENCY=0 core cannot be traced)",
+               r.inflight_underflows);
+    }
+    printf("\n");
+    printf("\nLatency (cycles)  %8s %8s %8s %8s %10s\n", "p50", "p99", "p99.9", "max", "mean");
+    const std::pair<const char*, const LatencyHistogram<>*> components[] = {
+        {"queue", &r.queue}, {"shell", &r.shell}, {"risk", &r.risk}, {"total", &r.total},
+    };
+    for (const auto& c : components) {
+        printf("  %-15s %8lu %8lu %8lu %8lu %10.2f\n", c.first, c.second->quantile(0.50),
+               c.second->quantile(0.99), c.second->quantile(0.999), c.second->max(),
+               c.second->mean());
+    }
+    printf("Total p99: %.1f ns; order queue peak: %lu\n\n",
+           r.total.quantile(0.99) * opt.clock_period_ns, r.queue_peak);
+    printf("Wall time: %.3f s\n", seconds);
+    printf("Sim rate: %.0f cycles/s, %.0f orders/s\n",
+           seconds > 0 ? r.cycles / seconds : 0.0, seconds > 0 ? r.orders / seconds : 0.0);
+    profiler.print_summary(seconds);
+    printf("Overall: %s\n", pass ? "PASS" : "FAIL");
+
+    if (opt.json) {
+        printf("{\"orders\": %lu, \"fills\": %lu, \"skipped\": %lu, \"cycles\": %lu, ",
+               r.orders, r.fills, r.skipped, r.cycles);
+        printf("\"clock_ns\": %.3f, \"core_latency\": %d, \"out_pattern\": \"%s\", ",
+               opt.clock_period_ns, SENTINEL_CORE_LATENCY, egress.text().c_str());
+        printf("\"decisions\": %lu, \"reasons\": {", r.decisions);
+        for (int k = 0; k < T2TResult::NUM_REASONS; k++) {
+            printf("%s\"%s\": %lu", k ? ", " : "", REASON_NAMES[k], r.reasons[k]);
+        }
+        printf("}, \"latency_cycles\": {");
+        for (size_t k = 0; k < 4; k++) {
+            print_component_json(components[k].first, *components[k].second, k < 3 ? ", " : "");
+        }
+        printf("}, \"traces\": %lu, \"trace_drops\": %lu, \"trace_mismatches\": %lu, "
+               "\"inflight_underflows\": %lu, ", r.traces, r.trace_drops, r.trace_mismatches,
+               r.inflight_underflows);
+        printf("\"queue_peak\": %lu, ", r.queue_peak);
+        profiler.print_json(seconds);
+        printf("\"wall_time_s\": %.6f, \"cycles_per_sec\": %.1f, \"orders_per_sec\": %.1f, "
+               "\"peak_rss_kb\": %lu, \"overall\": \"%s\"}\n",
+               seconds, seconds > 0 ? r.cycles / seconds : 0.0,
+               seconds > 0 ? r.orders / seconds : 0.0, (unsigned long)peak_rss_kb(),
+               pass ? "PASS" : "FAIL");
+    }
+    return pass ? 0 : 1;
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("Options:\n");
+    printf("  --orders FILE        Replay a recorded order/fill file (order_record.h)\n");
+    printf("  --num-orders N       Generated orders when no --orders (default: 10000)\n");
+    printf("  --load SPEC          Generated arrivals: constant:PCT, poisson:PCT[:SEED] or\n");
+    printf("                       mmpp:LOW:HIGH:LOW_CYC:HIGH_CYC[:SEED] (default: poisson:50)\n");
+    printf("  --seed N             Seed of the generated stream and egress pattern\n");
+    printf("  --clock-ns N         Clock period for record timestamps (default: 10)\n");
+    printf("  --max-gap N          Cap idle stretches at N cycles\n");
+    printf("  --out-pattern SPEC   Egress out_ready waveform (stall_pattern.h, default: ready)\n");
+    printf("  --limits SPEC        Risk limits, e.g. rate_max_tokens=50,pos_max_long=1000\n");
+    printf("  --drain-limit N      Cycles without progress before failing (default: 2^24)\n");
+    printf("  --faults FILE        Run a fault campaign, one trial per line (fault_campaign.h)\n");
+    printf("  --campaign-out FILE  Campaign table (default: fault_campaign.csv)\n");
+    printf("  --jobs N             Campaign worker threads (default: one per hardware thread)\n");
+    printf("  --trace              Write a waveform\n");
+    printf("  --trace-file FILE    Waveform file (default: tb_tick_to_trade.vcd)\n");
+    printf("  --json               Print results as JSON\n");
+    printf("  --help               Show this help\n");
+}
+
+int main(int argc, char** argv) {
+    T2TOptions opt;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--orders") == 0 && i + 1 < argc) {
+            opt.orders_path = argv[++i];
+        } else if (strcmp(argv[i], "--num-orders") == 0 && i + 1 < argc) {
+            opt.num_orders = strtoull(argv[++i], nullptr, 0);
+        } else if (strcmp(argv[i], "--load") == 0 && i + 1 < argc) {
+            opt.load = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            opt.seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+        } else if (strcmp(argv[i], "--clock-ns") == 0 && i + 1 < argc) {
+            opt.clock_period_ns = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--max-gap") == 0 && i + 1 < argc) {
+            opt.max_gap = strtoull(argv[++i], nullptr, 0);
+        } else if (strcmp(argv[i], "--out-pattern") == 0 && i + 1 < argc) {
+            opt.out_pattern = argv[++i];
+        } else if (strcmp(argv[i], "--limits") == 0 && i + 1 < argc) {
+            opt.limits = argv[++i];
+        } else if (strcmp(argv[i], "--drain-limit") == 0 && i + 1 < argc) {
+            opt.drain_limit = strtoull(argv[++i], nullptr, 0);
+        } else if (strcmp(argv[i], "--faults") == 0 && i + 1 < argc) {
+            opt.faults_path = argv[++i];
+        } else if (strcmp(argv[i], "--campaign-out") == 0 && i + 1 < argc) {
+            opt.campaign_out = argv[++i];
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            opt.jobs = static_cast<unsigned>(strtoul(argv[++i], nullptr, 0));
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            opt.tracing = true;
+        } else if (strcmp(argv[i], "--trace-file") == 0 && i + 1 < argc) {
+            opt.trace_file = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0) {
+            opt.json = true;
+        } else if (strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        }
+    }
+    return run_tick_to_trade(argc, argv, opt);
+}
@@ -0,0 +1,227 @@
+/*
+ * Ready/Stall Pattern Engine
+ *
+ * Generates the ready waveform of a downstream consumer (out_ready or
+ * trace_ready) for the shell testbench, so stalls can be modelled the
+ * way real consumers produce them (PCIe/DMA credit stalls, host GC
+ * pauses) rather than as one fixed block. Specs, as given to
+ * --out-pattern / --trace-pattern:
+ *
+ *   ready                        Always ready
+ *   stall                        Never ready
+ *   periodic:PERIOD:STALL        Ready PERIOD-STALL cycles, then stalled
+ *                                STALL cycles, repeating
+ *   markov:READY:STALL[:SEED]    Two-state on/off Markov chain: runs of
+ *                                ready and stalled cycles are geometric
+ *                                with the given means (cycles)
+ *   file:PATH                    Run-length script, one "ready N" or
+ *                                "stall N" per line (# comments),
+ *                                repeated once it ends
+ *
+ * The waveform is kept as a sequence of runs: ready(cycle) is a compare
+ * against the cycle the current run ends, and the next run is drawn only
+ * when that cycle is reached. Nothing is allocated once a pattern is
+ * parsed, and cycles may jump forward (fast-forward) at the cost of one
+ * draw per run skipped.
+ */
+
+#ifndef SENTINEL_STALL_PATTERN_H
+#define SENTINEL_STALL_PATTERN_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+class StallPattern {
+public:
+    enum Kind { READY, STALL, PERIODIC, MARKOV, SCRIPT };
+
+    StallPattern() = default;
+
+    // Parse a spec; what names the signal in error messages
+    bool parse(const std::string& text, const char* what) {
+        spec = text;
+        std::vector<std::string> f = split(text);
+        const std::string& k = f[0];
+        bool ok = true;
+        if (k == "ready" && f.size() == 1) {
+            kind = READY;
+        } else if (k == "stall" && f.size() == 1) {
+            kind = STALL;
+        } else if (k == "periodic" && f.size() == 3) {
+            kind = PERIODIC;
+            ok = to_u64(f[1], period) && to_u64(f[2], stall_len) &&
+                 stall_len > 0 && stall_len < period;
+        } else if (k == "markov" && (f.size() == 3 || f.size() == 4)) {
+            kind = MARKOV;
+            double mean_ready = atof(f[1].c_str());
+            double mean_stall = atof(f[2].c_str());
+            ok = mean_ready >= 1.0 && mean_stall >= 1.0 &&
+                 (f.size() == 3 || to_u64(f[3], seed));
+            seeded = f.size() == 4;
+            // Run length = 1 + failures before success (geometric, mean m)
+            ready_runs = std::geometric_distribution<uint64_t>(1.0 / mean_ready);
+            stall_runs = std::geometric_distribution<uint64_t>(1.0 / mean_stall);
+        } else if (k == "file" && f.size() >= 2) {
+            kind = SCRIPT;
+            return load_script(text.substr(5), what);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            fprintf(stderr, "Error: Invalid %s pattern: %s (expected ready, stall, "
+                    "periodic:PERIOD:STALL, markov:READY:STALL[:SEED] or file:PATH)\n",
+                    what, text.c_str());
+        }
+        return ok;
+    }
+
+    // Start the waveform at cycle; default_seed is used by an unseeded
+    // markov pattern
+    void start(uint64_t cycle, uint64_t default_seed = 1) {
+        if (kind == READY || kind == STALL) {
+            state = kind == READY;
+            run_end = UINT64_MAX;
+            return;
+        }
+        if (kind == MARKOV) {
+            rng.seed(seeded ? seed : default_seed);
+            ready_runs.reset();
+            stall_runs.reset();
+        }
+        script_pos = 0;
+        // Entering the first run flips this to ready (scripts: their first line)
+        state = 0;
+        run_end = cycle;
+        next_run();
+    }
+
+    // Ready at cycle (cycles must not go backwards)
+    uint8_t ready(uint64_t cycle) {
+        while (cycle >= run_end) {
+            next_run();
+        }
+        return state;
+    }
+
+    Kind pattern_kind() const { return kind; }
+    const std::string& text() const { return spec; }
+
+    // False when the consumer never becomes ready (no drain possible)
+    bool drains() const { return kind != STALL; }
+
+    bool always_ready() const { return kind == READY; }
+
+private:
+    struct Run {
+        uint8_t ready;
+        uint64_t cycles;
+    };
+
+    // Enter the run after the current one
+    void next_run() {
+        switch (kind) {
+        case PERIODIC:
+            state ^= 1;
+            run_end += state ? period - stall_len : stall_len;
+            break;
+        case MARKOV:
+            state ^= 1;
+            run_end += 1 + (state ? ready_runs(rng) : stall_runs(rng));
+            break;
+        case SCRIPT:
+            state = script[script_pos].ready;
+            run_end += script[script_pos].cycles;
+            script_pos = script_pos + 1 == script.size() ? 0 : script_pos + 1;
+            break;
+        default:
+            run_end = UINT64_MAX;
+            break;
+        }
+    }
+
+    static std::vector<std::string> split(const std::string& s) {
+        std::vector<std::string> out;
+        size_t pos = 0;
+        for (;;) {
+            size_t colon = s.find(':', pos);
+            out.push_back(s.substr(pos, colon - pos));
+            if (colon == std::string::npos) {
+                return out;
+            }
+            pos = colon + 1;
+        }
+    }
+
+    static bool to_u64(const std::string& s, uint64_t& v) {
+        char* end = nullptr;
+        v = strtoull(s.c_str(), &end, 0);
+        return !s.empty() && *end == '\0';
+    }
+
+    bool load_script(const std::string& path, const char* what) {
+        FILE* f = fopen(path.c_str(), "r");
+        if (!f) {
+            fprintf(stderr, "Error: Could not open %s pattern file %s: %s\n",
+                    what, path.c_str(), strerror(errno));
+            return false;
+        }
+        script.clear();
+        char line[256];
+        int lineno = 0;
+        bool ok = true;
+        while (ok && fgets(line, sizeof(line), f)) {
+            lineno++;
+            char* hash = strchr(line, '#');
+            if (hash) *hash = '\0';
+            char word[16];
+            unsigned long long n = 0;
+            int got = sscanf(line, "%15s %llu", word, &n);
+            if (got <= 0) {
+                continue;  // Blank or comment
+            }
+            bool is_ready = strcmp(word, "ready") == 0;
+            if (got != 2 || n == 0 || (!is_ready && strcmp(word, "stall") != 0)) {
+                fprintf(stderr, "Error: %s:%d: expected \"ready N\" or \"stall N\" (N >= 1)\n",
+                        path.c_str(), lineno);
+                ok = false;
+            } else {
+                script.push_back({static_cast<uint8_t>(is_ready), static_cast<uint64_t>(n)});
+            }
+        }
+        fclose(f);
+        if (ok && script.empty()) {
+            fprintf(stderr, "Error: %s pattern file %s has no runs\n", what, path.c_str());
+            ok = false;
+        }
+        return ok;
+    }
+
+    Kind kind = READY;
+    std::string spec = "ready";
+
+    uint8_t state = 1;
+    uint64_t run_end = UINT64_MAX;  // First cycle of the next run
+
+    // periodic
+    uint64_t period = 0;
+    uint64_t stall_len = 0;
+
+    // markov
+    uint64_t seed = 1;
+    bool seeded = false;
+    std::mt19937_64 rng;
+    std::geometric_distribution<uint64_t> ready_runs;
+    std::geometric_distribution<uint64_t> stall_runs;
+
+    // file
+    std::vector<Run> script;
+    size_t script_pos = 0;
+};
+
+#endif
@@ -0,0 +1,25 @@
+/*
+ * Replay Stimulus Record
+ *
+ * 24-byte packed record read by the replay modes of the shell drivers.
+ * Layout must match wind_tunnel/input_formats.py (InputTransaction.to_binary).
+ */
+
+#ifndef SENTINEL_STIMULUS_RECORD_H
+#define SENTINEL_STIMULUS_RECORD_H
+
+#include <cstdint>
+
+#pragma pack(push, 1)
+struct StimulusRecord {
+    uint64_t timestamp_ns;  // When to inject (relative to start)
+    uint64_t data;          // 64-bit data payload
+    uint16_t opcode;        // 16-bit opcode
+    uint32_t meta;          // 32-bit metadata
+    uint16_t _padding;      // Align to 24 bytes
+};
+#pragma pack(pop)
+
+static_assert(sizeof(StimulusRecord) == 24, "StimulusRecord must be 24 bytes");
+
+#endif
@@ -17,6 +17,10 @@ module tb_sentinel_shell
   input  logic clk,
   input  logic rst_n,
 
+  // Idle fast-forward: extra cycles to add to the shell's cycle counter
+  // on this clock (0 for normal cycle-by-cycle simulation)
+  input  logic [CYCLE_WIDTH-1:0]      ts_skip_cycles,
+
   // Input Stream Control
   input  logic                        in_valid,
   output logic                        in_ready,
@@ -80,6 +84,7 @@ module tb_sentinel_shell
   ) u_shell (
     .clk                      (clk),
     .rst_n                    (rst_n),
+    .cycle_skip               (ts_skip_cycles),
     // Input stream
     .in_valid                 (in_valid),
     .in_ready                 (in_ready),
@@ -0,0 +1,110 @@
+`timescale 1ns / 1ps
+
+// Testbench Wrapper for Sentinel Shell v1.2 (latency attribution)
+//
+// Wraps sentinel_shell_v12 (instrumented pipeline + 64-byte trace
+// records) and unpacks the trace record into individual ports for the
+// Verilator C++ driver (sim_v12.cpp).
+//
+module tb_sentinel_shell_v12
+  import trace_pkg_v12::*;
+#(
+  parameter int CORE_LATENCY   = 10,
+  parameter int RISK_LATENCY   = 5,
+  parameter int FIFO_DEPTH     = 64,
+  parameter int INFLIGHT_DEPTH = 8,
+  parameter int CORE_ID        = 0
+)(
+  // Clock and Reset (directly driven by testbench)
+  input  logic        clk,
+  input  logic        rst_n,
+
+  // Upstream
+  input  logic        up_valid,
+  output logic        up_ready,
+  input  logic [63:0] up_data,
+
+  // Downstream
+  output logic        dn_valid,
+  input  logic        dn_ready,
+  output logic [63:0] dn_data,
+
+  // Trace Output Control
+  output logic        trace_valid,
+  input  logic        trace_ready,
+  output logic [6:0]  trace_size,
+
+  // Trace Record Fields (unpacked for easy C++ access)
+  output logic [7:0]  trace_version,
+  output logic [7:0]  trace_record_type,
+  output logic [15:0] trace_core_id,
+  output logic [31:0] trace_seq_no,
+  output logic [63:0] trace_t_ingress,
+  output logic [63:0] trace_t_egress,
+  output logic [63:0] trace_t_host,
+  output logic [15:0] trace_tx_id,
+  output logic [15:0] trace_flags,
+  output logic [31:0] trace_d_ingress,
+  output logic [31:0] trace_d_core,
+  output logic [31:0] trace_d_risk,
+  output logic [31:0] trace_d_egress,
+
+  // Status
+  output logic [31:0] seq_no,
+  output logic [31:0] trace_drop_count,
+  output logic [31:0] inflight_underflow_count
+);
+
+  // Packed trace record from the shell
+  logic [511:0]      trace_data;
+  trace_record_v12_t trace_rec;
+
+  // =========================================================================
+  // DUT: Sentinel Shell v1.2
+  // =========================================================================
+  sentinel_shell_v12 #(
+    .CORE_LATENCY   (CORE_LATENCY),
+    .RISK_LATENCY   (RISK_LATENCY),
+    .FIFO_DEPTH     (FIFO_DEPTH),
+    .INFLIGHT_DEPTH (INFLIGHT_DEPTH),
+    .EMIT_V12       (1),
+    .CORE_ID        (CORE_ID)
+  ) u_shell (
+    .clk                      (clk),
+    .rst_n                    (rst_n),
+    .up_valid                 (up_valid),
+    .up_ready                 (up_ready),
+    .up_data                  (up_data),
+    .dn_valid                 (dn_valid),
+    .dn_ready                 (dn_ready),
+    .dn_data                  (dn_data),
+    .dn_tlast                 (),
+    .trace_valid              (trace_valid),
+    .trace_ready              (trace_ready),
+    .trace_data               (trace_data),
+    .trace_size               (trace_size),
+    .seq_no                   (seq_no),
+    .trace_drop_count         (trace_drop_count),
+    .inflight_underflow_count (inflight_underflow_count)
+  );
+
+  // =========================================================================
+  // Unpack trace record for C++ access
+  // =========================================================================
+  assign trace_rec = trace_record_v12_t'(trace_data);
+
+  assign trace_version     = trace_rec.version;
+  assign trace_record_type = trace_rec.record_type;
+  assign trace_core_id     = trace_rec.core_id;
+  assign trace_seq_no      = trace_rec.seq_no;
+  assign trace_t_ingress   = trace_rec.t_ingress;
+  assign trace_t_egress    = trace_rec.t_egress;
+  assign trace_t_host      = trace_rec.t_host;
+  assign trace_tx_id       = trace_rec.tx_id;
+  assign trace_flags       = trace_rec.flags;
+  assign trace_d_ingress   = trace_rec.d_ingress;
+  assign trace_d_core      = trace_rec.d_core;
+  assign trace_d_risk      = trace_rec.d_risk;
+  assign trace_d_egress    = trace_rec.d_egress;
+
+endmodule
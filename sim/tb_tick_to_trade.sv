@@ -0,0 +1,377 @@
+`timescale 1ns / 1ps
+
+// Tick-to-Trade Testbench: Sentinel Shell feeding the Risk Gate
+//
+// The order path of fpga/u55c/sentinel_u55c_top.sv in one model: market
+// data enters the shell, passes the (stub) strategy core, and the shell's
+// egress word is decoded into an order_t for the risk gate, whose
+// decision is the order leaving the card. shell out_valid/out_ready is
+// the risk gate's in_valid/in_ready, so gate back-pressure reaches the
+// core exactly as it does on the board.
+//
+// The U55C top only zero-pads the 64-bit egress word into order_t. Here
+// the word has a fixed layout so a replayed order survives the trip
+// (sim_t2t.cpp packs it the same way):
+//
+//   [63:62] side          risk_pkg order_side_e
+//   [61:58] order_type    risk_pkg order_type_e
+//   [57:42] symbol_id
+//   [41:21] quantity
+//   [20:0]  price
+//
+// Notional is computed here as quantity * price. order_id is the number
+// of orders the shell has handed to the gate, so the k-th decision is the
+// order with shell tx_id k.
+//
+// rtl/fault_injector.sv sits on the handoff for fault campaigns
+// (sim_t2t.cpp --faults, fault_campaign.h). With no config valid it
+// passes everything through. Its intercepts map onto this path as:
+//
+//   dn_valid/ready/data  shell egress -> gate ingress. A held-off ready
+//                        stalls both sides; a forced valid (BURST) is
+//                        accepted by the gate only
+//   fifo_full            Holds the trace consumer off, so the shell's
+//                        trace FIFO fills and drops as when really full
+//   kill_switch          cmd_kill_trigger into the gate
+//   seq_no               Low 32 bits of the order_id the gate sees
+//   emit_reset           Exposed as fault_emit_reset (the shell has no
+//                        RESET record)
+//
+// The injector triggers on the shell's cycle_counter.
+//
+module tb_tick_to_trade
+  import risk_pkg::*;
+#(
+  parameter int DATA_WIDTH       = 64,
+  parameter int CORE_LATENCY     = 1,
+  parameter int INFLIGHT_DEPTH   = 16,
+  parameter int TRACE_FIFO_DEPTH = 64,
+  parameter int NUM_FAULTS       = 4
+)(
+  input  logic clk,
+  input  logic rst_n,
+
+  // Idle fast-forward for the shell's cycle counter (0 = cycle by cycle)
+  input  logic [trace_pkg::CYCLE_WIDTH-1:0]  ts_skip_cycles,
+
+  // Shell ingress (market data / order words)
+  input  logic                               in_valid,
+  output logic                               in_ready,
+  input  logic [DATA_WIDTH-1:0]              in_data,
+  input  logic [trace_pkg::OPCODE_WIDTH-1:0] in_opcode,
+  input  logic [trace_pkg::META_WIDTH-1:0]   in_meta,
+
+  // Shell to risk gate handoff, shell side (observation only)
+  output logic                               shell_out_valid,
+  output logic                               shell_out_ready,
+
+  // Fault injector configuration (fault_pkg::fault_config_t per config)
+  input  logic [NUM_FAULTS-1:0][3:0]         fault_type,
+  input  logic [NUM_FAULTS-1:0][31:0]        fault_trigger_cycle,
+  input  logic [NUM_FAULTS-1:0][31:0]        fault_duration,
+  input  logic [NUM_FAULTS-1:0][31:0]        fault_param,
+  input  logic [NUM_FAULTS-1:0]              fault_valid,
+
+  // Fault injector status
+  output logic                               fault_active,
+  output logic [31:0]                        fault_injections,
+  output logic                               fault_emit_reset,
+
+  // Shell trace output
+  output logic                               trace_valid,
+  input  logic                               trace_ready,
+  output logic [trace_pkg::TX_ID_WIDTH-1:0]  trace_tx_id,
+  output logic [trace_pkg::CYCLE_WIDTH-1:0]  trace_t_ingress,
+  output logic [trace_pkg::CYCLE_WIDTH-1:0]  trace_t_egress,
+  output logic [15:0]                        trace_flags,
+  output logic [trace_pkg::OPCODE_WIDTH-1:0] trace_opcode,
+  output logic [trace_pkg::META_WIDTH-1:0]   trace_meta,
+
+  // Shell status counters
+  output logic [trace_pkg::CYCLE_WIDTH-1:0]  cycle_counter,
+  output logic [63:0]                        trace_drop_count,
+  output logic [63:0]                        in_backpressure_cycles,
+  output logic [63:0]                        out_backpressure_cycles,
+  output logic [31:0]                        inflight_underflow_count,
+  output logic                               trace_overflow_seen,
+
+  // Risk gate configuration
+  input  logic [31:0] cfg_rate_max_tokens,
+  input  logic [31:0] cfg_rate_refill_rate,
+  input  logic [15:0] cfg_rate_refill_period,
+  input  logic        cfg_rate_enabled,
+
+  input  logic [63:0] cfg_pos_max_long,
+  input  logic [63:0] cfg_pos_max_short,
+  input  logic [63:0] cfg_pos_max_notional,
+  input  logic [63:0] cfg_pos_max_order_qty,
+  input  logic        cfg_pos_enabled,
+
+  input  logic        cfg_kill_armed,
+  input  logic        cfg_kill_auto_enabled,
+  input  logic [63:0] cfg_kill_loss_threshold,
+  input  logic        cmd_kill_trigger,
+  input  logic        cmd_kill_reset,
+
+  // Order egress (risk gate decisions)
+  output logic        out_valid,
+  input  logic        out_ready,
+  output logic [DATA_WIDTH-1:0] out_data,
+  output logic [63:0] out_order_id,
+  output logic        out_rejected,
+  output logic [7:0]  out_reject_reason,
+
+  // Fill input
+  input  logic        fill_valid,
+  input  logic [1:0]  fill_side,
+  input  logic [63:0] fill_qty,
+  input  logic [63:0] fill_notional,
+
+  // P&L input
+  input  logic [63:0] current_pnl,
+  input  logic        pnl_is_loss,
+
+  // Risk gate status and statistics
+  output logic [31:0] status_tokens,
+  output logic [63:0] status_position,
+  output logic        kill_switch_active,
+  output logic [63:0] stat_total,
+  output logic [63:0] stat_passed,
+  output logic [63:0] stat_rejected_rate,
+  output logic [63:0] stat_rejected_pos,
+  output logic [63:0] stat_rejected_kill
+);
+
+  // =========================================================================
+  // Core interface (shell <-> stub core)
+  // =========================================================================
+  logic                        core_in_valid;
+  logic                        core_in_ready;
+  logic [DATA_WIDTH-1:0]       core_in_data;
+  logic                        core_out_valid;
+  logic                        core_out_ready;
+  logic [DATA_WIDTH-1:0]       core_out_data;
+  logic                        core_error;
+  logic                        core_stub_detected;
+
+  trace_pkg::trace_record_t    trace_data;
+  logic                        shell_trace_valid;
+  logic                        shell_trace_ready;
+
+  // Shell egress, into the fault injector
+  logic                        shell_dn_valid;
+  logic                        shell_dn_ready;
+  logic [DATA_WIDTH-1:0]       shell_dn_data;
+
+  // Fault injector output, into the risk gate
+  logic                        risk_in_valid;
+  logic                        risk_in_ready;
+  logic                        fault_dn_valid;
+  logic [DATA_WIDTH-1:0]       fault_dn_data;
+  logic                        fault_fifo_full;
+  logic                        fault_kill;
+  logic [31:0]                 fault_seq_no;
+
+  // =========================================================================
+  // Sentinel Shell + Stub Latency Core
+  // =========================================================================
+  sentinel_shell #(
+    .DATA_WIDTH       (DATA_WIDTH),
+    .INFLIGHT_DEPTH   (INFLIGHT_DEPTH),
+    .TRACE_FIFO_DEPTH (TRACE_FIFO_DEPTH)
+  ) u_shell (
+    .clk                      (clk),
+    .rst_n                    (rst_n),
+    .cycle_skip               (ts_skip_cycles),
+    .in_valid                 (in_valid),
+    .in_ready                 (in_ready),
+    .in_data                  (in_data),
+    .in_opcode                (in_opcode),
+    .in_meta                  (in_meta),
+    .out_valid                (shell_dn_valid),
+    .out_ready                (shell_dn_ready),
+    .out_data                 (shell_dn_data),
+    .core_in_valid            (core_in_valid),
+    .core_in_ready            (core_in_ready),
+    .core_in_data             (core_in_data),
+    .core_out_valid           (core_out_valid),
+    .core_out_ready           (core_out_ready),
+    .core_out_data            (core_out_data),
+    .core_error               (core_error),
+    .trace_valid              (shell_trace_valid),
+    .trace_ready              (shell_trace_ready),
+    .trace_data               (trace_data),
+    .cycle_counter            (cycle_counter),
+    .trace_drop_count         (trace_drop_count),
+    .in_backpressure_cycles   (in_backpressure_cycles),
+    .out_backpressure_cycles  (out_backpressure_cycles),
+    .inflight_underflow_count (inflight_underflow_count),
+    .trace_overflow_seen      (trace_overflow_seen)
+  );
+
+  stub_latency_core #(
+    .DATA_WIDTH (DATA_WIDTH),
+    .LATENCY    (CORE_LATENCY),
+    .STUB_ONLY  (1'b1)
+  ) u_core (
+    .clk                (clk),
+    .rst_n              (rst_n),
+    .in_valid           (core_in_valid),
+    .in_ready           (core_in_ready),
+    .in_data            (core_in_data),
+    .out_valid          (core_out_valid),
+    .out_ready          (core_out_ready),
+    .out_data           (core_out_data),
+    .error              (core_error),
+    .stub_core_detected (core_stub_detected)
+  );
+
+  assign trace_tx_id     = trace_data.tx_id;
+  assign trace_t_ingress = trace_data.t_ingress;
+  assign trace_t_egress  = trace_data.t_egress;
+  assign trace_flags     = trace_data.flags;
+  assign trace_opcode    = trace_data.opcode;
+  assign trace_meta      = trace_data.meta;
+
+  // A forced-full trace FIFO shows as a consumer that takes nothing
+  assign trace_valid       = shell_trace_valid && !fault_fifo_full;
+  assign shell_trace_ready = trace_ready && !fault_fifo_full;
+
+  // =========================================================================
+  // Fault Injector
+  // =========================================================================
+  fault_pkg::fault_config_t fault_configs [NUM_FAULTS];
+  fault_pkg::fault_status_t fault_status;
+  logic [63:0]              order_seq;
+
+  always_comb begin
+    for (int i = 0; i < NUM_FAULTS; i++) begin
+      fault_configs[i].fault_type      = fault_pkg::fault_type_t'(fault_type[i]);
+      fault_configs[i].trigger_cycle   = fault_trigger_cycle[i];
+      fault_configs[i].duration_cycles = fault_duration[i];
+      fault_configs[i].fault_param     = fault_param[i];
+    end
+  end
+
+  fault_injector #(
+    .NUM_CONFIGS (NUM_FAULTS)
+  ) u_fault_injector (
+    .clk             (clk),
+    .rst_n           (rst_n),
+    .configs         (fault_configs),
+    .config_valid    (fault_valid),
+    .cycle_count     (cycle_counter),
+    .dn_valid_in     (shell_dn_valid),
+    .dn_valid_out    (fault_dn_valid),
+    .dn_ready_in     (risk_in_ready),
+    .dn_ready_out    (shell_dn_ready),
+    .dn_data_in      (shell_dn_data),
+    .dn_data_out     (fault_dn_data),
+    .fifo_full_in    (1'b0),
+    .fifo_full_out   (fault_fifo_full),
+    .kill_switch_in  (cmd_kill_trigger),
+    .kill_switch_out (fault_kill),
+    .seq_no_in       (order_seq[31:0]),
+    .seq_no_out      (fault_seq_no),
+    .emit_reset      (fault_emit_reset),
+    .status          (fault_status)
+  );
+
+  // The gate's in_ready does not depend on in_valid, so gating valid with
+  // the injector's ready adds no loop
+  assign risk_in_valid    = fault_dn_valid && shell_dn_ready;
+  assign fault_active     = fault_status.active;
+  assign fault_injections = fault_status.injections_count;
+
+  // =========================================================================
+  // Egress word -> order_t
+  // =========================================================================
+
+  always_ff @(posedge clk or negedge rst_n) begin
+    if (!rst_n)
+      order_seq <= '0;
+    else if (shell_dn_valid && shell_dn_ready)
+      order_seq <= order_seq + 64'd1;
+  end
+
+  logic [41:0] order_notional;
+  assign order_notional = 42'(fault_dn_data[41:21]) * 42'(fault_dn_data[20:0]);
+
+  order_t risk_in_order;
+  assign risk_in_order.order_id   = {order_seq[63:32], fault_seq_no};
+  assign risk_in_order.side       = order_side_e'(fault_dn_data[63:62]);
+  assign risk_in_order.order_type = order_type_e'(fault_dn_data[61:58]);
+  assign risk_in_order.symbol_id  = {16'd0, fault_dn_data[57:42]};
+  assign risk_in_order.quantity   = {43'd0, fault_dn_data[41:21]};
+  assign risk_in_order.price      = {43'd0, fault_dn_data[20:0]};
+  assign risk_in_order.notional   = {22'd0, order_notional};
+
+  assign shell_out_valid = shell_dn_valid;
+  assign shell_out_ready = shell_dn_ready;
+
+  // =========================================================================
+  // Risk Gate
+  // =========================================================================
+  order_t       out_order_packed;
+  risk_status_t status;
+  risk_reject_e reject_reason;
+
+  risk_gate #(
+    .DATA_WIDTH(DATA_WIDTH)
+  ) u_risk_gate (
+    .clk                    (clk),
+    .rst_n                  (rst_n),
+
+    .cfg_rate_max_tokens    (cfg_rate_max_tokens),
+    .cfg_rate_refill_rate   (cfg_rate_refill_rate),
+    .cfg_rate_refill_period (cfg_rate_refill_period),
+    .cfg_rate_enabled       (cfg_rate_enabled),
+
+    .cfg_pos_max_long       (cfg_pos_max_long),
+    .cfg_pos_max_short      (cfg_pos_max_short),
+    .cfg_pos_max_notional   (cfg_pos_max_notional),
+    .cfg_pos_max_order_qty  (cfg_pos_max_order_qty),
+    .cfg_pos_enabled        (cfg_pos_enabled),
+
+    .cfg_kill_armed         (cfg_kill_armed),
+    .cfg_kill_auto_enabled  (cfg_kill_auto_enabled),
+    .cfg_kill_loss_threshold(cfg_kill_loss_threshold),
+    .cmd_kill_trigger       (fault_kill),
+    .cmd_kill_reset         (cmd_kill_reset),
+
+    .in_valid               (risk_in_valid),
+    .in_ready               (risk_in_ready),
+    .in_data                (fault_dn_data),
+    .in_order               (risk_in_order),
+
+    .out_valid              (out_valid),
+    .out_ready              (out_ready),
+    .out_data               (out_data),
+    .out_order              (out_order_packed),
+    .out_rejected           (out_rejected),
+    .out_reject_reason      (reject_reason),
+
+    .fill_valid             (fill_valid),
+    .fill_side              (order_side_e'(fill_side)),
+    .fill_qty               (fill_qty),
+    .fill_notional          (fill_notional),
+
+    .current_pnl            ($signed(current_pnl)),
+    .pnl_is_loss            (pnl_is_loss),
+
+    .status                 (status),
+    .kill_switch_active     (kill_switch_active),
+
+    .stat_total_orders      (stat_total),
+    .stat_passed_orders     (stat_passed),
+    .stat_rejected_rate     (stat_rejected_rate),
+    .stat_rejected_position (stat_rejected_pos),
+    .stat_rejected_kill     (stat_rejected_kill)
+  );
+
+  assign out_reject_reason = reject_reason;
+  assign out_order_id      = out_order_packed.order_id;
+  assign status_tokens     = status.tokens_remaining;
+  assign status_position   = status.current_position[63:0];
+
+endmodule
@@ -0,0 +1,269 @@
+/*
+ * Live Simulator Telemetry
+ *
+ * Publishes simulator counters on a Prometheus text endpoint while a run
+ * is in progress (soak replays, long sweeps).
+ *
+ * The simulation thread copies its counters into TelemetryCounters with
+ * relaxed atomic stores every few thousand cycles; it never takes a lock
+ * and never touches the socket. A side thread snapshots those atomics
+ * every interval_ms, derives the simulation rate from the cycle delta,
+ * renders the page and serves it to whoever connects:
+ *
+ *   curl http://localhost:9464/metrics
+ *
+ * Only GET of the current page is supported (HTTP/1.0, one request per
+ * connection), which is all a Prometheus scrape needs. The endpoint has
+ * no authentication, so it listens on the loopback interface unless the
+ * caller names another IPv4 address (e.g. 0.0.0.0 for every interface).
+ */
+
+#ifndef SENTINEL_TELEMETRY_H
+#define SENTINEL_TELEMETRY_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Written by the simulation thread, read by the exporter thread
+struct TelemetryCounters {
+    std::atomic<uint64_t> cycles{0};
+    std::atomic<uint64_t> cycles_skipped{0};
+    std::atomic<uint64_t> transactions_sent{0};
+    std::atomic<uint64_t> transactions_received{0};
+    std::atomic<uint64_t> traces_collected{0};
+    std::atomic<uint64_t> trace_drops{0};
+    std::atomic<uint64_t> in_backpressure_cycles{0};
+    std::atomic<uint64_t> out_backpressure_cycles{0};
+    std::atomic<uint64_t> inflight_underflows{0};
+    std::atomic<uint32_t> trace_overflow_seen{0};
+
+    static void set(std::atomic<uint64_t>& c, uint64_t v) {
+        c.store(v, std::memory_order_relaxed);
+    }
+};
+
+class TelemetryExporter {
+public:
+    static constexpr const char* DEFAULT_HOST = "127.0.0.1";
+
+    TelemetryCounters counters;
+
+    // Optional samplers run on the exporter thread; must be thread-safe
+    // (e.g. StreamingTraceSink::queue_depth / bytes_on_disk)
+    std::function<uint32_t()> trace_queue_depth;
+    std::function<uint64_t()> trace_bytes_written;
+
+    TelemetryExporter() = default;
+
+    ~TelemetryExporter() {
+        stop();
+    }
+
+    TelemetryExporter(const TelemetryExporter&) = delete;
+    TelemetryExporter& operator=(const TelemetryExporter&) = delete;
+
+    // Listen on host:port and start the exporter thread. labels is an
+    // optional Prometheus label body (e.g. test="replay") attached to every
+    // sample.
+    bool start(uint16_t port, uint32_t interval_ms, const std::string& labels = "",
+               const std::string& host = DEFAULT_HOST) {
+        if (listen_fd >= 0) {
+            stop();
+        }
+
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+            fprintf(stderr, "Error: Invalid metrics address %s (expected an IPv4 address)\n",
+                    host.c_str());
+            return false;
+        }
+
+        listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd < 0) {
+            fprintf(stderr, "Error: Could not create metrics socket: %s\n", strerror(errno));
+            return false;
+        }
+
+        int one = 1;
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        if (::bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+            ::listen(listen_fd, 8) < 0) {
+            fprintf(stderr, "Error: Could not listen on metrics address %s:%u: %s\n",
+                    host.c_str(), port, strerror(errno));
+            ::close(listen_fd);
+            listen_fd = -1;
+            return false;
+        }
+
+        label_body = labels;
+        interval = std::chrono::milliseconds(interval_ms ? interval_ms : 1);
+        stopping.store(false, std::memory_order_relaxed);
+        exporter = std::thread(&TelemetryExporter::exporter_loop, this);
+        return true;
+    }
+
+    bool is_running() const {
+        return listen_fd >= 0;
+    }
+
+    void stop() {
+        if (listen_fd < 0) {
+            return;
+        }
+        stopping.store(true, std::memory_order_relaxed);
+        exporter.join();
+        ::close(listen_fd);
+        listen_fd = -1;
+    }
+
+private:
+    void exporter_loop() {
+        auto start_time = std::chrono::steady_clock::now();
+        auto last_sample = start_time;
+        uint64_t last_cycles = 0;
+        double rate = 0.0;
+        std::string page = render(0.0, 0.0);
+
+        // Wake at least every 100 ms so stop() is prompt
+        int poll_ms = static_cast<int>(std::min<int64_t>(interval.count(), 100));
+
+        while (!stopping.load(std::memory_order_relaxed)) {
+            pollfd pfd = {listen_fd, POLLIN, 0};
+            int ready = ::poll(&pfd, 1, poll_ms);
+
+            auto now = std::chrono::steady_clock::now();
+            if (now - last_sample >= interval) {
+                uint64_t cycles = counters.cycles.load(std::memory_order_relaxed);
+                double dt = std::chrono::duration<double>(now - last_sample).count();
+                rate = dt > 0 ? (cycles - last_cycles) / dt : 0.0;
+                last_cycles = cycles;
+                last_sample = now;
+                page = render(rate, std::chrono::duration<double>(now - start_time).count());
+            }
+
+            if (ready > 0 && (pfd.revents & POLLIN)) {
+                serve(page);
+            }
+        }
+    }
+
+    // Answer one scrape; never blocks the loop for more than 100 ms
+    void serve(const std::string& page) {
+        int fd = ::accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            return;
+        }
+
+        // Read (and ignore) the request line and headers
+        char buf[1024];
+        pollfd pfd = {fd, POLLIN, 0};
+        if (::poll(&pfd, 1, 100) > 0) {
+            ssize_t n = ::read(fd, buf, sizeof(buf));
+            (void)n;
+        }
+
+        char header[128];
+        int hlen = snprintf(header, sizeof(header),
+                            "HTTP/1.0 200 OK\r\n"
+                            "Content-Type: text/plain; version=0.0.4\r\n"
+                            "Content-Length: %zu\r\n\r\n",
+                            page.size());
+        write_all(fd, header, static_cast<size_t>(hlen));
+        write_all(fd, page.data(), page.size());
+        ::close(fd);
+    }
+
+    static void write_all(int fd, const char* p, size_t remaining) {
+        while (remaining > 0) {
+            ssize_t n = ::send(fd, p, remaining, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            p += n;
+            remaining -= static_cast<size_t>(n);
+        }
+    }
+
+    void metric(std::string& out, const char* name, const char* type,
+                const char* help, double value) const {
+        char line[256];
+        snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+        out += line;
+        if (label_body.empty()) {
+            snprintf(line, sizeof(line), "%s %.15g\n", name, value);
+        } else {
+            snprintf(line, sizeof(line), "%s{%s} %.15g\n", name, label_body.c_str(), value);
+        }
+        out += line;
+    }
+
+    std::string render(double cycles_per_sec, double uptime_s) const {
+        auto get = [](const std::atomic<uint64_t>& c) {
+            return static_cast<double>(c.load(std::memory_order_relaxed));
+        };
+
+        std::string out;
+        metric(out, "sentinel_sim_cycles_total", "counter",
+               "Simulated clock cycles", get(counters.cycles));
+        metric(out, "sentinel_sim_cycles_skipped_total", "counter",
+               "Cycles covered by fast-forward", get(counters.cycles_skipped));
+        metric(out, "sentinel_sim_cycles_per_second", "gauge",
+               "Simulation rate over the last interval", cycles_per_sec);
+        metric(out, "sentinel_sim_transactions_sent_total", "counter",
+               "Transactions accepted by the DUT", get(counters.transactions_sent));
+        metric(out, "sentinel_sim_transactions_received_total", "counter",
+               "Transactions seen at the DUT output", get(counters.transactions_received));
+        metric(out, "sentinel_sim_traces_collected_total", "counter",
+               "Trace records collected", get(counters.traces_collected));
+        metric(out, "sentinel_sim_trace_drops_total", "counter",
+               "Trace records dropped by the shell", get(counters.trace_drops));
+        metric(out, "sentinel_sim_in_backpressure_cycles_total", "counter",
+               "Cycles with input backpressure", get(counters.in_backpressure_cycles));
+        metric(out, "sentinel_sim_out_backpressure_cycles_total", "counter",
+               "Cycles with output backpressure", get(counters.out_backpressure_cycles));
+        metric(out, "sentinel_sim_inflight_underflows_total", "counter",
+               "Inflight FIFO underflows", get(counters.inflight_underflows));
+        metric(out, "sentinel_sim_trace_overflow_seen", "gauge",
+               "Trace FIFO has overflowed (sticky)",
+               counters.trace_overflow_seen.load(std::memory_order_relaxed));
+        if (trace_queue_depth) {
+            metric(out, "sentinel_sim_trace_queue_depth", "gauge",
+                   "Trace sink blocks waiting for the writer", trace_queue_depth());
+        }
+        if (trace_bytes_written) {
+            metric(out, "sentinel_sim_trace_bytes_written_total", "counter",
+                   "Trace bytes written to disk", static_cast<double>(trace_bytes_written()));
+        }
+        metric(out, "sentinel_sim_uptime_seconds", "gauge",
+               "Wall time since the exporter started", uptime_s);
+        return out;
+    }
+
+    int listen_fd = -1;
+    std::string label_body;
+    std::chrono::milliseconds interval{1000};
+    std::atomic<bool> stopping{false};
+    std::thread exporter;
+};
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Trace Stream Digest
+ *
+ * Rolling 128-bit hash of a trace record stream, so two runs can be
+ * checked for identical output without keeping either run's records
+ * (the multi-seed determinism test in sim_main.cpp).
+ *
+ * Records are hashed in blocks of block_records with BLAKE2b-128
+ * (blake2b.h); each block's hash is seeded with the previous block's, so
+ * the chain value after block b covers records [0, (b+1) * block_records)
+ * and is kept as a checkpoint. Two streams that differ first differ at
+ * the first checkpoint that disagrees, which localises the mismatch to
+ * one block at the cost of 16 bytes per block.
+ *
+ * A rerun can keep the records of a single block (keep_block()) to diff
+ * them, so full records are only held around the first mismatch.
+ */
+
+#ifndef SENTINEL_TRACE_DIGEST_H
+#define SENTINEL_TRACE_DIGEST_H
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "blake2b.h"
+
+template <typename Record>
+class TraceDigest {
+public:
+    static constexpr size_t DIGEST_BYTES = 16;
+    using Digest = std::array<uint8_t, DIGEST_BYTES>;
+
+    explicit TraceDigest(uint64_t block_records = 4096)
+        : block_records(block_records > 0 ? block_records : 1), hasher(DIGEST_BYTES) {}
+
+    // Keep the records of one block (UINT64_MAX = none)
+    void keep_block(uint64_t block) { kept_block = block; }
+
+    void add(const Record& rec) {
+        hasher.update(&rec, sizeof(rec));
+        if (count / block_records == kept_block) {
+            kept.push_back(rec);
+        }
+        if (++count % block_records == 0) {
+            Digest chain;
+            hasher.final(chain.data());
+            checkpoints.push_back(chain);
+            hasher = Blake2b(DIGEST_BYTES);
+            hasher.update(chain.data(), chain.size());
+        }
+    }
+
+    // Hash of the whole stream so far, open block included
+    Digest digest() const {
+        Digest d;
+        Blake2b tail = hasher;
+        tail.final(d.data());
+        return d;
+    }
+
+    uint64_t records() const { return count; }
+    uint64_t block_size() const { return block_records; }
+    const std::vector<Digest>& block_checkpoints() const { return checkpoints; }
+    const std::vector<Record>& kept_records() const { return kept; }
+
+    // First block whose chain value differs from other's; equal streams
+    // (or a difference only in length past the common blocks) give the
+    // block after the last common checkpoint
+    uint64_t first_differing_block(const TraceDigest& other) const {
+        size_t common = checkpoints.size() < other.checkpoints.size() ? checkpoints.size()
+                                                                      : other.checkpoints.size();
+        for (size_t b = 0; b < common; b++) {
+            if (checkpoints[b] != other.checkpoints[b]) {
+                return b;
+            }
+        }
+        return common;
+    }
+
+    bool matches(const TraceDigest& other) const {
+        return count == other.count && digest() == other.digest();
+    }
+
+    static std::string hex(const Digest& d) {
+        std::string s;
+        char byte[3];
+        for (uint8_t b : d) {
+            snprintf(byte, sizeof(byte), "%02x", b);
+            s += byte;
+        }
+        return s;
+    }
+
+private:
+    uint64_t block_records;
+    uint64_t count = 0;
+    Blake2b hasher;
+    std::vector<Digest> checkpoints;
+    uint64_t kept_block = UINT64_MAX;
+    std::vector<Record> kept;
+};
+
+#endif
@@ -0,0 +1,49 @@
+/*
+ * Trace Records
+ *
+ * Packed trace record layouts written by the shell drivers and read by the
+ * native host decoder (host/native/trace_native.cpp):
+ *
+ *   TraceRecord     32 bytes, sim_main.cpp (trace_pkg.sv); must match
+ *                   host/trace_decode.py (TRACE_FORMAT)
+ *   TraceRecordV12  64 bytes, sim_v12.cpp (trace_pkg_v12.sv); must match
+ *                   sentinel_hft/adapters/sentinel_adapter_v12.py
+ */
+
+#ifndef SENTINEL_TRACE_RECORD_H
+#define SENTINEL_TRACE_RECORD_H
+
+#include <cstdint>
+
+#pragma pack(push, 1)
+struct TraceRecord {
+    uint64_t tx_id;
+    uint64_t t_ingress;
+    uint64_t t_egress;
+    uint16_t flags;
+    uint16_t opcode;
+    uint32_t meta;
+};
+
+struct TraceRecordV12 {
+    uint8_t  version;
+    uint8_t  record_type;
+    uint16_t core_id;
+    uint32_t seq_no;
+    uint64_t t_ingress;
+    uint64_t t_egress;
+    uint64_t t_host;
+    uint16_t tx_id;
+    uint16_t flags;
+    uint8_t  reserved[12];
+    uint32_t d_ingress;
+    uint32_t d_core;
+    uint32_t d_risk;
+    uint32_t d_egress;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord must be 32 bytes");
+static_assert(sizeof(TraceRecordV12) == 64, "TraceRecordV12 must be 64 bytes");
+
+#endif
@@ -0,0 +1,290 @@
+/*
+ * Shared-Memory Trace Ring
+ *
+ * Single-producer/single-consumer ring of fixed-size trace records in a
+ * POSIX shared memory segment (--output shm://NAME). The simulator
+ * publishes records into the ring as it runs and a reader in another
+ * process (host/trace_ring.py) consumes them concurrently, with no file
+ * written or read back.
+ *
+ * Segment layout (little-endian, must match host/trace_ring.py):
+ *
+ *   0    magic "STR1", version u16, record_size u16, capacity u32
+ *        (records, a power of two), header_size u32, closed u32
+ *   64   head u64: records published, written by the producer only
+ *   128  tail u64: records consumed, written by the consumer only
+ *   192  capacity records; record i lives in slot i % capacity
+ *
+ * head and tail sit on their own cache lines and only ever grow. The
+ * producer writes a slot, then releases head; the consumer acquires
+ * head, reads the slots, then releases tail. head is published in
+ * batches (every PUBLISH_BATCH records, or at the next idle poll()) so a
+ * burst of records costs one cache line transfer rather than one each.
+ *
+ * The ring is lossless like the file sink: when it is full the producer
+ * waits for the consumer, stalling the sim rather than dropping records.
+ * A reader that never attaches or has died would stall it forever, so a
+ * wait longer than the stall timeout (--shm-timeout-ms) fails the ring:
+ * the error is reported, later records are discarded, close() returns
+ * false and unlinks the segment itself.
+ * closed is set once the last record is published; the consumer reads
+ * to head and then unlinks the segment. A stale segment of the same
+ * name is replaced at open().
+ */
+
+#ifndef SENTINEL_TRACE_RING_H
+#define SENTINEL_TRACE_RING_H
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static constexpr const char* SHM_OUTPUT_PREFIX = "shm://";
+
+// "shm://NAME" names a ring instead of a file
+inline bool is_shm_output(const std::string& output) {
+    return output.compare(0, strlen(SHM_OUTPUT_PREFIX), SHM_OUTPUT_PREFIX) == 0;
+}
+
+struct ShmRingHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t capacity;
+    uint32_t header_size;
+    std::atomic<uint32_t> closed;
+    alignas(64) std::atomic<uint64_t> head;
+    alignas(64) std::atomic<uint64_t> tail;
+};
+
+static_assert(sizeof(ShmRingHeader) == 192, "ShmRingHeader layout is shared with host/trace_ring.py");
+static_assert(offsetof(ShmRingHeader, head) == 64, "head must start the second cache line");
+static_assert(offsetof(ShmRingHeader, tail) == 128, "tail must start the third cache line");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring indices must be lock-free");
+
+template <typename Record>
+class ShmTraceRing {
+public:
+    static constexpr uint16_t VERSION = 1;
+    static constexpr uint64_t PUBLISH_BATCH = 64;
+    static constexpr uint32_t DEFAULT_STALL_TIMEOUT_MS = 10000;
+
+    ShmTraceRing() = default;
+
+    ~ShmTraceRing() {
+        close();
+    }
+
+    ShmTraceRing(const ShmTraceRing&) = delete;
+    ShmTraceRing& operator=(const ShmTraceRing&) = delete;
+
+    // Create the segment for "shm://NAME" with room for capacity records
+    // (rounded up to a power of two). A full ring that the reader does not
+    // drain for stall_timeout_ms fails the ring.
+    bool open(const std::string& output, uint32_t capacity = 1u << 16,
+              uint32_t stall_timeout_ms = DEFAULT_STALL_TIMEOUT_MS) {
+        if (hdr) {
+            close();
+        }
+        if (!is_shm_output(output) || output.size() == strlen(SHM_OUTPUT_PREFIX) ||
+            output.find('/', strlen(SHM_OUTPUT_PREFIX)) != std::string::npos) {
+            fprintf(stderr, "Error: Invalid shared memory output %s (expected shm://NAME)\n",
+                    output.c_str());
+            return false;
+        }
+
+        uint32_t slots = 1;
+        while (slots < capacity) {
+            slots <<= 1;
+        }
+
+        shm_name = "/" + output.substr(strlen(SHM_OUTPUT_PREFIX));
+        shm_unlink(shm_name.c_str());  // Stale segment from an earlier run
+        int fd = shm_open(shm_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0) {
+            fprintf(stderr, "Error: Could not create shared memory %s: %s\n",
+                    shm_name.c_str(), strerror(errno));
+            return false;
+        }
+
+        length = sizeof(ShmRingHeader) + size_t(slots) * sizeof(Record);
+        void* p = MAP_FAILED;
+        if (ftruncate(fd, static_cast<off_t>(length)) == 0) {
+            p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        int err = errno;
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            fprintf(stderr, "Error: Could not map shared memory %s: %s\n",
+                    shm_name.c_str(), strerror(err));
+            shm_unlink(shm_name.c_str());
+            return false;
+        }
+
+        hdr = static_cast<ShmRingHeader*>(p);
+        slots_base = reinterpret_cast<Record*>(static_cast<uint8_t*>(p) + sizeof(ShmRingHeader));
+        mask = slots - 1;
+        head = 0;
+        published = 0;
+        cached_tail = 0;
+        stall_count = 0;
+        stall_timeout = std::chrono::milliseconds(stall_timeout_ms);
+        failed = false;
+        depth.store(0, std::memory_order_relaxed);
+        bytes_out.store(0, std::memory_order_relaxed);
+
+        hdr->version = VERSION;
+        hdr->record_size = sizeof(Record);
+        hdr->capacity = slots;
+        hdr->header_size = sizeof(ShmRingHeader);
+        hdr->closed.store(0, std::memory_order_relaxed);
+        hdr->head.store(0, std::memory_order_relaxed);
+        hdr->tail.store(0, std::memory_order_relaxed);
+        // A reader that sees the magic sees the fields above
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(hdr->magic, "STR1", 4);
+        return true;
+    }
+
+    bool is_open() const {
+        return hdr != nullptr;
+    }
+
+    // Append one record (simulation thread only); discarded once the ring
+    // has failed
+    void push(const Record& rec) {
+        if (head - cached_tail > mask && !wait_for_space()) {
+            return;
+        }
+        slots_base[head & mask] = rec;
+        head++;
+        if (head - published >= PUBLISH_BATCH) {
+            publish();
+        }
+    }
+
+    // Publish records batched since the last publish. Called on cycles
+    // without a record, so a sparse stream still reaches the reader.
+    void poll() {
+        if (hdr && head != published) {
+            publish();
+        }
+    }
+
+    // Publish everything, mark the ring closed and unmap it. The reader
+    // unlinks the segment once it has drained it; a failed ring has no
+    // reader to do so. Returns false if the ring failed.
+    bool close() {
+        if (!hdr) {
+            return true;
+        }
+        publish();
+        hdr->closed.store(1, std::memory_order_release);
+        munmap(hdr, length);
+        hdr = nullptr;
+        if (failed) {
+            shm_unlink(shm_name.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t records() const {
+        return head;
+    }
+
+    // Records waiting for the reader, as of the last publish; safe to
+    // read from any thread
+    uint32_t queue_depth() const {
+        return depth.load(std::memory_order_relaxed);
+    }
+
+    // Bytes handed to the reader (the ring's counterpart of the file
+    // sink's bytes on disk); safe to read from any thread
+    uint64_t bytes_published() const {
+        return bytes_out.load(std::memory_order_relaxed);
+    }
+
+    // Times push() found the ring full and waited for the reader
+    uint64_t stalls() const {
+        return stall_count;
+    }
+
+    uint32_t capacity() const {
+        return mask + 1;
+    }
+
+    const std::string& name() const {
+        return shm_name;
+    }
+
+private:
+    void publish() {
+        hdr->head.store(head, std::memory_order_release);
+        published = head;
+        depth.store(static_cast<uint32_t>(head - hdr->tail.load(std::memory_order_relaxed)),
+                    std::memory_order_relaxed);
+        bytes_out.store(head * sizeof(Record), std::memory_order_relaxed);
+    }
+
+    // Full: hand the reader everything, then spin briefly before
+    // sleeping so a busy reader is not slowed by syscalls. Returns false
+    // (and fails the ring) if the reader frees no slot within the stall
+    // timeout.
+    bool wait_for_space() {
+        if (failed) {
+            return false;
+        }
+        publish();
+        stall_count++;
+        cached_tail = hdr->tail.load(std::memory_order_acquire);
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t spins = 0; head - cached_tail > mask; spins++) {
+            if (spins < 1024) {
+                std::this_thread::yield();
+            } else {
+                if (std::chrono::steady_clock::now() - start > stall_timeout) {
+                    fprintf(stderr, "Error: No reader freed space in shared memory %s for %lld ms "
+                            "(%lu records published, %lu read); discarding later traces\n",
+                            shm_name.c_str(), static_cast<long long>(stall_timeout.count()),
+                            head, cached_tail);
+                    failed = true;
+                    return false;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+            cached_tail = hdr->tail.load(std::memory_order_acquire);
+        }
+        return true;
+    }
+
+    ShmRingHeader* hdr = nullptr;
+    Record* slots_base = nullptr;
+    size_t length = 0;
+    std::string shm_name;
+    uint32_t mask = 0;
+
+    // Producer-local indices; only head is ever shared, at publish()
+    uint64_t head = 0;
+    uint64_t published = 0;
+    uint64_t cached_tail = 0;
+    uint64_t stall_count = 0;
+    std::chrono::milliseconds stall_timeout{DEFAULT_STALL_TIMEOUT_MS};
+    bool failed = false;  // Stall timeout hit; records are discarded
+
+    // Telemetry mirrors, updated at publish()
+    std::atomic<uint32_t> depth{0};
+    std::atomic<uint64_t> bytes_out{0};
+};
+
+#endif
@@ -0,0 +1,290 @@
+/*
+ * Streaming Trace Sink
+ *
+ * Bounded, double-buffered writer for fixed-size trace records. The
+ * simulation thread fills one block while a background thread writes
+ * the other with a single large write(2). Memory use is two blocks
+ * regardless of how many records pass through, and records reach the
+ * file while the simulation is still running so a reader can tail it.
+ *
+ * The producer only blocks when it fills a block before the writer has
+ * finished the previous one (disk slower than the simulator); that
+ * stalls the sim instead of growing memory.
+ *
+ * Partial blocks are handed off every flush_interval_ms so sparse
+ * replays still make progress on disk. Only whole records are ever
+ * written.
+ *
+ * By default blocks are written as raw records. An optional
+ * TraceBlockEncoder (e.g. compact_trace.h) re-encodes each block on the
+ * writer thread, so the encoding cost stays off the simulation thread.
+ */
+
+#ifndef SENTINEL_TRACE_SINK_H
+#define SENTINEL_TRACE_SINK_H
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// Encodes blocks of records into a file format. Called on the writer
+// thread only; header() before the first block, footer() at close.
+template <typename Record>
+class TraceBlockEncoder {
+public:
+    virtual ~TraceBlockEncoder() = default;
+    virtual void header(std::vector<uint8_t>& out) = 0;
+    virtual void encode(const Record* recs, size_t count, std::vector<uint8_t>& out) = 0;
+    virtual void footer(std::vector<uint8_t>& out) = 0;
+};
+
+template <typename Record, size_t BlockRecords = 4096>
+class StreamingTraceSink {
+public:
+    StreamingTraceSink() = default;
+
+    ~StreamingTraceSink() {
+        close();
+    }
+
+    StreamingTraceSink(const StreamingTraceSink&) = delete;
+    StreamingTraceSink& operator=(const StreamingTraceSink&) = delete;
+
+    // Re-encode blocks with enc (nullptr = raw records). Takes effect at
+    // the next open().
+    void set_encoder(std::unique_ptr<TraceBlockEncoder<Record>> enc) {
+        encoder = std::move(enc);
+    }
+
+    // Open (truncate) the output file and start the writer thread
+    bool open(const std::string& filename, uint32_t flush_interval_ms = 100) {
+        if (fd >= 0) {
+            close();
+        }
+
+        fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            fprintf(stderr, "Error: Could not open %s for writing: %s\n",
+                    filename.c_str(), strerror(errno));
+            return false;
+        }
+
+        path = filename;
+        flush_interval = std::chrono::milliseconds(flush_interval_ms);
+        for (auto& b : blocks) {
+            if (!b) b.reset(new Block);
+            b->count = 0;
+        }
+        active = 0;
+        pending = nullptr;
+        stopping = false;
+        write_error = 0;
+        flush_requested.store(false, std::memory_order_relaxed);
+        records_pushed = 0;
+        bytes_written.store(0, std::memory_order_relaxed);
+
+        if (encoder) {
+            encoded.clear();
+            encoder->header(encoded);
+            write_bytes(encoded.data(), encoded.size());
+        }
+
+        writer = std::thread(&StreamingTraceSink::writer_loop, this);
+        return true;
+    }
+
+    bool is_open() const {
+        return fd >= 0;
+    }
+
+    // Append one record (simulation thread only)
+    void push(const Record& rec) {
+        Block& b = *blocks[active];
+        b.records[b.count++] = rec;
+        records_pushed++;
+        if (b.count == BlockRecords ||
+            flush_requested.load(std::memory_order_relaxed)) {
+            submit();
+        }
+    }
+
+    // Hand off a partial block if the writer asked for one. Cheap enough
+    // to call every cycle; lets idle stretches reach disk without a push.
+    void poll() {
+        if (flush_requested.load(std::memory_order_relaxed) &&
+            blocks[active] && blocks[active]->count > 0) {
+            submit();
+        }
+    }
+
+    // Flush everything, stop the writer and close the file.
+    // Returns false if any write failed.
+    bool close() {
+        if (fd < 0) {
+            return true;
+        }
+
+        if (blocks[active]->count > 0) {
+            submit();
+        }
+
+        {
+            std::lock_guard<std::mutex> lk(mu);
+            stopping = true;
+        }
+        cv.notify_all();
+        writer.join();
+
+        if (encoder) {
+            encoded.clear();
+            encoder->footer(encoded);
+            write_bytes(encoded.data(), encoded.size());
+        }
+
+        ::close(fd);
+        fd = -1;
+
+        if (write_error != 0) {
+            fprintf(stderr, "Error: Trace write to %s failed: %s\n",
+                    path.c_str(), strerror(write_error));
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t records() const {
+        return records_pushed;
+    }
+
+    // Safe to read from any thread
+    uint64_t bytes_on_disk() const {
+        return bytes_written.load(std::memory_order_relaxed);
+    }
+
+    // Blocks filled but not yet written (0 or 1); safe from any thread
+    uint32_t queue_depth() const {
+        return pending_depth.load(std::memory_order_relaxed);
+    }
+
+    const std::string& filename() const {
+        return path;
+    }
+
+private:
+    struct Block {
+        Record records[BlockRecords];
+        size_t count = 0;
+    };
+
+    // Give the active block to the writer and switch to the other one.
+    // Waits only if the writer is still busy with the previous block.
+    void submit() {
+        {
+            std::unique_lock<std::mutex> lk(mu);
+            cv.wait(lk, [this] { return pending == nullptr; });
+            pending = blocks[active].get();
+            pending_depth.store(1, std::memory_order_relaxed);
+            flush_requested.store(false, std::memory_order_relaxed);
+        }
+        cv.notify_all();
+        active ^= 1;
+        blocks[active]->count = 0;
+    }
+
+    void writer_loop() {
+        std::unique_lock<std::mutex> lk(mu);
+        for (;;) {
+            bool woke = cv.wait_for(lk, flush_interval,
+                                    [this] { return pending != nullptr || stopping; });
+            if (!woke) {
+                // Idle for a full interval: ask the producer for whatever
+                // it has buffered so a tailing reader sees progress.
+                flush_requested.store(true, std::memory_order_relaxed);
+                continue;
+            }
+
+            if (pending) {
+                Block* b = pending;
+                lk.unlock();
+                write_block(*b);
+                lk.lock();
+                pending = nullptr;
+                pending_depth.store(0, std::memory_order_relaxed);
+                cv.notify_all();
+                continue;
+            }
+
+            if (stopping) {
+                break;
+            }
+        }
+    }
+
+    void write_block(const Block& b) {
+        if (encoder) {
+            encoded.clear();
+            encoder->encode(b.records, b.count, encoded);
+            write_bytes(encoded.data(), encoded.size());
+        } else {
+            write_bytes(b.records, b.count * sizeof(Record));
+        }
+    }
+
+    void write_bytes(const void* data, size_t remaining) {
+        if (write_error != 0) {
+            return;
+        }
+
+        const char* p = static_cast<const char*>(data);
+        while (remaining > 0) {
+            ssize_t n = ::write(fd, p, remaining);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                write_error = errno;
+                return;
+            }
+            p += n;
+            remaining -= static_cast<size_t>(n);
+            bytes_written.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+        }
+    }
+
+    int fd = -1;
+    std::string path;
+    std::chrono::milliseconds flush_interval{100};
+
+    std::unique_ptr<Block> blocks[2];
+
+    // Optional re-encoding; encoded is only touched by whichever thread
+    // is writing (open/close, or the writer thread in between)
+    std::unique_ptr<TraceBlockEncoder<Record>> encoder;
+    std::vector<uint8_t> encoded;
+    int active = 0;
+    uint64_t records_pushed = 0;
+
+    // Shared with the writer thread (guarded by mu)
+    std::mutex mu;
+    std::condition_variable cv;
+    Block* pending = nullptr;
+    bool stopping = false;
+    int write_error = 0;
+
+    std::atomic<bool> flush_requested{false};
+    std::atomic<uint64_t> bytes_written{0};
+    std::atomic<uint32_t> pending_depth{0};
+    std::thread writer;
+};
+
+#endif
@@ -0,0 +1,399 @@
+/*
+ * Waveform Capture
+ *
+ * Wraps the Verilator trace file so the testbenches can choose what is
+ * dumped and how much of the run is kept:
+ *
+ *   format   VCD, or FST in a FST=1 build (Verilator --trace-fst). A
+ *            model is built for one format, so it is a build option
+ *            rather than a run-time flag.
+ *   scope    Hierarchy depth and, optionally, only the scopes named
+ *            (dumpvars), e.g. TOP.tb_sentinel_shell.u_shell
+ *   window   With window_cycles set only +-N cycles around trigger
+ *            events are persisted instead of the whole run
+ *
+ * Trigger windows. The dump is written into segments of window_cycles
+ * cycles in a spool directory (default /dev/shm, so the pre-trigger
+ * history stays in memory). At most two segments exist at a time: the
+ * one being written and the one before it, which together always hold
+ * at least window_cycles of history. When nothing triggers, the older
+ * segment is deleted at each rotation. trigger() persists the previous
+ * segment (the pre-trigger history), the current one, and every segment
+ * that starts within window_cycles after the trigger. Each persisted
+ * segment is a complete waveform file named
+ *
+ *   <stem>.<first_cycle>-<end_cycle><ext>
+ *
+ * and <stem>.windows.csv lists them with the number of trigger events
+ * each one holds and the triggers that opened a window.
+ * Triggers inside an open window extend it rather than opening another;
+ * after max_windows windows further triggers are only counted.
+ *
+ * Every segment still runs the dump, so trigger mode bounds disk usage
+ * rather than dump cost; narrowing the scope is what cuts the latter.
+ * If a segment cannot be opened at a rotation, capture stops there: the
+ * error is reported, the windows already persisted are indexed and
+ * close() returns false.
+ */
+
+#ifndef SENTINEL_WAVE_CAPTURE_H
+#define SENTINEL_WAVE_CAPTURE_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <verilated.h>
+#ifdef SENTINEL_TRACE_FST
+#include <verilated_fst_c.h>
+using WaveTraceFile = VerilatedFstC;
+static constexpr const char* WAVE_EXTENSION = ".fst";
+static constexpr const char* WAVE_FORMAT = "FST";
+#else
+#include <verilated_vcd_c.h>
+using WaveTraceFile = VerilatedVcdC;
+static constexpr const char* WAVE_EXTENSION = ".vcd";
+static constexpr const char* WAVE_FORMAT = "VCD";
+#endif
+
+struct WaveOptions {
+    std::string file;                 // Waveform file, or the name stem of windows
+    int depth = 99;                   // Hierarchy levels dumped
+    std::vector<std::string> scopes;  // Only these scopes (empty = whole model)
+    uint64_t window_cycles = 0;       // Trigger window half-width (0 = whole run)
+    uint32_t max_windows = 64;        // Windows opened before triggers are ignored
+    std::string spool_dir;            // Pre-trigger segments ("" = /dev/shm or file's dir)
+};
+
+template <typename Model>
+class WaveCapture {
+public:
+    WaveCapture() = default;
+
+    ~WaveCapture() {
+        close(last_cycle);
+    }
+
+    WaveCapture(const WaveCapture&) = delete;
+    WaveCapture& operator=(const WaveCapture&) = delete;
+
+    // Attach to dut and start the first file at cycle
+    bool open(Model& dut, VerilatedContext& ctx, const WaveOptions& options, uint64_t cycle) {
+        opt = options;
+        stopped = false;
+        std::string ext = extension_of(opt.file);
+        if (ext.empty()) {
+            opt.file += WAVE_EXTENSION;
+        } else if (ext != WAVE_EXTENSION) {
+            fprintf(stderr, "Error: %s: this model writes %s waveforms (%s)%s\n",
+                    opt.file.c_str(), WAVE_FORMAT, WAVE_EXTENSION,
+                    ext == ".fst" ? ", rebuild with make FST=1 for FST" : "");
+            return false;
+        }
+        stem = opt.file.substr(0, opt.file.size() - strlen(WAVE_EXTENSION));
+
+        if (opt.window_cycles > 0) {
+            if (opt.spool_dir.empty()) {
+                struct stat st;
+                opt.spool_dir = stat("/dev/shm", &st) == 0 && S_ISDIR(st.st_mode)
+                                    ? "/dev/shm" : dir_of(opt.file);
+            }
+            spool_prefix = opt.spool_dir + "/sentinel_wave_" + std::to_string(getpid()) + "_";
+        }
+
+        ctx.traceEverOn(true);
+        tfp = new WaveTraceFile;
+        dut.trace(tfp, opt.depth);
+        for (const std::string& scope : opt.scopes) {
+            tfp->dumpvars(opt.depth, scope);
+        }
+
+        if (opt.window_cycles == 0) {
+            tfp->open(opt.file.c_str());
+            if (!tfp->isOpen()) {
+                fprintf(stderr, "Error: Could not open waveform file %s\n", opt.file.c_str());
+                delete tfp;
+                tfp = nullptr;
+                return false;
+            }
+            return true;
+        }
+        if (!open_segment(cycle)) {
+            delete tfp;
+            tfp = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    bool is_open() const {
+        return tfp != nullptr;
+    }
+
+    bool windowed() const {
+        return tfp != nullptr && opt.window_cycles > 0;
+    }
+
+    // A no-op once capture has stopped
+    void dump(uint64_t time) {
+        if (tfp) tfp->dump(time);
+    }
+
+    // Call once per cycle in window mode, after the cycle's dumps
+    void end_cycle(uint64_t cycle) {
+        last_cycle = cycle;
+        if (cycle - cur.start >= opt.window_cycles) {
+            rotate(cycle);
+        }
+    }
+
+    // Keep the waveform around cycle (window mode only)
+    void trigger(uint64_t cycle, const char* reason) {
+        trigger_count++;
+        if (!keeping || cycle > keep_until) {
+            if (window_count >= opt.max_windows) {
+                ignored_count++;
+                return;
+            }
+            window_count++;
+            openers.push_back({cycle, reason});
+        }
+        cur.events++;
+        keeping = true;
+        keep_until = std::max(keep_until, cycle + opt.window_cycles);
+        cur.keep = true;
+        if (prev.valid && !prev.kept) {
+            persist(prev);
+        }
+    }
+
+    // Finish the last file; in window mode persist what the last
+    // trigger still covers, drop the rest and write the index
+    bool close(uint64_t cycle) {
+        if (!tfp) {
+            return !stopped;
+        }
+        tfp->close();
+        bool ok = true;
+        if (opt.window_cycles > 0) {
+            ok = finish_segment(cycle);
+            if (prev.valid && !prev.kept) {
+                unlink(prev.path.c_str());
+            }
+            prev.valid = false;
+            ok = write_index() && ok;
+        }
+        delete tfp;
+        tfp = nullptr;
+        return ok;
+    }
+
+    const std::string& file() const { return opt.file; }
+    uint64_t window_cycles() const { return opt.window_cycles; }
+    uint64_t triggers_seen() const { return trigger_count; }
+    uint64_t triggers_ignored() const { return ignored_count; }
+    uint32_t windows() const { return window_count; }
+    const std::vector<std::string>& files() const { return persisted_files; }
+    std::string index_file() const { return stem + ".windows.csv"; }
+
+private:
+    struct Segment {
+        std::string path;
+        uint64_t start = 0;
+        uint64_t end = 0;
+        uint64_t events = 0; // Triggers while it was written
+        bool keep = false;   // A trigger fell inside it
+        bool kept = false;   // Already moved to its final name
+        bool valid = false;
+    };
+
+    struct Trigger {
+        uint64_t cycle;
+        const char* reason;
+    };
+
+    struct Persisted {
+        uint64_t start;
+        uint64_t end;
+        uint64_t events;
+        std::string file;
+    };
+
+    static std::string extension_of(const std::string& path) {
+        size_t slash = path.rfind('/');
+        size_t dot = path.rfind('.');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+            return "";
+        }
+        return path.substr(dot);
+    }
+
+    static std::string dir_of(const std::string& path) {
+        size_t slash = path.rfind('/');
+        return slash == std::string::npos ? "." : path.substr(0, slash);
+    }
+
+    bool open_segment(uint64_t cycle) {
+        cur = Segment();
+        cur.path = spool_prefix + std::to_string(segment_seq++) + WAVE_EXTENSION;
+        cur.start = cycle;
+        cur.keep = keeping && cycle <= keep_until;
+        cur.valid = true;
+        tfp->open(cur.path.c_str());
+        if (!tfp->isOpen()) {
+            fprintf(stderr, "Error: Could not open waveform segment %s\n", cur.path.c_str());
+            cur.valid = false;
+            return false;
+        }
+        return true;
+    }
+
+    // Close the current segment: persist it if a window covers it,
+    // otherwise keep it in the spool as pre-trigger history
+    bool finish_segment(uint64_t cycle) {
+        if (!cur.valid) {
+            return true;
+        }
+        cur.end = cycle;
+        bool ok = true;
+        if (cur.keep || (keeping && cur.start <= keep_until)) {
+            ok = persist(cur);
+        }
+        if (prev.valid && !prev.kept) {
+            unlink(prev.path.c_str());
+        }
+        prev = cur;
+        cur.valid = false;
+        return ok;
+    }
+
+    void rotate(uint64_t cycle) {
+        tfp->close();
+        finish_segment(cycle);
+        if (keeping && cycle > keep_until) {
+            keeping = false;
+        }
+        if (!open_segment(cycle)) {
+            // Nothing to dump into: stop, keeping the windows written so far
+            fprintf(stderr, "Error: Waveform capture stopped at cycle %lu\n", cycle);
+            if (prev.valid && !prev.kept) {
+                unlink(prev.path.c_str());
+            }
+            prev.valid = false;
+            write_index();
+            delete tfp;
+            tfp = nullptr;
+            stopped = true;
+        }
+    }
+
+    // Move a closed segment to its final name
+    bool persist(Segment& seg) {
+        std::string dest = stem + "." + std::to_string(seg.start) + "-" +
+                           std::to_string(seg.end) + WAVE_EXTENSION;
+        seg.kept = true;
+        if (rename(seg.path.c_str(), dest.c_str()) != 0 &&
+            (errno != EXDEV || !move_across(seg.path, dest))) {
+            fprintf(stderr, "Error: Could not write waveform window %s: %s\n",
+                    dest.c_str(), strerror(errno));
+            unlink(seg.path.c_str());
+            return false;
+        }
+        persisted_files.push_back(dest);
+        persisted.push_back({seg.start, seg.end, seg.events, dest});
+        return true;
+    }
+
+    // rename() across filesystems (spool on tmpfs, output on disk)
+    static bool move_across(const std::string& from, const std::string& to) {
+        FILE* in = fopen(from.c_str(), "rb");
+        if (!in) {
+            return false;
+        }
+        FILE* out = fopen(to.c_str(), "wb");
+        if (!out) {
+            int err = errno;
+            fclose(in);
+            errno = err;
+            return false;
+        }
+        std::vector<char> buf(1 << 20);
+        size_t n;
+        bool ok = true;
+        while ((n = fread(buf.data(), 1, buf.size(), in)) > 0) {
+            if (fwrite(buf.data(), 1, n, out) != n) {
+                ok = false;
+                break;
+            }
+        }
+        int err = errno;
+        fclose(in);
+        ok = fclose(out) == 0 && ok;
+        if (!ok) {
+            unlink(to.c_str());
+            errno = err;
+            return false;
+        }
+        unlink(from.c_str());
+        return true;
+    }
+
+    // first_cycle,end_cycle,file,events,opened_by ("reason@cycle" of the
+    // windows opened in the segment, separated by spaces)
+    bool write_index() {
+        if (persisted.empty()) {
+            return true;
+        }
+        std::string path = index_file();
+        FILE* f = fopen(path.c_str(), "w");
+        if (!f) {
+            fprintf(stderr, "Error: Could not write %s: %s\n", path.c_str(), strerror(errno));
+            return false;
+        }
+        fprintf(f, "first_cycle,end_cycle,file,events,opened_by\n");
+        std::sort(persisted.begin(), persisted.end(),
+                  [](const Persisted& a, const Persisted& b) { return a.start < b.start; });
+        for (const Persisted& p : persisted) {
+            fprintf(f, "%lu,%lu,%s,%lu,", (unsigned long)p.start, (unsigned long)p.end,
+                    p.file.c_str(), (unsigned long)p.events);
+            const char* sep = "";
+            for (const Trigger& t : openers) {
+                if (t.cycle >= p.start && t.cycle < p.end) {
+                    fprintf(f, "%s%s@%lu", sep, t.reason, (unsigned long)t.cycle);
+                    sep = " ";
+                }
+            }
+            fprintf(f, "\n");
+        }
+        return fclose(f) == 0;
+    }
+
+    WaveOptions opt;
+    WaveTraceFile* tfp = nullptr;
+    std::string stem;
+    std::string spool_prefix;
+    uint64_t segment_seq = 0;
+    uint64_t last_cycle = 0;
+    bool stopped = false;  // A rotation failed; nothing more is dumped
+
+    Segment cur;
+    Segment prev;
+    bool keeping = false;
+    uint64_t keep_until = 0;
+
+    uint64_t trigger_count = 0;
+    uint64_t ignored_count = 0;
+    uint32_t window_count = 0;
+    std::vector<Trigger> openers;    // Trigger that opened each window
+    std::vector<Persisted> persisted;
+    std::vector<std::string> persisted_files;
+};
+
+#endif
@@ -1,5 +1,6 @@
 """Pytest fixtures and configuration for H1 tests."""
 
+import json
 import os
 import sys
 import subprocess
@@ -164,3 +165,58 @@ def build_for_latency(sim_dir: Path, latency: int) -> SimulationRunner:
     runner = SimulationRunner(sim_dir, latency=latency)
     assert runner.build(), f"Failed to build for LATENCY={latency}"
     return runner
+
+
+def build_driver(sim_dir: Path, target: str, build_dir: str, exe_name: str,
+                 **make_vars) -> Path:
+    """Build a driver with `make <target>` into its own build directory.
+
+    Each driver gets its own BUILD_DIR so builds with different parameters
+    do not overwrite each other (or the shell model in obj_dir). make_vars
+    are passed as VAR=value, e.g. CORE_LATENCY=3.
+    """
+    result = subprocess.run(
+        ['make', f'BUILD_DIR=./{build_dir}',
+         *(f'{name}={value}' for name, value in make_vars.items()), target],
+        cwd=sim_dir,
+        capture_output=True,
+        text=True,
+    )
+    assert result.returncode == 0, f"Build failed:\n{result.stderr}"
+    return sim_dir / build_dir / exe_name
+
+
+@pytest.fixture
+def demo_orders(project_root: Path, tmp_path: Path) -> Path:
+    """The demo dataset as an order stimulus file, a fill after every 4th order."""
+    out = tmp_path / 'orders.bin'
+    result = subprocess.run(
+        [sys.executable, '-m', 'wind_tunnel.order_stimulus',
+         'demo/market_data.csv', '-o', str(out), '--fill-every', '4'],
+        cwd=project_root,
+        capture_output=True,
+        text=True,
+    )
+    assert result.returncode == 0, f"Conversion failed: {result.stderr}"
+    return out
+
+
+# Shell core latency of the tick-to-trade co-simulation build
+T2T_CORE_LATENCY = 3
+
+
+@pytest.fixture(scope="session")
+def t2t_exe(sim_dir: Path) -> Path:
+    """Build the tick-to-trade co-simulation once for every test that replays it."""
+    return build_driver(sim_dir, 't2t', 'obj_dir_t2t', 'Vtb_tick_to_trade',
+                        CORE_LATENCY=T2T_CORE_LATENCY)
+
+
+def run_driver(exe: Path, sim_dir: Path, *args: str) -> subprocess.CompletedProcess:
+    """Run a built driver from the sim directory."""
+    return subprocess.run([str(exe), *args], cwd=sim_dir, capture_output=True, text=True)
+
+
+def json_summary(result: subprocess.CompletedProcess) -> dict:
+    """The driver's --json summary: the first stdout line that is a JSON object."""
+    return json.loads(next(l for l in result.stdout.splitlines() if l.startswith('{')))
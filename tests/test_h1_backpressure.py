@@ -13,7 +13,7 @@ import re
 import pytest
 from pathlib import Path
 
-from conftest import SimulationRunner, build_for_latency
+from conftest import SimulationRunner, build_for_latency, json_summary
 
 
 class TestBackpressure:
@@ -168,3 +168,68 @@ class TestBackpressure:
         assert in_bp >= bp_cycles - 5, (
             f"LATENCY={latency}: Expected ~{bp_cycles} BP cycles, got {in_bp}"
         )
+
+    def test_stall_pattern_out_ready(self):
+        """Verify a periodic out_ready stall delays but never loses transactions."""
+        runner = build_for_latency(self.sim_dir, 1)
+
+        result = runner.run(
+            test_name='stall',
+            num_tx=500,
+            output_file='trace_stall_out.bin',
+            extra_args=['--out-pattern', 'periodic:20:8', '--json']
+        )
+
+        assert result.returncode == 0, f"Test failed: {result.stdout}{result.stderr}"
+        stats = json_summary(result)
+        assert stats['transactions_received'] == 500
+        assert stats['out_backpressure_cycles'] > 0
+        # Held for up to the 8 stalled cycles on top of the pipeline latency
+        lat = stats['latency_cycles']
+        assert lat['max'] > lat['min']
+        assert stats['trace_drops'] == 0
+
+    def test_stall_pattern_trace_ready_drops(self):
+        """Verify trace_ready stalls longer than the trace FIFO drop traces."""
+        runner = build_for_latency(self.sim_dir, 1)
+
+        result = runner.run(
+            test_name='stall',
+            num_tx=2000,
+            output_file='trace_stall_trace.bin',
+            seed=7,
+            extra_args=['--trace-pattern', 'markov:100:400', '--json']
+        )
+
+        assert result.returncode == 0, f"Test failed: {result.stdout}{result.stderr}"
+        stats = json_summary(result)
+        assert stats['transactions_received'] == 2000
+        assert stats['trace_drops'] > 0
+        assert stats['traces_collected'] + stats['trace_drops'] == 2000
+        assert stats['trace_drop_rate'] == pytest.approx(stats['trace_drops'] / 2000, abs=1e-6)
+        assert stats['peak_trace_fifo'] <= stats['trace_fifo_depth']
+
+    def test_stall_pattern_file(self, tmp_path: Path):
+        """Verify a scripted trace_ready pattern is applied and validated."""
+        runner = build_for_latency(self.sim_dir, 1)
+
+        script = tmp_path / 'reader.txt'
+        script.write_text("# host reader: short bursts, long pauses\nready 4\nstall 200\n")
+        result = runner.run(
+            test_name='stall',
+            num_tx=1000,
+            output_file='trace_stall_file.bin',
+            extra_args=['--trace-pattern', f'file:{script}', '--json']
+        )
+        assert result.returncode == 0, f"Test failed: {result.stdout}{result.stderr}"
+        assert json_summary(result)['trace_drops'] > 0
+
+        script.write_text("ready 4\nwait 10\n")
+        result = runner.run(
+            test_name='stall',
+            num_tx=10,
+            output_file='trace_stall_file.bin',
+            extra_args=['--trace-pattern', f'file:{script}']
+        )
+        assert result.returncode != 0
+        assert 'expected "ready N" or "stall N"' in result.stderr
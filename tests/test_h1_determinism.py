@@ -5,13 +5,15 @@ bit-identical trace output.
 
 Requirement:
 - Same input + same RNG seed = identical trace byte streams (SHA256 hash match)
+- Concurrent replicas of many seeds agree by trace digest (--seeds)
 """
 
 import hashlib
+import struct
 import pytest
 from pathlib import Path
 
-from conftest import SimulationRunner, build_for_latency
+from conftest import SimulationRunner, build_driver, build_for_latency, json_summary, run_driver
 
 
 class TestDeterminism:
@@ -59,6 +61,99 @@ class TestDeterminism:
             f"Trace hashes differ: {hash1} vs {hash2}"
         )
 
+    def test_replay_fast_forward_identical(self, tmp_path: Path):
+        """Verify idle fast-forward leaves replay traces bit-identical."""
+        runner = build_for_latency(self.sim_dir, 3)
+
+        # Bursts separated by long idle gaps
+        stimulus = tmp_path / 'sparse.bin'
+        with open(stimulus, 'wb') as f:
+            t = 0
+            for i in range(200):
+                t += 50_000 if i % 10 == 0 else 7
+                f.write(struct.pack('<QQHIxx', t, i, i & 0xFFFF, i))
+
+        hashes = []
+        for extra in ([], ['--fast-forward']):
+            trace_file = tmp_path / f'replay{len(hashes)}.bin'
+            result = runner.run(
+                test_name='replay',
+                num_tx=200,
+                output_file=str(trace_file),
+                extra_args=['--stimulus', str(stimulus), '--json'] + extra,
+            )
+            assert result.returncode == 0, f"Replay failed: {result.stdout}"
+            hashes.append(self._hash_trace_file(trace_file))
+
+        assert hashes[0] == hashes[1], (
+            f"Fast-forward changed the traces: {hashes[0]} vs {hashes[1]}"
+        )
+        assert '"cycles_skipped": 0' not in result.stdout
+
+    def test_compact_format_identical(self, tmp_path: Path):
+        """Verify --format compact decodes to the same records as raw output."""
+        runner = build_for_latency(self.sim_dir, 5)
+
+        for fmt in ('raw', 'compact'):
+            result = runner.run(
+                test_name='latency',
+                num_tx=5000,
+                output_file=str(tmp_path / f'{fmt}.bin'),
+                extra_args=['--format', fmt],
+            )
+            assert result.returncode == 0, f"{fmt} run failed: {result.stdout}"
+
+        raw = runner.load_traces(str(tmp_path / 'raw.bin'))
+        compact = runner.load_traces(str(tmp_path / 'compact.bin'))
+        assert len(raw) == 5000
+        assert compact == raw
+        assert (tmp_path / 'compact.bin').stat().st_size * 4 < (tmp_path / 'raw.bin').stat().st_size
+
+    def test_savable_warm_start_identical(self, tmp_path: Path):
+        """Verify restoring the post-reset snapshot matches a simulated reset."""
+        runner = build_for_latency(self.sim_dir, 3)
+        savable_exe = build_driver(self.sim_dir, 'all', 'obj_dir_savable', 'Vtb_sentinel_shell',
+                                   SAVABLE=1, CORE_LATENCY=3)
+        args = ('--test', 'determinism', '--num-tx', '500', '--seed', str(self.seed))
+
+        plain = tmp_path / 'plain.bin'
+        result = run_driver(runner.exe_path, self.sim_dir, *args, '--output', str(plain))
+        assert result.returncode == 0, f"Plain run failed: {result.stdout}"
+
+        savable = tmp_path / 'savable.bin'
+        result = run_driver(savable_exe, self.sim_dir, *args, '--output', str(savable))
+        assert result.returncode == 0, f"Savable run failed: {result.stdout}"
+        assert 'Warm starts: 1 restored from snapshot' in result.stdout
+        assert self._hash_trace_file(savable) == self._hash_trace_file(plain)
+
+    def test_multi_seed_replicas(self, tmp_path: Path):
+        """Verify concurrent replicas agree for every seed, whatever the worker count."""
+        runner = build_for_latency(self.sim_dir, 3)
+
+        digests = []
+        for seeds, jobs in (('8', '4'), ('2', '1')):
+            output = tmp_path / f'seeds{seeds}.bin'
+            result = runner.run(
+                test_name='determinism',
+                num_tx=10000,
+                output_file=str(output),
+                seed=self.seed,
+                extra_args=['--seeds', seeds, '--jobs', jobs, '--json'],
+            )
+            assert result.returncode == 0, f"Multi-seed run failed: {result.stdout}{result.stderr}"
+            summary = json_summary(result)
+            assert summary['seeds'] == int(seeds)
+            assert summary['replicas'] == 2 * int(seeds)
+            assert summary['mismatched_seeds'] == 0
+            assert summary['traces'] == 2 * int(seeds) * 10000
+            assert not output.exists()
+            digests.append(summary['digests'])
+
+        # One digest per seed, and a seed's digest does not depend on the
+        # other seeds or the worker count
+        assert len(set(digests[0])) == 8
+        assert digests[1] == digests[0][:2]
+
     def test_determinism_different_seeds(self):
         """Verify different seeds produce different traces."""
         runner = build_for_latency(self.sim_dir, 3)
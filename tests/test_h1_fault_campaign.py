@@ -0,0 +1,140 @@
+"""Test H1: Fault-Injection Campaign.
+
+Runs fault campaigns (sim_t2t.cpp --faults, sim/fault_campaign.h) on the
+tick-to-trade co-simulation, whose fault_injector sits between the shell
+and the risk gate.
+
+Requirements:
+- The fault-free baseline replays exactly as a plain run
+- Each fault type shows up in its own column of the trial table
+- Trials are independent: the table does not depend on --jobs
+- Malformed fault specs are rejected up front
+"""
+
+import csv
+from pathlib import Path
+
+import pytest
+
+from conftest import json_summary, run_driver
+
+
+STREAM = ['--num-orders', '20000', '--load', 'poisson:50']
+
+
+def run_campaign(exe: Path, sim_dir: Path, tmp_path: Path, trials: list,
+                 *args: str) -> tuple:
+    """Run a campaign; returns the process, its JSON summary and the table rows."""
+    spec = tmp_path / 'campaign.txt'
+    spec.write_text('# test campaign\n' + '\n'.join(trials) + '\n')
+    table = tmp_path / 'campaign.csv'
+    result = run_driver(exe, sim_dir, *STREAM, '--faults', str(spec),
+                        '--campaign-out', str(table), '--json', *args)
+    if result.returncode != 0 and not table.exists():
+        return result, None, None
+    summary = json_summary(result)
+    with open(table, newline='') as f:
+        rows = list(csv.DictReader(f))
+    return result, summary, rows
+
+
+class TestFaultCampaign:
+    """Test fault campaigns on the shell + risk gate path."""
+
+    def test_baseline_matches_replay(self, t2t_exe: Path, sim_dir: Path, tmp_path: Path):
+        """Verify the baseline is a clean replay and a late fault is reported missed."""
+        result, summary, rows = run_campaign(t2t_exe, sim_dir, tmp_path,
+                                             ['backpressure:100000000:10'])
+        assert result.returncode == 0, f"Campaign failed: {result.stdout}"
+
+        plain = run_driver(t2t_exe, sim_dir, *STREAM, '--json')
+        assert plain.returncode == 0
+        plain_summary = json_summary(plain)
+
+        baseline = rows[0]
+        assert baseline['status'] == 'ok'
+        assert int(baseline['decisions']) == int(baseline['orders']) == 20000
+        assert int(baseline['cycles']) == plain_summary['cycles']
+        assert int(baseline['p99']) == plain_summary['latency_cycles']['total']['p99']
+
+        assert rows[1]['status'] == 'missed'
+        assert int(rows[1]['injections']) == 0
+        assert summary['missed'] == 1
+        assert summary['hung'] == 0
+
+    def test_fault_effects(self, t2t_exe: Path, sim_dir: Path, tmp_path: Path):
+        """Verify each fault type is tabulated where it should be."""
+        trials = [
+            'backpressure:5000:2000',
+            'fifo_overflow:8000:2000',
+            'kill_switch:10000:0',
+            'burst:15000:100:16',
+            'reorder:18000:100:3',
+            'reset:20000:10',
+        ]
+        result, summary, rows = run_campaign(t2t_exe, sim_dir, tmp_path, trials)
+        assert result.returncode == 0, f"Campaign failed: {result.stdout}"
+        assert summary['trials'] == len(trials)
+        assert summary['hung'] == 0
+        assert len(rows) == len(trials) + 1
+
+        by_fault = {row['faults']: row for row in rows[1:]}
+        assert all(int(row['injections']) == 1 for row in by_fault.values())
+
+        # A stalled handoff queues orders but loses none
+        bp = by_fault['backpressure:5000:2000']
+        assert int(bp['p99_delta']) > 0
+        assert int(bp['max']) >= 2000
+        assert int(bp['decisions']) == 20000
+        assert int(bp['trace_drops']) == 0
+
+        # A held-off trace consumer fills the shell's trace FIFO
+        assert int(by_fault['fifo_overflow:8000:2000']['trace_drops']) > 0
+
+        # The kill switch latches: one trip, everything after it rejected
+        kill = by_fault['kill_switch:10000:0']
+        assert int(kill['kill_trips']) == 1
+        assert int(kill['kill_rejects']) > 0
+
+        # Phantom orders reach the gate only
+        burst = by_fault['burst:15000:100:16']
+        assert int(burst['decisions']) > int(burst['orders'])
+        assert int(burst['sequence_errors']) > 0
+
+        # Displaced order ids are misordered, then the stream resynchronises
+        reorder = by_fault['reorder:18000:100:3']
+        assert 0 < int(reorder['sequence_errors']) < 1000
+
+        assert int(by_fault['reset:20000:10']['reset_cycles']) == 10
+
+    def test_parallel_trials_match_serial(self, t2t_exe: Path, sim_dir: Path, tmp_path: Path):
+        """Verify the trial table does not depend on the worker count."""
+        trials = [f'clock_stretch:{1000 * k}:500:{k % 16}' for k in range(1, 13)]
+        tables = []
+        for jobs in ('1', '4'):
+            run_dir = tmp_path / f'jobs{jobs}'
+            run_dir.mkdir()
+            result, summary, rows = run_campaign(t2t_exe, sim_dir, run_dir, trials,
+                                                 '--jobs', jobs)
+            assert result.returncode == 0, f"Campaign failed: {result.stdout}"
+            assert summary['worker_threads'] == int(jobs)
+            tables.append(rows)
+        assert tables[0] == tables[1]
+
+    @pytest.mark.parametrize('spec', [
+        'backpressure:0:10',       # Cycles count from 1
+        'meltdown:100:10',         # Unknown type
+        'burst:100',               # Missing duration
+        ','.join(['reset:100:1'] * 5),  # More faults than injector configs
+    ])
+    def test_invalid_spec(self, t2t_exe: Path, sim_dir: Path, tmp_path: Path, spec: str):
+        """Verify a malformed trial fails the campaign before it runs."""
+        result, _, _ = run_campaign(t2t_exe, sim_dir, tmp_path, [spec])
+        assert result.returncode != 0
+        assert 'Error:' in result.stderr
+
+    def test_empty_campaign(self, t2t_exe: Path, sim_dir: Path, tmp_path: Path):
+        """Verify a campaign file with no trials fails instead of running the baseline alone."""
+        result, _, _ = run_campaign(t2t_exe, sim_dir, tmp_path, [])
+        assert result.returncode != 0
+        assert 'Error:' in result.stderr
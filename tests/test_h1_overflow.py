@@ -10,6 +10,7 @@ Requirements:
 - Shell never blocks the data path due to trace FIFO state
 """
 
+import csv
 import re
 import pytest
 from pathlib import Path
@@ -195,3 +196,47 @@ class TestOverflow:
 
         underflows = self._extract_counter(result.stdout, "Inflight underflows")
         assert underflows == 0, f"Unexpected inflight underflows: {underflows}"
+
+    def test_waveform_window_around_overflow(self, tmp_path: Path):
+        """Verify --trace-window keeps the waveform around the overflow only."""
+        runner = build_for_latency(self.sim_dir, 1)
+        spool = tmp_path / 'spool'
+        spool.mkdir()
+
+        result = runner.run(
+            test_name='overflow',
+            num_tx=200,
+            output_file='trace_wave_window.bin',
+            extra_args=['--trace-window', '100', '--trace-file', str(tmp_path / 'wave'),
+                        '--trace-spool', str(spool)]
+        )
+
+        assert result.returncode == 0, f"Test failed: {result.stdout}\n{result.stderr}"
+        with open(tmp_path / 'wave.windows.csv') as f:
+            rows = list(csv.DictReader(f))
+        assert rows, "No waveform window written"
+        assert rows[0]['opened_by'].startswith('overflow@')
+        first = int(rows[0]['opened_by'].split('@')[1])
+        assert int(rows[0]['first_cycle']) <= max(first - 100, 0)
+        for row in rows:
+            assert Path(row['file']).stat().st_size > 0
+        assert not list(spool.iterdir()), "Pre-trigger segments left in the spool"
+
+    def test_waveform_window_without_trigger(self, tmp_path: Path):
+        """Verify nothing is persisted when no trigger fires."""
+        runner = build_for_latency(self.sim_dir, 1)
+        spool = tmp_path / 'spool'
+        spool.mkdir()
+
+        result = runner.run(
+            test_name='latency',
+            num_tx=200,
+            output_file='trace_wave_quiet.bin',
+            extra_args=['--trace-window', '100', '--trace-file', str(tmp_path / 'wave'),
+                        '--trace-spool', str(spool)]
+        )
+
+        assert result.returncode == 0, f"Test failed: {result.stdout}\n{result.stderr}"
+        assert "0 kept" in result.stdout
+        assert not list(tmp_path.glob('wave*'))
+        assert not list(spool.iterdir())
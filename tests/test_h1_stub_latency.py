@@ -7,12 +7,19 @@ Requirements:
 - t_egress - t_ingress == LATENCY for all traces
 - tx_id strictly increasing (0, 1, 2, ...)
 - trace_drop_count == 0 (no drops under normal conditions)
+- The driver reports the CORE_LATENCY it was built with
 """
 
+import os
+import socket
+import subprocess
+import time
+import urllib.request
+
 import pytest
 from pathlib import Path
 
-from conftest import SimulationRunner, build_for_latency
+from conftest import SimulationRunner, build_for_latency, json_summary
 
 
 class TestStubLatency:
@@ -91,6 +98,172 @@ class TestStubLatency:
             f"Expected 0 trace drops, got: {result.stdout}"
         )
 
+    @pytest.mark.parametrize("latency", [1, 7])
+    def test_line_rate_burst(self, latency: int):
+        """Verify a back-to-back burst sustains 1 tx/cycle with no drops."""
+        runner = build_for_latency(self.sim_dir, latency)
+
+        num_tx = 1000
+        trace_file = f'trace_burst_{latency}.bin'
+
+        result = runner.run(
+            test_name='throughput',
+            num_tx=num_tx,
+            output_file=trace_file
+        )
+
+        assert result.returncode == 0, f"Test failed: {result.stdout}\n{result.stderr}"
+        assert "Throughput: 1.000 tx/cycle" in result.stdout, result.stdout
+        assert "Trace drops: 0" in result.stdout
+
+        traces = runner.load_traces(trace_file)
+        assert len(traces) == num_tx
+        assert all(t.latency_cycles == latency for t in traces)
+        # Back-to-back ingress: one new transaction per cycle
+        assert all(b.t_ingress - a.t_ingress == 1 for a, b in zip(traces, traces[1:]))
+
+    @pytest.mark.parametrize("latency", [1, 7])
+    def test_in_sim_quantiles(self, latency: int):
+        """Verify in-simulator quantiles match LATENCY with --stats-only."""
+        runner = build_for_latency(self.sim_dir, latency)
+        trace_file = f'trace_stats_only_{latency}.bin'
+        (self.sim_dir / trace_file).unlink(missing_ok=True)
+
+        result = runner.run(
+            test_name='latency',
+            num_tx=500,
+            output_file=trace_file,
+            extra_args=['--stats-only']
+        )
+
+        assert result.returncode == 0, f"Test failed: {result.stdout}\n{result.stderr}"
+        expected = "/".join([str(latency)] * 5)
+        assert f"Latency p50/p99/p99.9/p99.99/max: {expected} cycles" in result.stdout
+        assert not (self.sim_dir / trace_file).exists()
+
+    @pytest.mark.parametrize("latency", [2, 7])
+    def test_reports_build_parameters(self, latency: int):
+        """Verify the driver knows the RTL parameters it was built with."""
+        runner = build_for_latency(self.sim_dir, latency)
+
+        result = runner.run(
+            test_name='latency',
+            num_tx=100,
+            extra_args=['--stats-only', '--json']
+        )
+
+        assert result.returncode == 0, f"Test failed: {result.stdout}\n{result.stderr}"
+        stats = json_summary(result)
+        assert stats['core_latency'] == latency
+        assert stats['data_width'] == 64
+        assert stats['latency_cycles']['max'] == stats['core_latency']
+
+    def test_reports_sim_rate(self):
+        """Simulation rate is reported so thread counts can be compared."""
+        runner = build_for_latency(self.sim_dir, 1)
+
+        result = runner.run(test_name='latency', num_tx=200)
+
+        assert result.returncode == 0
+        assert "Model threads:" in result.stdout
+        rate_lines = [l for l in result.stdout.splitlines() if l.startswith("Sim rate:")]
+        assert len(rate_lines) == 1, f"No sim rate in output: {result.stdout}"
+        assert float(rate_lines[0].split()[2]) > 0
+
+    def test_live_metrics_endpoint(self):
+        """Counters are served in Prometheus text format while the sim runs."""
+        runner = build_for_latency(self.sim_dir, 1)
+
+        with socket.socket() as s:
+            s.bind(('127.0.0.1', 0))
+            port = s.getsockname()[1]
+
+        proc = subprocess.Popen(
+            [str(runner.exe_path), '--test', 'latency', '--num-tx', '200',
+             '--output', 'trace_metrics.bin', '--metrics-port', str(port),
+             '--metrics-interval-ms', '20', '--metrics-hold-ms', '3000'],
+            cwd=self.sim_dir, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True,
+        )
+        try:
+            metrics = {}
+            deadline = time.monotonic() + 10
+            while metrics.get('sentinel_sim_traces_collected_total') != 200.0:
+                assert time.monotonic() < deadline, f"Final counters never published: {metrics}"
+                time.sleep(0.05)
+                try:
+                    with urllib.request.urlopen(f'http://127.0.0.1:{port}/metrics', timeout=1) as r:
+                        body = r.read().decode()
+                except OSError:
+                    continue
+                metrics = {
+                    line.split('{')[0]: float(line.rsplit(' ', 1)[1])
+                    for line in body.splitlines() if line and not line.startswith('#')
+                }
+        finally:
+            out, err = proc.communicate(timeout=30)
+
+        assert proc.returncode == 0, f"Test failed: {out}\n{err}"
+        assert metrics['sentinel_sim_trace_drops_total'] == 0
+        assert metrics['sentinel_sim_cycles_total'] > 0
+        assert 'sentinel_sim_cycles_per_second' in metrics
+        assert 'sentinel_sim_trace_queue_depth' in metrics
+
+    def test_metrics_host_must_be_an_address(self):
+        """A malformed --metrics-host is rejected before the run."""
+        runner = build_for_latency(self.sim_dir, 1)
+
+        result = runner.run(test_name='latency', num_tx=10,
+                            extra_args=['--metrics-port', '9464', '--metrics-host', 'everywhere'])
+
+        assert result.returncode != 0
+        assert 'Error: Invalid metrics address everywhere' in result.stderr
+
+    def test_shm_ring_output(self):
+        """Traces published to a shared-memory ring are read while the sim runs."""
+        from trace_ring import TraceRingReader, remove_ring
+
+        runner = build_for_latency(self.sim_dir, 1)
+        output = f'shm://sentinel_h1_{os.getpid()}'
+        remove_ring(output)
+
+        # A ring much smaller than the run forces wrap-around and stalls
+        proc = subprocess.Popen(
+            [str(runner.exe_path), '--test', 'latency', '--num-tx', '5000',
+             '--output', output, '--shm-records', '64'],
+            cwd=self.sim_dir, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True,
+        )
+        try:
+            traces = TraceRingReader(output).read_all(
+                done=lambda: proc.poll() is not None, timeout=60)
+        finally:
+            out, err = proc.communicate(timeout=30)
+            remove_ring(output)
+
+        assert proc.returncode == 0, f"Test failed: {out}\n{err}"
+        assert "Published 5000 trace records" in out
+        assert [t.tx_id for t in traces] == list(range(5000))
+        assert all(t.latency_cycles == 1 for t in traces)
+
+    def test_shm_ring_without_reader(self):
+        """A full ring nobody drains fails the run instead of stalling it forever."""
+        from trace_ring import remove_ring
+
+        runner = build_for_latency(self.sim_dir, 1)
+        output = f'shm://sentinel_h1_noreader_{os.getpid()}'
+        remove_ring(output)
+
+        result = subprocess.run(
+            [str(runner.exe_path), '--test', 'latency', '--num-tx', '5000',
+             '--output', output, '--shm-records', '64', '--shm-timeout-ms', '200'],
+            cwd=self.sim_dir, capture_output=True, text=True, timeout=60,
+        )
+
+        assert result.returncode != 0
+        assert 'Error:' in result.stderr
+        assert 'Test latency: FAIL' in result.stdout
+        # The simulator unlinks a ring it gave up on
+        assert not remove_ring(output)
+
     def test_latency_consistency(self):
         """Verify all traces have identical latency (for fixed-latency core)."""
         runner = build_for_latency(self.sim_dir, 5)
@@ -165,3 +338,58 @@ class TestStubLatency:
             assert trace.t_egress >= trace.t_ingress, (
                 f"Trace {i}: t_egress ({trace.t_egress}) < t_ingress ({trace.t_ingress})"
             )
+
+    def _load_stats(self, runner: SimulationRunner, load: str, num_tx: int) -> dict:
+        """Run the open-loop load test and return its --json stats."""
+        result = runner.run(
+            test_name='load',
+            num_tx=num_tx,
+            seed=11,
+            extra_args=['--load', load, '--stats-only', '--json']
+        )
+        assert result.returncode == 0, f"Test failed: {result.stdout}\n{result.stderr}"
+        return json_summary(result)
+
+    @pytest.mark.parametrize("load", ["constant:50", "poisson:60", "mmpp:5:90:2000:200"])
+    def test_open_loop_load(self, load: str):
+        """Verify open-loop arrivals: service latency stays LATENCY, response never less."""
+        latency = 4
+        runner = build_for_latency(self.sim_dir, latency)
+        stats = self._load_stats(runner, load, 5000)
+
+        assert stats['transactions_received'] == 5000
+        assert stats['latency_cycles']['max'] == latency
+        response = stats['response_latency_cycles']
+        assert response['min'] >= latency
+        assert response['p99'] >= stats['latency_cycles']['p99']
+        # A run this short holds too few bursts for the MMPP mean to converge
+        if not load.startswith('mmpp'):
+            assert stats['achieved_load'] == pytest.approx(stats['offered_load'], rel=0.1)
+
+    def test_open_loop_overload_shows_queueing(self):
+        """Verify overload queues in the generator and inflates response latency only."""
+        latency = 4
+        runner = build_for_latency(self.sim_dir, latency)
+        stats = self._load_stats(runner, 'poisson:150', 4000)
+
+        # The shell still serves one per cycle in LATENCY cycles...
+        assert stats['latency_cycles']['max'] == latency
+        assert stats['achieved_load'] <= 1.0
+        # ...while the backlog the source accumulates shows in the response time
+        assert stats['load_queue_peak'] > 100
+        assert stats['response_latency_cycles']['p99'] > 10 * latency
+        assert stats['max_queue_wait_cycles'] > 100
+
+    def test_profile_trace_needs_profiling_build(self, tmp_path: Path):
+        """Verify a default build reports no phase profile and rejects --profile-trace."""
+        runner = build_for_latency(self.sim_dir, 1)
+        stats = self._load_stats(runner, 'constant:50', 1000)
+        assert 'phase_profile' not in stats
+
+        result = runner.run(
+            test_name='latency',
+            num_tx=10,
+            extra_args=['--profile-trace', str(tmp_path / 'profile.json')]
+        )
+        assert result.returncode != 0
+        assert "needs a profiling build" in result.stderr
@@ -0,0 +1,78 @@
+"""Test H1: Tick-to-Trade Co-Simulation.
+
+Runs the shell + risk gate co-simulation (sim/sim_t2t.cpp,
+sim/tb_tick_to_trade.sv) on one order stream.
+
+Requirements:
+- Every order the shell passes on is decided by the gate, in order
+- Latency splits into queue, shell and risk components that add up
+- The shell's trace records agree with the shell component
+- Egress back-pressure shows up as queueing, not a slower stream
+- Orders that do not fit the egress order word are rejected up front
+"""
+
+import sys
+from pathlib import Path
+
+import pytest
+
+from conftest import T2T_CORE_LATENCY as CORE_LATENCY, json_summary, run_driver
+
+
+class TestTickToTrade:
+    """Test the coupled shell and risk gate."""
+
+    def test_order_replay(self, t2t_exe: Path, sim_dir: Path, demo_orders: Path):
+        """Verify a recorded stream is decided in full with a fixed path latency."""
+        result = run_driver(t2t_exe, sim_dir, '--orders', str(demo_orders), '--max-gap', '100',
+                            '--json')
+        assert result.returncode == 0, f"Co-simulation failed: {result.stdout}"
+
+        summary = json_summary(result)
+        assert summary['orders'] == 1000
+        assert summary['fills'] == 183
+        assert summary['decisions'] == 1000
+        assert sum(summary['reasons'].values()) == 1000
+        assert summary['traces'] == 1000
+        assert summary['trace_mismatches'] == 0
+
+        # Sparse arrivals and a ready egress: nothing queues or stalls
+        lat = summary['latency_cycles']
+        assert lat['queue']['max'] == 0
+        assert lat['shell']['min'] == lat['shell']['max'] == CORE_LATENCY
+        assert lat['risk']['min'] == lat['risk']['max'] == 1
+        assert lat['total']['max'] == CORE_LATENCY + 1
+
+    def test_egress_backpressure(self, t2t_exe: Path, sim_dir: Path):
+        """Verify egress stalls reach the shell and queue the stream."""
+        result = run_driver(t2t_exe, sim_dir, '--num-orders', '20000', '--load', 'poisson:90',
+                            '--out-pattern', 'periodic:10:3', '--json')
+        assert result.returncode == 0, f"Co-simulation failed: {result.stdout}"
+
+        summary = json_summary(result)
+        assert summary['decisions'] == 20000
+        assert summary['trace_mismatches'] == 0
+        lat = summary['latency_cycles']
+        assert lat['risk']['max'] > 1
+        assert lat['shell']['max'] > CORE_LATENCY
+        assert lat['queue']['max'] > 0
+        assert lat['total']['mean'] == pytest.approx(
+            lat['queue']['mean'] + lat['shell']['mean'] + lat['risk']['mean'], abs=1e-2)
+        assert summary['cycles_per_sec'] > 0
+
+    def test_order_word_overflow(self, t2t_exe: Path, sim_dir: Path, tmp_path: Path):
+        """Verify an order wider than the egress word is rejected."""
+        sys.path.insert(0, str(Path(__file__).parent.parent))
+        from wind_tunnel.order_stimulus import ORDER_STRUCT
+
+        orders = tmp_path / 'wide.bin'
+        orders.write_bytes(ORDER_STRUCT.pack(0, 1, 10, 1 << 22, 10 << 22, 1, 0, 1, 1))
+        result = run_driver(t2t_exe, sim_dir, '--orders', str(orders))
+        assert result.returncode != 0
+        assert 'Error:' in result.stderr
+
+    def test_never_ready_egress(self, t2t_exe: Path, sim_dir: Path):
+        """Verify an egress that never drains is refused."""
+        result = run_driver(t2t_exe, sim_dir, '--out-pattern', 'stall')
+        assert result.returncode != 0
+        assert 'Error:' in result.stderr
@@ -0,0 +1,86 @@
+"""Test H1: v1.2 Attribution Driver.
+
+Verifies the Verilator driver for sentinel_shell_v12 (sim/sim_v12.cpp).
+
+Requirements:
+- One 64-byte v1.2 record per transaction, decodable by SentinelV12Adapter
+- Stage deltas never exceed the end-to-end latency
+- Core and risk deltas track the configured pipeline latencies
+- Per-stage histogram summary is reported (text and JSON)
+"""
+
+from pathlib import Path
+
+import pytest
+
+import sys
+sys.path.insert(0, str(Path(__file__).parent.parent))
+
+from conftest import build_driver, json_summary, run_driver
+from sentinel_hft.adapters.sentinel_adapter_v12 import SentinelV12Adapter, V12_SIZE
+
+
+CORE_LATENCY = 6
+RISK_LATENCY = 3
+
+
+@pytest.fixture(scope="module")
+def v12_exe(sim_dir: Path) -> Path:
+    """Build the v1.2 driver once, in its own build directory."""
+    return build_driver(sim_dir, 'v12', 'obj_dir_v12', 'Vtb_sentinel_shell_v12',
+                        V12_CORE_LATENCY=CORE_LATENCY, V12_RISK_LATENCY=RISK_LATENCY)
+
+
+class TestV12Attribution:
+    """Test the v1.2 attribution driver."""
+
+    def test_records_decode(self, v12_exe: Path, sim_dir: Path, tmp_path: Path):
+        """Verify every transaction yields one valid v1.2 record."""
+        trace_file = tmp_path / 'v12.bin'
+        result = run_driver(v12_exe, sim_dir, '--num-tx', '200', '--output', str(trace_file))
+
+        assert result.returncode == 0, f"Test failed: {result.stdout}\n{result.stderr}"
+        assert trace_file.stat().st_size == 200 * V12_SIZE
+
+        records = list(SentinelV12Adapter().iterate_file(trace_file))
+        assert len(records) == 200
+        assert [r.seq_no for r in records] == list(range(200))
+        for r in records:
+            assert r.version == 0x02
+            stage_sum = r.d_ingress + r.d_core + r.d_risk + r.d_egress
+            assert stage_sum <= r.latency_cycles
+            assert r.d_core >= CORE_LATENCY - 1
+            assert r.d_risk >= RISK_LATENCY - 1
+
+    def test_stage_summary(self, v12_exe: Path, sim_dir: Path, tmp_path: Path):
+        """Verify the per-stage histogram summary is printed."""
+        result = run_driver(v12_exe, sim_dir, '--num-tx', '50',
+                            '--output', str(tmp_path / 'v12.bin'))
+
+        assert result.returncode == 0
+        assert "=== Stage Attribution (cycles) ===" in result.stdout
+        for stage in ('ingress', 'core', 'risk', 'egress', 'overhead', 'total'):
+            assert any(line.startswith(stage) for line in result.stdout.splitlines())
+        assert "p99 bottleneck: core" in result.stdout
+
+    def test_replay_json(self, v12_exe: Path, sim_dir: Path, tmp_path: Path):
+        """Verify replay mode emits JSON stats with stage quantiles."""
+        from wind_tunnel.input_formats import InputTransaction, write_stimulus_binary
+
+        stimulus = tmp_path / 'stim.bin'
+        write_stimulus_binary(
+            [InputTransaction(timestamp_ns=i * 40, data=i, opcode=0, meta=0) for i in range(100)],
+            stimulus,
+        )
+
+        trace_file = tmp_path / 'v12_replay.bin'
+        result = run_driver(v12_exe, sim_dir, '--test', 'replay', '--stimulus', str(stimulus),
+                            '--output', str(trace_file), '--json')
+        assert result.returncode == 0, f"Replay failed: {result.stdout}\n{result.stderr}"
+
+        stats = json_summary(result)
+        assert stats['format'] == 'v1.2'
+        assert stats['traces_collected'] == 100
+        assert stats['bad_records'] == 0
+        assert stats['stages']['total']['p50'] >= CORE_LATENCY + RISK_LATENCY
+        assert stats['stages']['core']['p99'] >= stats['stages']['ingress']['p99']
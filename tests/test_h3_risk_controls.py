@@ -0,0 +1,271 @@
+"""Test H3: Risk Gate Controls.
+
+Runs the risk gate driver (sim/sim_risk.cpp) and checks its test runner.
+
+Requirements:
+- Every risk control test passes on the RTL
+- Tests run in parallel, each on its own model, with results merged
+- --filter selects tests, --shards splits the stress tests across seeds
+- Pipelined bursts sustain one order per cycle, every decision matched
+- The RTL matches the golden model (sim/risk_model.h) cycle for cycle
+- --sweep histograms reject reasons per config and matches the RTL on spot checks
+- --orders replays recorded order/fill files (wind_tunnel/order_stimulus.py)
+- The audit log drains at one decision per cycle into a verifiable hash chain
+"""
+
+import csv
+import json
+from pathlib import Path
+
+import pytest
+
+from conftest import build_driver, json_summary, run_driver
+
+
+NUM_TESTS = 14
+
+
+@pytest.fixture(scope="module")
+def risk_exe(sim_dir: Path) -> Path:
+    """Build the risk gate driver once, in its own build directory."""
+    return build_driver(sim_dir, 'risk', 'obj_dir_risk', 'Vtb_risk_gate')
+
+
+class TestRiskGate:
+    """Test the risk gate driver and its parallel runner."""
+
+    def test_all_pass(self, risk_exe: Path, sim_dir: Path):
+        """Verify every test passes and the summary merges all of them."""
+        result = run_driver(risk_exe, sim_dir, '--jobs', '4', '--json')
+        assert result.returncode == 0, f"Risk tests failed: {result.stdout}"
+
+        summary = json_summary(result)
+        assert summary['overall'] == 'PASS'
+        assert summary['tests_run'] == NUM_TESTS
+        assert summary['tests_passed'] == NUM_TESTS
+        assert summary['orders_sent'] == sum(t['orders_sent'] for t in summary['tests'])
+        assert f"Tests: {NUM_TESTS}/{NUM_TESTS} passed" in result.stdout
+
+    def test_parallel_matches_serial(self, risk_exe: Path, sim_dir: Path):
+        """Verify per-test results do not depend on the worker count."""
+        serial = json_summary(run_driver(risk_exe, sim_dir, '--jobs', '1', '--json'))
+        parallel = json_summary(run_driver(risk_exe, sim_dir, '--jobs', '8', '--json'))
+
+        def key(summary):
+            return [(t['name'], t['result'], t['cycles'], t['orders_passed'])
+                    for t in summary['tests']]
+
+        assert key(serial) == key(parallel)
+
+    def test_filter(self, risk_exe: Path, sim_dir: Path):
+        """Verify --filter selects tests by glob."""
+        result = run_driver(risk_exe, sim_dir, '--filter', 'rate_*,kill_switch', '--json')
+        assert result.returncode == 0, f"Filtered run failed: {result.stdout}"
+        names = [t['name'] for t in json_summary(result)['tests']]
+        assert names == ['rate_limit_basic', 'rate_limit_refill', 'kill_switch']
+
+        result = run_driver(risk_exe, sim_dir, '--filter', 'no_such_test')
+        assert result.returncode != 0
+
+    def test_stress_shards(self, risk_exe: Path, sim_dir: Path):
+        """Verify --shards runs one stress shard per seed."""
+        result = run_driver(risk_exe, sim_dir, '--filter', 'stress/*', '--shards', '4',
+                            '--stress-orders', '2000', '--json')
+        assert result.returncode == 0, f"Stress shards failed: {result.stdout}"
+
+        tests = json_summary(result)['tests']
+        assert [t['name'] for t in tests] == [f'stress/{k}' for k in range(4)]
+        assert all(t['orders_sent'] == 2000 for t in tests)
+        for k in range(4):
+            assert f"seed 0x{0xDEADBEEF + k:08x}" in result.stdout
+
+    def test_burst_back_to_back(self, risk_exe: Path, sim_dir: Path):
+        """Verify the gate decides one order per cycle under back-to-back load."""
+        result = run_driver(risk_exe, sim_dir, '--filter', 'stress_burst', '--json')
+        assert result.returncode == 0, f"Burst failed: {result.stdout}"
+
+        (burst,) = json_summary(result)['tests']
+        assert burst['orders_sent'] == 10000
+        assert burst['orders_passed'] + burst['orders_rejected'] == 10000
+        assert burst['orders_per_cycle'] == 1.0
+        assert burst['decision_latency_cycles']['max'] == 1
+
+    def test_burst_output_backpressure(self, risk_exe: Path, sim_dir: Path):
+        """Verify decisions still match their orders when out_ready toggles."""
+        result = run_driver(risk_exe, sim_dir, '--filter', 'stress_burst*', '--shards', '2',
+                            '--out-ready-pct', '50', '--json')
+        assert result.returncode == 0, f"Burst failed: {result.stdout}"
+
+        for burst in json_summary(result)['tests']:
+            assert burst['orders_passed'] + burst['orders_rejected'] == 10000
+            assert burst['orders_per_cycle'] < 1.0
+            assert burst['decision_latency_cycles']['max'] > 1
+
+    def test_audit_drain(self, risk_exe: Path, sim_dir: Path, tmp_path: Path):
+        """Verify the audit log drains without stalls into a chain the host verifier accepts."""
+        from sentinel_hft.audit.record import read_records
+        from sentinel_hft.audit.verifier import verify
+
+        log = tmp_path / 'audit.bin'
+        result = run_driver(risk_exe, sim_dir, '--filter', 'audit_drain', '--stress-orders', '5000',
+                            '--audit-out', str(log), '--json')
+        assert result.returncode == 0, f"Audit drain failed: {result.stdout}"
+
+        test = json_summary(result)['tests'][0]
+        assert test['audit_records'] == 5000
+        assert test['audit_ready_stalls'] == 0
+
+        records = list(read_records(log))
+        assert [r.seq_no for r in records] == list(range(5000))
+        assert sum(1 for r in records if r.passed) == test['orders_passed']
+        assert verify(records).ok
+
+    def test_golden_lockstep(self, risk_exe: Path, sim_dir: Path):
+        """Verify every test matches the golden model when run in lockstep."""
+        result = run_driver(risk_exe, sim_dir, '--golden', '--jobs', '4', '--json')
+        assert result.returncode == 0, f"Lockstep run failed: {result.stdout}"
+
+        summary = json_summary(result)
+        assert summary['tests_passed'] == NUM_TESTS
+        assert summary['lockstep_cycles'] > 0
+        assert not any('divergence' in t for t in summary['tests'])
+
+    def test_fuzz_shards(self, risk_exe: Path, sim_dir: Path):
+        """Verify randomized configs and traffic never diverge from the golden model."""
+        result = run_driver(risk_exe, sim_dir, '--filter', 'fuzz*', '--shards', '4',
+                            '--stress-orders', '20000', '--json')
+        assert result.returncode == 0, f"Fuzz failed: {result.stdout}"
+
+        tests = json_summary(result)['tests']
+        assert [t['name'] for t in tests] == [f'fuzz/{k}' for k in range(4)]
+        assert all(t['lockstep_cycles'] == 20000 for t in tests)
+
+    def test_golden_bench(self, risk_exe: Path, sim_dir: Path):
+        """Verify the standalone golden model benchmark runs."""
+        result = run_driver(risk_exe, sim_dir, '--golden-bench', '100000')
+        assert result.returncode == 0, f"Golden bench failed: {result.stdout}"
+        assert 'Golden model: 100000 cycles' in result.stdout
+        assert 'Golden rate:' in result.stdout
+
+    def test_sweep_histograms(self, risk_exe: Path, sim_dir: Path, tmp_path: Path):
+        """Verify --sweep writes one histogram per config and its spot checks match."""
+        out = tmp_path / 'sweep.csv'
+        result = run_driver(risk_exe, sim_dir,
+                            '--sweep', 'rate_max_tokens=50:200:50,pos_max_long=500:2000:500',
+                            '--sweep-cycles', '20000', '--sweep-check', '3',
+                            '--sweep-out', str(out), '--json')
+        assert result.returncode == 0, f"Sweep failed: {result.stdout}"
+
+        summary = json_summary(result)
+        assert summary['configs'] == 16
+        assert summary['spot_checks_passed'] == 3
+
+        with open(out) as f:
+            rows = list(csv.DictReader(f))
+        assert len(rows) == 16
+        reasons = ['ok', 'rate_limited', 'position', 'notional', 'order_size', 'kill_switch']
+        for row in rows:
+            assert int(row['decisions']) == summary['decisions']
+            assert sum(int(row[r]) for r in reasons) == summary['decisions']
+
+        # A tighter position limit never passes more orders
+        by_long = {}
+        for row in rows:
+            if row['rate_max_tokens'] == '200':
+                by_long[int(row['pos_max_long'])] = int(row['ok'])
+        assert [by_long[k] for k in sorted(by_long)] == sorted(by_long.values())
+
+    def test_sweep_bad_spec(self, risk_exe: Path, sim_dir: Path):
+        """Verify malformed sweep specs are rejected."""
+        for spec in ('no_such_limit=1', 'rate_max_tokens=10:5:1', 'pos_max_long=1:5'):
+            result = run_driver(risk_exe, sim_dir, '--sweep', spec)
+            assert result.returncode != 0
+            assert 'Error:' in result.stderr
+
+    def test_order_replay(self, risk_exe: Path, sim_dir: Path, demo_orders: Path):
+        """Verify a recorded order file replays with every order decided."""
+        result = run_driver(risk_exe, sim_dir, '--orders', str(demo_orders), '--max-gap', '100',
+                            '--golden', '--json')
+        assert result.returncode == 0, f"Replay failed: {result.stdout}"
+
+        summary = json_summary(result)
+        assert summary['orders'] == 1000
+        assert summary['fills'] == 183
+        assert sum(summary['reasons'].values()) == 1000
+        assert summary['lockstep_cycles'] > 0
+
+    def test_order_replay_sweep(self, risk_exe: Path, sim_dir: Path, demo_orders: Path,
+                                tmp_path: Path):
+        """Verify --sweep over a recorded order file matches the RTL."""
+        result = run_driver(risk_exe, sim_dir, '--orders', str(demo_orders), '--max-gap', '100',
+                            '--sweep', 'rate_max_tokens=1:10:1', '--sweep-check', '3',
+                            '--sweep-out', str(tmp_path / 'sweep.csv'), '--json')
+        assert result.returncode == 0, f"Sweep failed: {result.stdout}"
+
+        summary = json_summary(result)
+        assert summary['decisions'] == 1000
+        assert summary['spot_checks_passed'] == 3
+
+    def test_symbol_scaling(self, risk_exe: Path, sim_dir: Path, tmp_path: Path):
+        """Verify --symbols runs once per count and nets per-symbol books."""
+        out = tmp_path / 'symbols.csv'
+        result = run_driver(risk_exe, sim_dir, '--symbols', '1,16,256', '--zipf', '1.2',
+                            '--symbol-cycles', '20000', '--symbol-out', str(out),
+                            '--golden', '--json')
+        assert result.returncode == 0, f"Symbol scaling failed: {result.stdout}"
+
+        summary = json_summary(result)
+        runs = summary['runs']
+        assert [r['symbols'] for r in runs] == [1, 16, 256]
+        assert summary['lockstep_cycles'] >= 3 * 20000
+        for r in runs:
+            # Same draws per run, so the same orders are decided
+            assert r['orders'] == runs[0]['orders']
+            assert sum(r['reasons'].values()) == r['orders']
+            assert r['gate_position'] == r['net_position']
+            assert r['gross_position'] >= abs(r['net_position'])
+        # Skew concentrates on symbol 1, less so as the count grows
+        assert runs[0]['hot_symbol_orders'] == runs[0]['orders']
+        assert runs[2]['hot_symbol_orders'] < runs[1]['hot_symbol_orders']
+
+        rows = out.read_text().splitlines()
+        assert rows[0].startswith('symbols,symbol_id,orders,position')
+        assert len(rows) == 1 + 1 + 16 + 256
+
+    def test_symbol_scaling_bad_count(self, risk_exe: Path, sim_dir: Path):
+        """Verify --symbols rejects a zero count."""
+        result = run_driver(risk_exe, sim_dir, '--symbols', '16,0')
+        assert result.returncode != 0
+        assert "Bad symbol count" in result.stderr
+
+    def test_profile_needs_profiling_build(self, risk_exe: Path, sim_dir: Path, tmp_path: Path):
+        """Verify a default build has no phase timers and rejects --profile-trace."""
+        result = run_driver(risk_exe, sim_dir, '--filter', 'stress', '--json')
+        assert result.returncode == 0
+        assert 'phase_profile' not in json_summary(result)
+
+        result = run_driver(risk_exe, sim_dir, '--profile-trace', str(tmp_path / 'p.json'))
+        assert result.returncode != 0
+        assert "needs a profiling build" in result.stderr
+
+    def test_phase_profile(self, sim_dir: Path, tmp_path: Path):
+        """Verify a PROFILE=1 build breaks time down by phase and writes a Chrome trace."""
+        exe = build_driver(sim_dir, 'risk', 'obj_dir_risk_profile', 'Vtb_risk_gate', PROFILE=1)
+
+        trace = tmp_path / 'profile.json'
+        result = run_driver(exe, sim_dir, '--filter', 'stress,fuzz', '--jobs', '2', '--golden',
+                            '--profile-trace', str(trace), '--profile-every', '1000',
+                            '--profile-window', '100', '--json')
+        assert result.returncode == 0, f"Risk tests failed: {result.stdout}"
+
+        summary = json_summary(result)
+        phases = summary['phase_profile']
+        for phase in ('tick', 'eval', 'stimulus', 'collect', 'golden'):
+            assert phases[phase]['calls'] > 0
+        assert summary['profile_events'] > 0
+
+        events = json.loads(trace.read_text())['traceEvents']
+        spans = [e for e in events if e['ph'] == 'X']
+        assert len(spans) == summary['profile_events']
+        assert {e['tid'] for e in spans} == {1, 2}
+        assert all(e['args']['cycle'] % 1000 < 100 for e in spans)
@@ -4,6 +4,8 @@ Tests input format parsing, trace pipeline, and metrics engine.
 """
 
 import io
+import json
+import os
 import struct
 import tempfile
 from pathlib import Path
@@ -25,6 +27,22 @@ from wind_tunnel.input_formats import (
     STIMULUS_RECORD_SIZE,
 )
 
+from wind_tunnel.order_stimulus import (
+    KIND_FILL,
+    ORDER_RECORD_SIZE,
+    SIDE_BUY,
+    SIDE_SELL,
+    TYPE_CANCEL,
+    TYPE_NEW,
+    OrderStimulus,
+    detect_dialect,
+    from_transactions,
+    load_orders,
+    parse_order_binary,
+    parse_order_csv,
+    write_order_stimulus,
+)
+
 from wind_tunnel.trace_pipeline import (
     EnrichedTrace,
     ValidationResult,
@@ -40,11 +58,31 @@ from host.metrics import (
     compute_metrics,
 )
 
+from wind_tunnel.sweep import (
+    SweepConfig,
+    SweepRunner,
+    latency_stats,
+    parse_int_list,
+    synthetic_stimulus,
+    write_table,
+)
+
 from host.report import (
     ReportGenerator,
     generate_json_report,
 )
 
+from host.trace_decode import (
+    TraceRecord,
+    decode_trace,
+    decode_compact,
+    decode_compact_file_columns,
+    decode_compact_from,
+    decode_trace_file,
+    encode_compact,
+    read_compact_index,
+)
+
 
 class TestInputTransaction:
     """Test InputTransaction dataclass."""
@@ -231,6 +269,75 @@ class TestStimulusBinary:
             path.unlink()
 
 
+class TestOrderStimulus:
+    """Test risk gate order stimulus conversion."""
+
+    REPO = Path(__file__).parent.parent
+
+    def test_record_layout(self):
+        """Test the 48-byte layout matches sim/order_record.h."""
+        rec = OrderStimulus(timestamp_ns=10, kind=KIND_FILL, side=SIDE_SELL,
+                            order_type=TYPE_NEW, quantity=5, price=7, notional=35,
+                            symbol_id=3, order_id=9)
+        data = rec.to_binary()
+        assert len(data) == ORDER_RECORD_SIZE
+        assert struct.unpack('<QQQQQIBBBx', data) == (10, 9, 5, 7, 35, 3, 1, 2, 1)
+
+    def test_parse_native_csv(self):
+        """Test named and numeric codes and the notional default."""
+        csv_data = """# comment
+timestamp_ns,kind,side,type,qty,price
+100,order,buy,new,10,250
+200,fill,SELL,1,4,250
+300,0,2,cancel,0,0
+"""
+        records = list(parse_order_csv(io.StringIO(csv_data)))
+        assert len(records) == 3
+        assert records[0].notional == 2500
+        assert records[1].kind == KIND_FILL and records[1].side == SIDE_SELL
+        assert records[2].order_type == TYPE_CANCEL
+        assert [r.order_id for r in records] == [0, 1, 2]
+
+    def test_demo_dialect(self):
+        """Test demo/market_data.csv maps to one order per transaction."""
+        path = self.REPO / 'demo' / 'market_data.csv'
+        assert detect_dialect(path) == 'demo'
+
+        records = load_orders(path, price=50)
+        assert len(records) == 1000
+        assert all(r.symbol_id == 1 and r.notional == r.quantity * 50 for r in records)
+        assert {r.side for r in records} == {SIDE_BUY, SIDE_SELL}
+        assert [r.timestamp_ns for r in records] == sorted(r.timestamp_ns for r in records)
+
+    def test_wind_tunnel_dialect(self):
+        """Test buy/sell/cancel opcodes of the wind tunnel sample."""
+        path = self.REPO / 'wind_tunnel' / 'data' / 'sample_market.csv'
+        assert detect_dialect(path) == 'wind_tunnel'
+
+        records = load_orders(path)
+        assert [r.side for r in records[:3]] == [SIDE_BUY, SIDE_BUY, SIDE_SELL]
+        assert records[5].order_type == TYPE_CANCEL
+
+    def test_synthesized_fills(self):
+        """Test --fill-every adds a full fill after every Nth new order."""
+        transactions = [InputTransaction(i * 100, i, 1, 10 + i) for i in range(6)]
+        records = from_transactions(transactions, 'demo', fill_every=2, fill_delay_ns=50)
+        fills = [r for r in records if r.kind == KIND_FILL]
+        assert [(f.timestamp_ns, f.quantity) for f in fills] == [(150, 11), (350, 13), (550, 15)]
+
+        with pytest.raises(ValueError):
+            from_transactions([InputTransaction(0, 0, 7, 1)], 'demo')
+
+    def test_write_read_roundtrip(self, tmp_path):
+        """Test binary write and read roundtrip."""
+        records = [OrderStimulus(timestamp_ns=i, quantity=i, order_id=i) for i in range(5)]
+        path = tmp_path / 'orders.bin'
+        write_order_stimulus(records, path)
+        assert path.stat().st_size == 5 * ORDER_RECORD_SIZE
+        with open(path, 'rb') as f:
+            assert list(parse_order_binary(f)) == records
+
+
 class TestMetricsEngine:
     """Test MetricsEngine class."""
 
@@ -433,6 +540,576 @@ class TestTracePipeline:
         assert len(filtered) == 1
         assert filtered[0].opcode == 1
 
+    def test_follow_growing_file(self, tmp_path):
+        """Test tailing a trace file while it is still being written."""
+        from trace_decode import TraceRecord
+
+        records = [TraceRecord(i, 10 * i, 10 * i + 3, 0, 1, i).to_bytes() for i in range(3)]
+        trace_file = tmp_path / 'live.bin'
+        # Two whole records plus the head of the third
+        trace_file.write_bytes(records[0] + records[1] + records[2][:10])
+
+        calls = []
+
+        def done():
+            # First poll: writer appends the rest and is still running
+            calls.append(1)
+            if len(calls) == 1:
+                with open(trace_file, 'ab') as f:
+                    f.write(records[2][10:])
+                return False
+            return True
+
+        pipeline = TracePipeline()
+        traces = list(pipeline.follow(trace_file, done=done, poll_interval=0.0))
+
+        assert [t.tx_id for t in traces] == [0, 1, 2]
+        assert all(t.latency_cycles == 3 for t in traces)
+
+
+class TestLatencySweep:
+    """Test the parallel latency sweep runner."""
+
+    # Stand-in simulator: one trace per stimulus record, latency taken
+    # from the lat_N build directory it lives in
+    FAKE_SIM = """#!/usr/bin/env python3
+import json, struct, sys
+from pathlib import Path
+args = sys.argv[1:]
+opt = lambda k: args[args.index(k) + 1]
+lat = int(Path(sys.argv[0]).parent.name.split('_')[1])
+stim = Path(opt('--stimulus')).read_bytes()
+n = len(stim) // 24
+with open(opt('--output'), 'wb') as f:
+    for i in range(n):
+        f.write(struct.pack('<QQQHHI', i, 10 * i, 10 * i + lat, 0, 0, 0))
+print(json.dumps({'transactions_received': n, 'trace_drops': 0,
+                  'cycles_simulated': 10 * n, 'wall_time_s': 0.01,
+                  'cycles_per_sec': 1000.0 * n}))
+"""
+
+    # Simulator with the in-sim latency histogram: --stats-only skips the trace
+    FAKE_SIM_HIST = """#!/usr/bin/env python3
+import json, sys
+from pathlib import Path
+args = sys.argv[1:]
+opt = lambda k: args[args.index(k) + 1]
+lat = int(Path(sys.argv[0]).parent.name.split('_')[1])
+n = len(Path(opt('--stimulus')).read_bytes()) // 24
+if '--stats-only' not in args:
+    Path(opt('--output')).write_bytes(b'')
+q = {'min': lat, 'p50': lat, 'p99': lat, 'p999': lat + 1, 'p9999': lat + 2,
+     'max': lat + 2, 'mean': float(lat)}
+print(json.dumps({'transactions_received': n, 'traces_collected': n,
+                  'latency_cycles': q, 'trace_drops': 0, 'cycles_simulated': 10 * n,
+                  'wall_time_s': 0.01, 'cycles_per_sec': 1000.0 * n}))
+"""
+
+    def test_parse_int_list(self):
+        """Test latency range parsing."""
+        assert parse_int_list("0-3,8,2") == [0, 1, 2, 3, 8]
+        assert parse_int_list("") == []
+
+    def test_synthetic_stimulus_reproducible(self):
+        """Test synthetic workloads depend only on the seed."""
+        a = synthetic_stimulus(7, 50, 30)
+        b = synthetic_stimulus(7, 50, 30)
+        c = synthetic_stimulus(8, 50, 30)
+
+        assert [t.to_binary() for t in a] == [t.to_binary() for t in b]
+        assert [t.to_binary() for t in a] != [t.to_binary() for t in c]
+        assert all(x.timestamp_ns <= y.timestamp_ns for x, y in zip(a, a[1:]))
+
+    def test_latency_stats(self, tmp_path):
+        """Test percentile computation from a trace file."""
+        trace_file = tmp_path / 'traces.bin'
+        with open(trace_file, 'wb') as f:
+            for i in range(100):
+                f.write(struct.pack('<QQQHHI', i, 0, i + 1, 0, 0, 0))
+
+        stats = latency_stats(trace_file)
+        assert stats['count'] == 100
+        assert stats['min'] == 1
+        assert stats['p50'] == 50
+        assert stats['p99'] == 99
+        assert stats['p999'] == 100
+        assert stats['max'] == 100
+
+    def test_plan_longest_first(self, tmp_path):
+        """Test jobs cover the full product and start with the largest."""
+        runner = SweepRunner(sim_dir=tmp_path, work_dir=tmp_path / 'out')
+        stimuli = [('small', tmp_path / 's.bin', 10, None),
+                   ('large', tmp_path / 'l.bin', 1000, None)]
+        jobs = runner.plan(SweepConfig(latencies=[0, 4]), stimuli)
+
+        assert len(jobs) == 4
+        assert jobs[0].stimulus == 'large' and jobs[0].latency == 4
+        assert jobs[-1].stimulus == 'small'
+
+    def test_run_sweep(self, tmp_path):
+        """Test a sweep end to end against prebuilt simulators."""
+        runner = SweepRunner(sim_dir=tmp_path, work_dir=tmp_path / 'out')
+        for lat in (1, 3):
+            exe = runner.exe_path(lat)
+            exe.parent.mkdir(parents=True)
+            exe.write_text(self.FAKE_SIM)
+            exe.chmod(0o755)
+
+        config = SweepConfig(latencies=[1, 3], seeds=[1, 2], synthetic_tx=20, workers=2)
+        results = runner.run(config, build=False)
+
+        assert len(results) == 4
+        assert all(r.success for r in results), [r.error_message for r in results]
+        assert [(r.latency, r.seed) for r in results] == [(1, 1), (1, 2), (3, 1), (3, 2)]
+        assert all(r.traces == 20 and r.latency_p99 == r.latency for r in results)
+        # Traces are dropped once summarised unless keep_traces is set
+        assert not list((tmp_path / 'out' / 'traces').iterdir())
+
+        out = tmp_path / 'sweep.json'
+        write_table(results, out, config)
+        doc = json.loads(out.read_text())
+        assert doc['config']['latencies'] == [1, 3]
+        assert len(doc['results']) == 4
+
+    def test_same_name_stimuli(self, tmp_path):
+        """Test stimuli with the same file name in different directories do not collide."""
+        runner = SweepRunner(sim_dir=tmp_path, work_dir=tmp_path / 'out')
+        exe = runner.exe_path(2)
+        exe.parent.mkdir(parents=True)
+        exe.write_text(self.FAKE_SIM)
+        exe.chmod(0o755)
+        inputs = []
+        for name, n in (('a', 10), ('b', 30)):
+            path = tmp_path / name / 'load.csv'
+            path.parent.mkdir()
+            path.write_text('timestamp_ns,data,opcode,meta\n' +
+                            ''.join(f'{100 * i},{i},1,0\n' for i in range(n)))
+            inputs.append(path)
+
+        config = SweepConfig(latencies=[2], stimulus_files=inputs, keep_traces=True)
+        results = runner.run(config, build=False)
+
+        assert all(r.success for r in results), [r.error_message for r in results]
+        assert sorted(r.traces for r in results) == [10, 30]
+        assert len(list((tmp_path / 'out' / 'traces').iterdir())) == 2
+
+    def test_run_sweep_stats_only(self, tmp_path):
+        """Test quantiles are taken from the simulator JSON, without a trace file."""
+        runner = SweepRunner(sim_dir=tmp_path, work_dir=tmp_path / 'out')
+        exe = runner.exe_path(4)
+        exe.parent.mkdir(parents=True)
+        exe.write_text(self.FAKE_SIM_HIST)
+        exe.chmod(0o755)
+
+        results = runner.run(SweepConfig(latencies=[4], seeds=[1], synthetic_tx=20), build=False)
+
+        assert len(results) == 1 and results[0].success, results[0].error_message
+        r = results[0]
+        assert r.traces == 20
+        assert (r.latency_p50, r.latency_p99, r.latency_p999, r.latency_p9999) == (4, 4, 5, 6)
+        assert not list((tmp_path / 'out' / 'traces').iterdir())
+
+
+class TestCompactTrace:
+    """Test the compact (delta/varint) trace format decoder."""
+
+    @staticmethod
+    def make_records(n: int):
+        return [TraceRecord(tx_id=i, t_ingress=100 + 3 * i, t_egress=100 + 3 * i + 7 + (i % 5 == 0),
+                            flags=0x0002 if i == 17 else 0, opcode=i & 0xFFFF, meta=(i * 2654435761) & 0xFFFFFFFF)
+                for i in range(n)]
+
+    def test_round_trip(self):
+        """Test records survive encode/decode, including wide varints."""
+        records = self.make_records(1000)
+        records.append(TraceRecord(1000, 2**63, 2**64 - 1, 0xFFFF, 0, 0))
+        data = encode_compact(records, block_records=256)
+
+        assert decode_compact(data) == records
+        assert len(data) < 32 * len(records) / 3
+
+    def test_decode_trace_file_detects_format(self):
+        """Test the generic file decoder handles compact and raw input."""
+        records = self.make_records(50)
+        compact = list(decode_trace_file(io.BytesIO(encode_compact(records))))
+        raw = list(decode_trace_file(io.BytesIO(b''.join(r.to_bytes() for r in records))))
+        assert compact == raw == records
+
+    def test_block_index_random_access(self):
+        """Test the footer index locates blocks without a full scan."""
+        records = self.make_records(1000)
+        data = encode_compact(records, block_records=100)
+
+        index = read_compact_index(data)
+        assert [b.first_tx_id for b in index] == list(range(0, 1000, 100))
+        assert all(b.count == 100 for b in index)
+        assert decode_compact_from(data, 555) == records[555:]
+
+    def test_columns(self):
+        """Test column decode matches record decode."""
+        records = self.make_records(300)
+        cols = decode_compact_file_columns(encode_compact(records, block_records=64))
+        assert cols['t_egress'] == [r.t_egress for r in records]
+        assert cols['meta'] == [r.meta for r in records]
+
+    def test_truncated_file(self):
+        """Test a file still being written decodes up to its last whole block."""
+        records = self.make_records(1000)
+        data = encode_compact(records, block_records=100)
+        cut = read_compact_index(data)[4].offset + 10
+
+        assert read_compact_index(data[:cut]) is None
+        assert decode_compact(data[:cut]) == records[:400]
+
+
+class TestTraceArray:
+    """Test record-array access to trace files (host/trace_array.py)."""
+
+    @pytest.fixture
+    def ta(self):
+        pytest.importorskip('numpy')
+        from host import trace_array
+        return trace_array
+
+    @staticmethod
+    def write_trace(path, records):
+        path.write_bytes(b''.join(r.to_bytes() for r in records))
+        return path
+
+    def test_layout_matches_record(self, ta, tmp_path):
+        """Test the mapped fields equal the struct-decoded records."""
+        records = TestCompactTrace.make_records(200)
+        arr = ta.open_trace_array(self.write_trace(tmp_path / 't.bin', records))
+
+        assert ta.TRACE_DTYPE.itemsize == 32 and ta.TRACE_V12_DTYPE.itemsize == 64
+        assert len(arr) == 200 and not arr.flags.writeable
+        assert arr['meta'].tolist() == [r.meta for r in records]
+        assert ta.latencies(arr).tolist() == [r.latency_cycles for r in records]
+
+    def test_flags_and_gaps(self, ta, tmp_path):
+        """Test flag selection and tx_id gap detection."""
+        ids = [0, 1, 2, 5, 6, 6, 9, 4]
+        records = [TraceRecord(tx, 10 * i, 10 * i + 4, 0x0003 if tx == 5 else 0x0002 * (tx == 9), 1, 0)
+                   for i, tx in enumerate(ids)]
+        arr = ta.open_trace_array(self.write_trace(tmp_path / 't.bin', records))
+
+        assert ta.count_flags(arr, 0x0002) == 2
+        assert ta.count_flags(arr, 0x0003, match_all=True) == 1
+        assert ta.select_flags(arr, 0x0002).tolist() == [3, 6]
+        gaps = ta.find_gaps(arr)
+        assert gaps.indices.tolist() == [3, 6]
+        assert (gaps.missing, gaps.reordered) == (4, 2)
+
+    def test_v12_sequence_wrap(self, ta, tmp_path):
+        """Test v1.2 gaps follow the 32-bit seq_no across its wrap."""
+        import numpy as np
+
+        arr = np.zeros(4, dtype=ta.TRACE_V12_DTYPE)
+        arr['seq_no'] = [2**32 - 2, 2**32 - 1, 1, 2]
+        arr['t_ingress'] = 100
+        arr['t_egress'] = [104, 105, 106, 107]
+        path = tmp_path / 'v12.bin'
+        path.write_bytes(arr.tobytes())
+
+        mapped = ta.open_trace_array(path, 'v12')
+        gaps = ta.find_gaps(mapped)
+        assert gaps.indices.tolist() == [2]
+        assert (gaps.missing, gaps.reordered) == (1, 0)
+        assert ta.latencies(mapped).tolist() == [4, 5, 6, 7]
+
+    def test_torn_tail_and_compact(self, ta, tmp_path, capsys):
+        """Test a torn last record is left out and compact traces decode."""
+        records = TestCompactTrace.make_records(50)
+        torn = tmp_path / 'torn.bin'
+        torn.write_bytes(b''.join(r.to_bytes() for r in records) + b'\0' * 10)
+        assert len(ta.open_trace_array(torn)) == 50
+        assert 'Incomplete record (10 bytes)' in capsys.readouterr().err
+
+        compact = tmp_path / 'c.bin'
+        compact.write_bytes(encode_compact(records, block_records=16))
+        arr = ta.open_trace_array(compact)
+        assert arr['t_egress'].tolist() == [r.t_egress for r in records]
+
+    def test_numpy_fallback_parity(self, ta, tmp_path, monkeypatch):
+        """Test the native kernels and the numpy fallback agree."""
+        if not ta.native_available():
+            pytest.skip("native trace decoder not built (make native)")
+        records = TestCompactTrace.make_records(1000)
+        arr = ta.open_trace_array(self.write_trace(tmp_path / 't.bin', records))
+        native = (ta.latencies(arr).tolist(), ta.select_flags(arr, 0x0002).tolist(),
+                  ta.find_gaps(arr).missing)
+
+        monkeypatch.setattr(ta, '_native', None)
+        assert (ta.latencies(arr).tolist(), ta.select_flags(arr, 0x0002).tolist(),
+                ta.find_gaps(arr).missing) == native
+
+    def test_file_metrics_and_validation(self, ta, tmp_path):
+        """Test array-based metrics and validation match the record paths."""
+        from host.metrics import compute_trace_file_metrics, compute_trace_metrics
+
+        records = TestCompactTrace.make_records(300)
+        records[40] = TraceRecord(39, 500, 490, 0x0004, 1, 0)
+        path = self.write_trace(tmp_path / 't.bin', records)
+
+        assert (compute_trace_file_metrics(path).to_dict() ==
+                compute_trace_metrics([r.to_dict() for r in records]).to_dict())
+
+        pipeline = TracePipeline()
+        fast = pipeline.validate(path)
+        pipeline._record_array = lambda trace_file: None
+        slow = pipeline.validate(path)
+        assert fast.to_dict() == slow.to_dict()
+        assert (fast.errors, fast.warnings) == (slow.errors, slow.warnings)
+        assert fast.duplicate_tx_ids == 1 and fast.negative_latency == 1
+
+
+class TestTraceRing:
+    """Test the shared-memory trace ring reader (host/trace_ring.py)."""
+
+    @staticmethod
+    def make_ring(name, capacity, version=1):
+        """Create a ring segment as sim/trace_ring.h lays it out."""
+        from host.trace_ring import RING_HEADER_SIZE, SHM_DIR
+
+        path = SHM_DIR / name
+        header = struct.pack('<4sHHIII', b'STR1', version, 32, capacity, RING_HEADER_SIZE, 0)
+        path.write_bytes(header.ljust(RING_HEADER_SIZE, b'\0') + b'\0' * 32 * capacity)
+        return path
+
+    @staticmethod
+    def publish(path, records, head, capacity, closed=False):
+        """Producer side: write records from index head, then publish."""
+        with open(path, 'r+b') as f:
+            for i, r in enumerate(records):
+                f.seek(192 + ((head + i) % capacity) * 32)
+                f.write(r.to_bytes())
+            f.seek(64)
+            f.write(struct.pack('<Q', head + len(records)))
+            if closed:
+                f.seek(16)
+                f.write(struct.pack('<I', 1))
+
+    @pytest.fixture
+    def ring_name(self):
+        from host.trace_ring import SHM_DIR, remove_ring
+        if not SHM_DIR.is_dir():
+            pytest.skip("no /dev/shm")
+        name = f'sentinel_test_{os.getpid()}'
+        yield name
+        remove_ring(f'shm://{name}')
+
+    def test_wraps_and_releases_slots(self, ring_name):
+        """Test records are read across the ring end and slots are released."""
+        from host.trace_ring import TraceRingReader
+
+        path = self.make_ring(ring_name, 4)
+        records = TestCompactTrace.make_records(10)
+        reader = TraceRingReader(f'shm://{ring_name}')
+        assert reader.attach(timeout=1)
+
+        got = []
+        for head in (0, 3, 6):
+            chunk = records[head:head + 3] if head < 6 else records[6:]
+            self.publish(path, chunk, head, 4, closed=head == 6)
+            data = reader.read_available()
+            got += [decode_trace(data[i:i + 32]) for i in range(0, len(data), 32)]
+            tail = struct.unpack('<Q', path.read_bytes()[128:136])[0]
+            assert tail == head + len(chunk)
+
+        assert got == records
+        assert reader.closed
+        reader.close(drained=True)
+        assert not path.exists()
+
+    def test_follow_stops_when_closed(self, ring_name):
+        """Test follow() drains a closed ring and unlinks it."""
+        from host.trace_ring import TraceRingReader
+
+        path = self.make_ring(ring_name, 16)
+        records = TestCompactTrace.make_records(12)
+        self.publish(path, records, 0, 16, closed=True)
+
+        assert TraceRingReader(ring_name).read_all(timeout=5) == records
+        assert not path.exists()
+
+    def test_missing_ring_and_bad_layout(self, ring_name):
+        """Test a producer that never creates the ring, and a foreign layout."""
+        from host.trace_ring import TraceRingReader
+
+        assert TraceRingReader(ring_name).read_all(done=lambda: True) == []
+
+        self.make_ring(ring_name, 16, version=9)
+        with pytest.raises(ValueError, match='unsupported ring'):
+            TraceRingReader(ring_name).attach(timeout=1)
+        with pytest.raises(ValueError, match='expected shm://NAME'):
+            TraceRingReader('shm://a/b')
+
+
+class TestSimBench:
+    """Test the simulator speed benchmark (wind_tunnel/sim_bench.py)."""
+
+    SHELL_STATS = {'transactions_received': 1000, 'cycles_simulated': 6000,
+                   'wall_time_s': 0.002, 'cycles_per_sec': 3e6, 'peak_rss_kb': 4096}
+
+    def test_parse_stats_picks_json_line(self):
+        """Test the --json line is found among the human-readable output."""
+        from wind_tunnel.sim_bench import parse_stats
+
+        out = "Sentinel-HFT\nOverall: PASS\n{not json\n" + json.dumps(self.SHELL_STATS) + "\n"
+        assert parse_stats(out) == self.SHELL_STATS
+        assert parse_stats("Overall: PASS\n") is None
+
+    def test_samples_from_each_driver(self):
+        """Test rates from shell, risk gate and --symbols stats."""
+        from wind_tunnel.sim_bench import sample_from_stats
+
+        shell = sample_from_stats(self.SHELL_STATS)
+        assert shell.cycles_per_sec == pytest.approx(3e6)
+        assert shell.transactions_per_sec == pytest.approx(5e5)
+        assert shell.peak_rss_kb == 4096
+
+        risk = sample_from_stats({'orders_sent': 500, 'cycles_simulated': 1000, 'wall_time_s': 0.001})
+        assert risk.transactions_per_sec == pytest.approx(5e5)
+        assert risk.peak_rss_kb == 0
+
+        symbols = sample_from_stats({'cycles': 1000, 'peak_rss_kb': 8192, 'runs': [
+            {'orders': 300, 'fills': 100, 'wall_time_s': 0.001},
+            {'orders': 500, 'fills': 100, 'wall_time_s': 0.003}]})
+        assert symbols.cycles == 2000
+        assert symbols.cycles_per_sec == pytest.approx(5e5)
+        assert symbols.transactions_per_sec == pytest.approx(2.5e5)
+
+    def test_compare_against_baseline(self):
+        """Test slowdowns and RSS growth beyond tolerance are regressions."""
+        from wind_tunnel.sim_bench import BenchConfig, compare
+
+        config = BenchConfig(tolerance=0.10, rss_tolerance=0.25)
+        baseline = {'scenarios': {
+            'a': {'success': True, 'cycles_per_sec': 1000.0, 'peak_rss_kb': 1000},
+            'b': {'success': True, 'cycles_per_sec': 1000.0, 'peak_rss_kb': 1000},
+        }}
+        results = {
+            'a': {'success': True, 'cycles_per_sec': 950.0, 'peak_rss_kb': 1200},
+            'b': {'success': True, 'cycles_per_sec': 850.0, 'peak_rss_kb': 1300},
+            'new': {'success': True, 'cycles_per_sec': 1.0, 'peak_rss_kb': 1},
+        }
+        regressions = compare(results, baseline, config)
+        assert len(regressions) == 2
+        assert all(r.startswith('b:') for r in regressions)
+
+    def test_runs_scenario_with_warmup(self, tmp_path):
+        """Test warm-up runs are discarded and repetitions use the median."""
+        from wind_tunnel.sim_bench import BenchConfig, BenchScenario, SimBench
+
+        # Stand-in driver: being slower on every run, it shows which runs were kept
+        build = tmp_path / 'obj_dir'
+        build.mkdir()
+        driver = build / 'fake_sim'
+        driver.write_text(f"""#!{sys.executable}
+import json, sys
+from pathlib import Path
+count = Path('runs')
+n = int(count.read_text()) + 1 if count.exists() else 1
+count.write_text(str(n))
+assert sys.argv[1:] == ['--test', 'x', '--json'], sys.argv
+print('Overall: PASS')
+print(json.dumps({{'cycles_simulated': 1000, 'transactions_received': 100,
+                  'wall_time_s': 0.001 * n, 'peak_rss_kb': 100 * n}}))
+""")
+        driver.chmod(0o755)
+
+        bench = SimBench(tmp_path, tmp_path / 'work', build)
+        config = BenchConfig(repetitions=3, warmup=1, pin=False)
+        report = bench.run(config, scenarios=[BenchScenario('fake', 'fake_sim', ['--test', 'x'])])
+
+        result = report['scenarios']['fake']
+        assert result['success'], result['error_message']
+        assert result['repetitions'] == 3
+        assert result['cycles_per_sec'] == pytest.approx(1000 / 0.003)
+        assert result['peak_rss_kb'] == 400
+        assert (tmp_path / 'work' / 'runs').read_text() == '4'
+
+    def test_failing_driver_is_reported(self, tmp_path):
+        """Test a missing driver fails its scenario without stopping the run."""
+        from wind_tunnel.sim_bench import BenchConfig, BenchScenario, SimBench
+
+        bench = SimBench(tmp_path, tmp_path / 'work', tmp_path)
+        report = bench.run(BenchConfig(repetitions=1, warmup=0, pin=False),
+                           scenarios=[BenchScenario('gone', 'no_such_sim', [])])
+        assert not report['scenarios']['gone']['success']
+        assert report['scenarios']['gone']['error_message']
+
+
+class TestFifoSizing:
+    """Test the trace FIFO sizing sweep (wind_tunnel/fifo_sizing.py)."""
+
+    def _row(self, depth, trace_pattern, drops, transactions=1000):
+        from wind_tunnel.fifo_sizing import SizingResult, result_from_stats
+
+        stats = {'transactions_received': transactions, 'traces_collected': transactions - drops,
+                 'trace_drops': drops, 'peak_trace_fifo': depth, 'cycles_simulated': 5000,
+                 'latency_cycles': {'min': 4, 'p50': 5, 'p99': 12, 'max': 30}}
+        row = SizingResult(trace_fifo_depth=depth, out_pattern='ready', trace_pattern=trace_pattern)
+        row = result_from_stats(row, stats)
+        row.success = True
+        return row
+
+    def test_result_from_stall_stats(self):
+        """Test drop rate and latency inflation come from the stall test stats."""
+        row = self._row(32, 'markov:100:50', drops=25)
+        assert row.drop_rate == pytest.approx(0.025)
+        assert row.traces == 975
+        assert row.p99_inflation == 8
+        assert row.max_inflation == 26
+
+    def test_recommends_smallest_depth_meeting_target(self):
+        """Test the recommendation per pattern pair, and none when no depth is enough."""
+        from wind_tunnel.fifo_sizing import recommend
+
+        results = [
+            self._row(16, 'markov:100:50', drops=40),
+            self._row(32, 'markov:100:50', drops=1),
+            self._row(64, 'markov:100:50', drops=0),
+            self._row(16, 'stall', drops=900),
+            self._row(64, 'stall', drops=800),
+        ]
+        failed = self._row(8, 'markov:100:50', drops=0)
+        failed.success = False
+        results.append(failed)
+
+        best = recommend(results, target_drop_rate=0.001)
+        assert best[('ready', 'markov:100:50')] == 32
+        assert best[('ready', 'stall')] is None
+
+
+class TestLoadCurve:
+    """Test the latency vs offered load curve (wind_tunnel/load_curve.py)."""
+
+    def test_load_specs(self):
+        """Test each arrival model becomes the simulator's --load spec."""
+        from wind_tunnel.load_curve import CurveConfig, load_spec
+
+        assert load_spec(CurveConfig(model='poisson'), 90) == 'poisson:90'
+        assert load_spec(CurveConfig(model='constant'), 37.5) == 'constant:37.5'
+        mmpp = CurveConfig(model='mmpp', burst_pct=150, burst_cycles=200, idle_cycles=2000)
+        assert load_spec(mmpp, 5) == 'mmpp:5:150:2000:200'
+        with pytest.raises(ValueError):
+            load_spec(CurveConfig(model='pareto'), 50)
+
+    def test_point_keeps_service_and_response_apart(self):
+        """Test both latency distributions and the generator queue are recorded."""
+        from wind_tunnel.load_curve import CurvePoint, point_from_stats
+
+        stats = {'offered_load': 0.95, 'achieved_load': 0.94, 'transactions_received': 1000,
+                 'load_queue_peak': 40, 'max_queue_wait_cycles': 39,
+                 'latency_cycles': {'p50': 4, 'p99': 4, 'p999': 4, 'max': 4},
+                 'response_latency_cycles': {'p50': 12, 'p99': 41, 'p999': 43, 'max': 43}}
+        point = point_from_stats(CurvePoint(load='poisson:95'), stats)
+        assert point.service_p99 == 4
+        assert point.response_p99 == 41
+        assert point.queue_peak == 40
+        assert point.achieved_load == pytest.approx(0.94)
+
 
 class TestSampleDataFile:
     """Test the sample market data file."""
@@ -9,6 +9,14 @@ from .input_formats import (
     write_stimulus_binary,
 )
 
+from .order_stimulus import (
+    OrderStimulus,
+    parse_order_csv,
+    from_transactions,
+    load_orders,
+    write_order_stimulus,
+)
+
 from .trace_pipeline import (
     EnrichedTrace,
     ValidationResult,
@@ -22,6 +30,14 @@ from .replay_runner import (
     run_replay,
 )
 
+from .sweep import (
+    SweepConfig,
+    SweepJob,
+    SweepResult,
+    SweepRunner,
+    write_table,
+)
+
 __all__ = [
     # Input formats
     'InputTransaction',
@@ -30,6 +46,12 @@ __all__ = [
     'detect_format',
     'load_input',
     'write_stimulus_binary',
+    # Risk gate order stimulus
+    'OrderStimulus',
+    'parse_order_csv',
+    'from_transactions',
+    'load_orders',
+    'write_order_stimulus',
     # Trace pipeline
     'EnrichedTrace',
     'ValidationResult',
@@ -39,4 +61,10 @@ __all__ = [
     'ReplayResult',
     'ReplayRunner',
     'run_replay',
+    # Latency sweep
+    'SweepConfig',
+    'SweepJob',
+    'SweepResult',
+    'SweepRunner',
+    'write_table',
 ]
@@ -0,0 +1,379 @@
+#!/usr/bin/env python3
+"""Trace FIFO sizing sweep for Sentinel-HFT Wind Tunnel.
+
+Answers "how deep does the trace FIFO need to be?" from data. The shell
+is built at each TRACE_FIFO_DEPTH (a build parameter of sentinel_shell /
+sync_fifo, so one model per depth, like the latency sweep), then the
+stall test drives the same workload through every build with the
+consumer patterns under study (see sim/stall_pattern.h):
+
+    --trace-pattern markov:2000:300     host reader with ~3 us pauses
+    --out-pattern periodic:64:8         egress credit stalls
+
+Each (depth, out pattern, trace pattern) run reports the trace drop rate
+and how far the stalls inflate latency over the unstalled pipeline
+latency. The recommendation for a pattern pair is the smallest depth
+whose drop rate meets the target.
+
+Usage:
+    python -m wind_tunnel.fifo_sizing --depths 8,16,32,64,128 \\
+        --trace-pattern markov:2000:300 --trace-pattern periodic:1000:200 \\
+        --target-drop-rate 0.001
+"""
+
+import json
+import os
+import subprocess
+import time
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass, field, asdict
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+from .input_formats import STIMULUS_RECORD_SIZE, detect_format, load_input, write_stimulus_binary
+from .sim_bench import parse_stats
+from .sweep import SIM_TOP, parse_int_list, synthetic_stimulus
+
+
+@dataclass
+class SizingConfig:
+    """Configuration for a FIFO sizing sweep."""
+    depths: List[int] = field(default_factory=lambda: [8, 16, 32, 64, 128])
+    out_patterns: List[str] = field(default_factory=lambda: ['ready'])
+    trace_patterns: List[str] = field(default_factory=lambda: ['markov:2000:300'])
+
+    # Workload: a stimulus file, or a synthetic one
+    stimulus_file: Optional[Path] = None
+    synthetic_tx: int = 100000
+    synthetic_gap_ns: int = 30
+    seed: int = 1
+
+    # Fixed build parameters
+    core_latency: int = 1
+    inflight_depth: int = 16
+
+    clock_period_ns: float = 10.0
+    target_drop_rate: float = 0.001
+    timeout_s: float = 600.0
+    build_jobs: Optional[int] = None
+
+    def to_dict(self) -> dict:
+        """Convert to dictionary for serialization."""
+        d = asdict(self)
+        d['stimulus_file'] = str(self.stimulus_file) if self.stimulus_file else None
+        return d
+
+
+@dataclass
+class SizingResult:
+    """Result row for one (depth, out pattern, trace pattern) run."""
+    trace_fifo_depth: int
+    out_pattern: str
+    trace_pattern: str
+    success: bool = False
+
+    transactions: int = 0
+    traces: int = 0
+    trace_drops: int = 0
+    drop_rate: float = 0.0
+    peak_trace_fifo: int = 0
+    peak_inflight: int = 0
+    cycles: int = 0
+
+    # Latency (cycles) and inflation over the fastest transaction
+    latency_min: int = 0
+    latency_p50: int = 0
+    latency_p99: int = 0
+    latency_max: int = 0
+    p99_inflation: int = 0
+    max_inflation: int = 0
+
+    error_message: str = ""
+
+    def to_dict(self) -> dict:
+        """Convert to dictionary for serialization."""
+        return asdict(self)
+
+
+def result_from_stats(result: SizingResult, stats: dict) -> SizingResult:
+    """Fill a result row from the stall test's --json stats."""
+    result.transactions = stats.get('transactions_received', 0)
+    result.traces = stats.get('traces_collected', 0)
+    result.trace_drops = stats.get('trace_drops', 0)
+    result.drop_rate = stats.get('trace_drop_rate',
+                                 result.trace_drops / result.transactions
+                                 if result.transactions else 0.0)
+    result.peak_trace_fifo = stats.get('peak_trace_fifo', 0)
+    result.peak_inflight = stats.get('peak_inflight', 0)
+    result.cycles = stats.get('cycles_simulated', 0)
+
+    lat = stats.get('latency_cycles')
+    if lat:
+        result.latency_min = lat['min']
+        result.latency_p50 = lat['p50']
+        result.latency_p99 = lat['p99']
+        result.latency_max = lat['max']
+        result.p99_inflation = lat['p99'] - lat['min']
+        result.max_inflation = lat['max'] - lat['min']
+    return result
+
+
+def recommend(results: List[SizingResult],
+              target_drop_rate: float) -> Dict[Tuple[str, str], Optional[int]]:
+    """Smallest depth meeting the drop-rate target, per pattern pair.
+
+    Args:
+        results: Result rows of a sweep
+        target_drop_rate: Highest acceptable trace drop rate (0.001 = 0.1%)
+
+    Returns:
+        {(out_pattern, trace_pattern): depth}, None where no swept depth
+        meets the target
+    """
+    best: Dict[Tuple[str, str], Optional[int]] = {}
+    for r in results:
+        key = (r.out_pattern, r.trace_pattern)
+        best.setdefault(key, None)
+        if r.success and r.drop_rate <= target_drop_rate:
+            if best[key] is None or r.trace_fifo_depth < best[key]:
+                best[key] = r.trace_fifo_depth
+    return best
+
+
+class FifoSizer:
+    """Build one shell per trace FIFO depth and run the stall test on each."""
+
+    def __init__(self, sim_dir: Path, work_dir: Path):
+        """Initialize sizing sweep.
+
+        Args:
+            sim_dir: Path to simulation directory (contains Makefile)
+            work_dir: Directory for builds and stimuli
+        """
+        self.sim_dir = Path(sim_dir).resolve()
+        self.work_dir = Path(work_dir).resolve()
+        self.build_root = self.work_dir / 'builds'
+
+    def build_dir(self, depth: int, config: SizingConfig) -> Path:
+        """Build directory for one depth (and the fixed parameters)."""
+        return self.build_root / (f'fifo_{depth}_inf{config.inflight_depth}'
+                                  f'_lat{config.core_latency}')
+
+    def exe_path(self, depth: int, config: SizingConfig) -> Path:
+        """Simulator executable for one depth."""
+        return self.build_dir(depth, config) / SIM_TOP
+
+    def build(self, depth: int, config: SizingConfig) -> Tuple[bool, str]:
+        """Build the shell with TRACE_FIFO_DEPTH=depth.
+
+        Returns:
+            (success, build stderr)
+        """
+        args = ['make', f'BUILD_DIR={self.build_dir(depth, config)}',
+                f'TRACE_FIFO_DEPTH={depth}', f'INFLIGHT_DEPTH={config.inflight_depth}',
+                f'CORE_LATENCY={config.core_latency}', 'all']
+        result = subprocess.run(args, cwd=self.sim_dir, capture_output=True, text=True)
+        ok = result.returncode == 0 and self.exe_path(depth, config).exists()
+        return ok, result.stderr
+
+    def build_all(self, config: SizingConfig) -> List[int]:
+        """Build every depth concurrently.
+
+        Returns:
+            Depths whose build failed
+        """
+        self.build_root.mkdir(parents=True, exist_ok=True)
+        jobs = config.build_jobs or os.cpu_count() or 1
+
+        failed = []
+        with ThreadPoolExecutor(max_workers=jobs) as pool:
+            builds = {d: pool.submit(self.build, d, config) for d in config.depths}
+            for depth, fut in builds.items():
+                ok, stderr = fut.result()
+                if not ok:
+                    print(f"Build failed for TRACE_FIFO_DEPTH={depth}:\n{stderr}")
+                    failed.append(depth)
+        return failed
+
+    def prepare_stimulus(self, config: SizingConfig) -> Tuple[Path, int]:
+        """Binary stimulus shared by every run.
+
+        Returns:
+            (binary path, transaction count)
+        """
+        if config.stimulus_file is not None:
+            path = Path(config.stimulus_file)
+            if detect_format(path) == 'binary':
+                return path.resolve(), path.stat().st_size // STIMULUS_RECORD_SIZE
+            transactions = load_input(path)
+            bin_path = self.work_dir / f'{path.stem}.bin'
+        else:
+            transactions = synthetic_stimulus(config.seed, config.synthetic_tx,
+                                              config.synthetic_gap_ns)
+            bin_path = self.work_dir / f'synthetic_{config.seed}.bin'
+        write_stimulus_binary(transactions, bin_path)
+        return bin_path, len(transactions)
+
+    def run_case(self, depth: int, out_pattern: str, trace_pattern: str,
+                 stimulus: Path, config: SizingConfig) -> SizingResult:
+        """Run the stall test on one build with one pattern pair."""
+        result = SizingResult(trace_fifo_depth=depth, out_pattern=out_pattern,
+                              trace_pattern=trace_pattern)
+        args = [
+            str(self.exe_path(depth, config)),
+            '--test', 'stall',
+            '--stimulus', str(stimulus),
+            '--out-pattern', out_pattern,
+            '--trace-pattern', trace_pattern,
+            '--seed', str(config.seed),
+            '--clock-ns', str(config.clock_period_ns),
+            '--fast-forward',
+            '--stats-only',
+            '--json',
+        ]
+        try:
+            sim = subprocess.run(args, cwd=self.sim_dir, capture_output=True, text=True,
+                                 timeout=config.timeout_s)
+        except subprocess.TimeoutExpired:
+            result.error_message = "Simulation timed out"
+            return result
+        except OSError as e:
+            result.error_message = f"Simulation error: {e}"
+            return result
+
+        stats = parse_stats(sim.stdout)
+        if stats is not None:
+            result_from_stats(result, stats)
+        if sim.returncode != 0 or stats is None:
+            result.error_message = f"Simulation failed: {sim.stderr.strip()}"
+            return result
+        result.success = True
+        return result
+
+    def run(self, config: SizingConfig, build: bool = True) -> List[SizingResult]:
+        """Run the full sweep.
+
+        Args:
+            config: Sweep configuration
+            build: Build the simulators first (skip if already built)
+
+        Returns:
+            Result rows ordered by (out pattern, trace pattern, depth)
+        """
+        self.work_dir.mkdir(parents=True, exist_ok=True)
+        failed = self.build_all(config) if build else []
+        stimulus, _ = self.prepare_stimulus(config)
+
+        results = []
+        for out_pattern in config.out_patterns:
+            for trace_pattern in config.trace_patterns:
+                for depth in sorted(config.depths):
+                    if depth in failed:
+                        results.append(SizingResult(
+                            trace_fifo_depth=depth, out_pattern=out_pattern,
+                            trace_pattern=trace_pattern, error_message="Build failed"))
+                    else:
+                        results.append(self.run_case(depth, out_pattern, trace_pattern,
+                                                     stimulus, config))
+        return results
+
+
+def format_table(results: List[SizingResult]) -> str:
+    """Human-readable results table."""
+    lines = [f"{'depth':>6} {'out_ready':<20} {'trace_ready':<24} {'drops':>8} "
+             f"{'drop %':>8} {'peak':>5} {'p50':>5} {'p99':>5} {'+p99':>5} {'+max':>6}"]
+    for r in results:
+        if not r.success:
+            lines.append(f"{r.trace_fifo_depth:>6} {r.out_pattern:<20} "
+                         f"{r.trace_pattern:<24} FAIL ({r.error_message})")
+            continue
+        lines.append(f"{r.trace_fifo_depth:>6} {r.out_pattern:<20} {r.trace_pattern:<24} "
+                     f"{r.trace_drops:>8} {100.0 * r.drop_rate:>8.4f} {r.peak_trace_fifo:>5} "
+                     f"{r.latency_p50:>5} {r.latency_p99:>5} {r.p99_inflation:>5} "
+                     f"{r.max_inflation:>6}")
+    return '\n'.join(lines)
+
+
+if __name__ == '__main__':
+    import argparse
+    import sys
+
+    parser = argparse.ArgumentParser(description='Size the Sentinel-HFT trace FIFO')
+    parser.add_argument('--depths', default='8,16,32,64,128',
+                        help='TRACE_FIFO_DEPTH values, e.g. "8,16,32" (each at least 2)')
+    parser.add_argument('--out-pattern', action='append', default=None,
+                        help='out_ready pattern (repeatable, default: ready)')
+    parser.add_argument('--trace-pattern', action='append', default=None,
+                        help='trace_ready pattern (repeatable, default: markov:2000:300)')
+    parser.add_argument('--stimulus', type=Path, default=None,
+                        help='Stimulus file (CSV or binary) instead of a synthetic workload')
+    parser.add_argument('--tx', type=int, default=100000,
+                        help='Synthetic workload transactions')
+    parser.add_argument('--gap-ns', type=int, default=30,
+                        help='Synthetic workload mean inter-arrival gap')
+    parser.add_argument('--seed', type=int, default=1,
+                        help='Workload and unseeded markov pattern seed')
+    parser.add_argument('--core-latency', type=int, default=1,
+                        help='CORE_LATENCY of every build')
+    parser.add_argument('--inflight-depth', type=int, default=16,
+                        help='INFLIGHT_DEPTH of every build')
+    parser.add_argument('--clock-ns', type=float, default=10.0,
+                        help='Clock period in nanoseconds')
+    parser.add_argument('--target-drop-rate', type=float, default=0.001,
+                        help='Acceptable trace drop rate for the recommendation')
+    parser.add_argument('--no-build', action='store_true',
+                        help='Reuse existing builds in the work directory')
+    parser.add_argument('--work-dir', type=Path, default=Path('fifo_sizing_out'),
+                        help='Directory for builds and stimuli')
+    parser.add_argument('--output', '-o', type=Path, default=Path('fifo_sizing.json'),
+                        help='Results (JSON)')
+    parser.add_argument('--sim-dir', type=Path, default=None,
+                        help='Simulation directory')
+    args = parser.parse_args()
+
+    depths = parse_int_list(args.depths)
+    if not depths or min(depths) < 2:
+        parser.error("--depths needs values of at least 2")
+
+    config = SizingConfig(
+        depths=depths,
+        out_patterns=args.out_pattern or ['ready'],
+        trace_patterns=args.trace_pattern or ['markov:2000:300'],
+        stimulus_file=args.stimulus,
+        synthetic_tx=args.tx,
+        synthetic_gap_ns=args.gap_ns,
+        seed=args.seed,
+        core_latency=args.core_latency,
+        inflight_depth=args.inflight_depth,
+        clock_period_ns=args.clock_ns,
+        target_drop_rate=args.target_drop_rate,
+    )
+
+    sim_dir = args.sim_dir or Path(__file__).parent.parent / 'sim'
+    sizer = FifoSizer(sim_dir, args.work_dir)
+
+    start = time.monotonic()
+    results = sizer.run(config, build=not args.no_build)
+    best = recommend(results, config.target_drop_rate)
+
+    print(format_table(results))
+    print(f"\nSmallest trace FIFO with drop rate <= {100.0 * config.target_drop_rate:g}%:")
+    for (out_pattern, trace_pattern), depth in best.items():
+        choice = depth if depth is not None else f"none up to {max(config.depths)}"
+        print(f"  out_ready {out_pattern}, trace_ready {trace_pattern}: {choice}")
+
+    with open(args.output, 'w') as f:
+        json.dump({
+            'config': config.to_dict(),
+            'results': [r.to_dict() for r in results],
+            'recommended_depth': [
+                {'out_pattern': o, 'trace_pattern': t, 'trace_fifo_depth': d}
+                for (o, t), d in best.items()
+            ],
+        }, f, indent=2)
+
+    failed = sum(1 for r in results if not r.success)
+    print(f"\nSizing finished in {time.monotonic() - start:.1f} s: "
+          f"{len(results) - failed}/{len(results)} runs passed")
+    print(f"  Results saved to: {args.output}")
+    sys.exit(1 if failed else 0)
@@ -0,0 +1,266 @@
+#!/usr/bin/env python3
+"""Latency vs offered load curves for Sentinel-HFT Wind Tunnel.
+
+Runs the shell's open-loop load test (--test load, see
+sim/arrival_process.h) at a series of offered loads and tabulates, per
+load, the achieved throughput and two latency distributions:
+
+    service    shell ingress to egress, what the trace records show
+    response   intended arrival to egress: service plus the time the
+               transaction waited because the shell was not accepting
+
+Closed-loop and timestamp replays only ever report service latency, so
+queueing the shell pushes back into the source is invisible there (the
+coordinated omission problem). The gap between the two curves is that
+queueing; it grows without bound as the offered load nears saturation.
+
+Usage:
+    python -m wind_tunnel.load_curve --model poisson --loads 10,20,50,80,90,95,99
+    python -m wind_tunnel.load_curve --model mmpp --burst 150 --burst-cycles 200 \\
+        --idle-cycles 2000 --loads 5,10,20
+"""
+
+import json
+import subprocess
+import time
+from dataclasses import dataclass, field, asdict
+from pathlib import Path
+from typing import Callable, List, Optional
+
+from .sim_bench import parse_stats
+from .sweep import SIM_TOP
+
+
+MODELS = ('constant', 'poisson', 'mmpp')
+
+
+@dataclass
+class CurveConfig:
+    """Configuration for a load curve."""
+    model: str = 'poisson'
+    loads_pct: List[float] = field(default_factory=lambda: [10, 25, 50, 75, 90, 95, 99])
+    num_tx: int = 100000
+    seed: int = 1
+
+    # mmpp: the given load is the idle-state rate, bursts run at burst_pct
+    burst_pct: float = 150.0
+    burst_cycles: float = 200.0
+    idle_cycles: float = 2000.0
+
+    # Consumer stalls applied at every load point (see sim/stall_pattern.h)
+    out_pattern: str = 'ready'
+    trace_pattern: str = 'ready'
+
+    fast_forward: bool = True
+    timeout_s: float = 600.0
+
+    def to_dict(self) -> dict:
+        """Convert to dictionary for serialization."""
+        return asdict(self)
+
+
+@dataclass
+class CurvePoint:
+    """Result row for one offered load."""
+    load: str                 # --load spec
+    offered_load: float = 0.0  # Fraction of line rate
+    success: bool = False
+
+    achieved_load: float = 0.0
+    transactions: int = 0
+    trace_drops: int = 0
+    queue_peak: int = 0
+    max_queue_wait: int = 0
+
+    service_p50: int = 0
+    service_p99: int = 0
+    service_p999: int = 0
+    service_max: int = 0
+    response_p50: int = 0
+    response_p99: int = 0
+    response_p999: int = 0
+    response_max: int = 0
+
+    error_message: str = ""
+
+    def to_dict(self) -> dict:
+        """Convert to dictionary for serialization."""
+        return asdict(self)
+
+
+def load_spec(config: CurveConfig, pct: float) -> str:
+    """--load spec for one point of the curve."""
+    if config.model == 'constant':
+        return f'constant:{pct:g}'
+    if config.model == 'poisson':
+        return f'poisson:{pct:g}'
+    if config.model == 'mmpp':
+        return (f'mmpp:{pct:g}:{config.burst_pct:g}:'
+                f'{config.idle_cycles:g}:{config.burst_cycles:g}')
+    raise ValueError(f"Unknown arrival model {config.model} (expected one of {', '.join(MODELS)})")
+
+
+def point_from_stats(point: CurvePoint, stats: dict) -> CurvePoint:
+    """Fill a curve point from the load test's --json stats."""
+    point.offered_load = stats.get('offered_load', 0.0)
+    point.achieved_load = stats.get('achieved_load', 0.0)
+    point.transactions = stats.get('transactions_received', 0)
+    point.trace_drops = stats.get('trace_drops', 0)
+    point.queue_peak = stats.get('load_queue_peak', 0)
+    point.max_queue_wait = stats.get('max_queue_wait_cycles', 0)
+    for prefix, key in (('service', 'latency_cycles'), ('response', 'response_latency_cycles')):
+        lat = stats.get(key) or {}
+        for q in ('p50', 'p99', 'p999', 'max'):
+            setattr(point, f'{prefix}_{q}', lat.get(q, 0))
+    return point
+
+
+class LoadCurve:
+    """Run the load test across offered loads on one shell build."""
+
+    def __init__(self, sim_dir: Path, build_dir: Optional[Path] = None):
+        """Initialize load curve runner.
+
+        Args:
+            sim_dir: Path to simulation directory
+            build_dir: Directory holding the shell executable (default: sim_dir/obj_dir)
+        """
+        self.sim_dir = Path(sim_dir).resolve()
+        self.build_dir = Path(build_dir).resolve() if build_dir else self.sim_dir / 'obj_dir'
+
+    @property
+    def exe_path(self) -> Path:
+        return self.build_dir / SIM_TOP
+
+    def run_point(self, config: CurveConfig, pct: float) -> CurvePoint:
+        """Run one offered load."""
+        spec = load_spec(config, pct)
+        point = CurvePoint(load=spec)
+        args = [
+            str(self.exe_path),
+            '--test', 'load',
+            '--load', spec,
+            '--num-tx', str(config.num_tx),
+            '--seed', str(config.seed),
+            '--out-pattern', config.out_pattern,
+            '--trace-pattern', config.trace_pattern,
+            '--stats-only',
+            '--json',
+        ]
+        if config.fast_forward:
+            args.append('--fast-forward')
+        try:
+            sim = subprocess.run(args, cwd=self.sim_dir, capture_output=True, text=True,
+                                 timeout=config.timeout_s)
+        except subprocess.TimeoutExpired:
+            point.error_message = "Simulation timed out"
+            return point
+        except OSError as e:
+            point.error_message = f"Simulation error: {e}"
+            return point
+
+        stats = parse_stats(sim.stdout)
+        if stats is not None:
+            point_from_stats(point, stats)
+        if sim.returncode != 0 or stats is None:
+            point.error_message = f"Simulation failed: {sim.stderr.strip()}"
+            return point
+        point.success = True
+        return point
+
+    def run(self, config: CurveConfig,
+            progress: Optional[Callable[[CurvePoint], None]] = None) -> List[CurvePoint]:
+        """Run every offered load, in increasing order."""
+        points = []
+        for pct in sorted(config.loads_pct):
+            point = self.run_point(config, pct)
+            points.append(point)
+            if progress:
+                progress(point)
+        return points
+
+
+def format_table(points: List[CurvePoint]) -> str:
+    """Human-readable curve: offered vs achieved load, service vs response latency."""
+    lines = [f"{'offered %':>9} {'achieved %':>10} {'svc p50':>8} {'svc p99':>8} "
+             f"{'resp p50':>9} {'resp p99':>9} {'resp p99.9':>10} {'queue':>7}"]
+    for p in points:
+        if not p.success:
+            lines.append(f"{p.load:>20} FAIL ({p.error_message})")
+            continue
+        lines.append(f"{100.0 * p.offered_load:>9.1f} {100.0 * p.achieved_load:>10.1f} "
+                     f"{p.service_p50:>8} {p.service_p99:>8} {p.response_p50:>9} "
+                     f"{p.response_p99:>9} {p.response_p999:>10} {p.queue_peak:>7}")
+    return '\n'.join(lines)
+
+
+if __name__ == '__main__':
+    import argparse
+    import sys
+
+    parser = argparse.ArgumentParser(description='Latency vs offered load for the Sentinel shell')
+    parser.add_argument('--model', choices=MODELS, default='poisson',
+                        help='Arrival model (default: poisson)')
+    parser.add_argument('--loads', default='10,25,50,75,90,95,99',
+                        help='Offered loads in %% of line rate (mmpp: the idle-state rate)')
+    parser.add_argument('--tx', type=int, default=100000,
+                        help='Transactions per load point')
+    parser.add_argument('--seed', type=int, default=1,
+                        help='Arrival process seed')
+    parser.add_argument('--burst', type=float, default=150.0,
+                        help='mmpp burst rate in %% of line rate')
+    parser.add_argument('--burst-cycles', type=float, default=200.0,
+                        help='mmpp mean burst length (cycles)')
+    parser.add_argument('--idle-cycles', type=float, default=2000.0,
+                        help='mmpp mean time between bursts (cycles)')
+    parser.add_argument('--out-pattern', default='ready',
+                        help='out_ready pattern at every point')
+    parser.add_argument('--trace-pattern', default='ready',
+                        help='trace_ready pattern at every point')
+    parser.add_argument('--no-fast-forward', action='store_true',
+                        help='Evaluate every idle cycle')
+    parser.add_argument('--sim-dir', type=Path, default=None,
+                        help='Simulation directory')
+    parser.add_argument('--build-dir', type=Path, default=None,
+                        help='Directory holding Vtb_sentinel_shell (default: SIM_DIR/obj_dir)')
+    parser.add_argument('--output', '-o', type=Path, default=Path('load_curve.json'),
+                        help='Results (JSON)')
+    args = parser.parse_args()
+
+    try:
+        loads = [float(v) for v in args.loads.split(',') if v.strip()]
+    except ValueError:
+        parser.error(f"Invalid --loads {args.loads}")
+    if not loads or min(loads) <= 0:
+        parser.error("--loads needs values above 0")
+
+    config = CurveConfig(
+        model=args.model,
+        loads_pct=loads,
+        num_tx=args.tx,
+        seed=args.seed,
+        burst_pct=args.burst,
+        burst_cycles=args.burst_cycles,
+        idle_cycles=args.idle_cycles,
+        out_pattern=args.out_pattern,
+        trace_pattern=args.trace_pattern,
+        fast_forward=not args.no_fast_forward,
+    )
+
+    sim_dir = args.sim_dir or Path(__file__).parent.parent / 'sim'
+    curve = LoadCurve(sim_dir, args.build_dir)
+
+    start = time.monotonic()
+    points = curve.run(config, progress=lambda p: print(
+        f"{p.load}: response p99={p.response_p99} {'ok' if p.success else 'FAIL'}"))
+    print()
+    print(format_table(points))
+
+    with open(args.output, 'w') as f:
+        json.dump({'config': config.to_dict(), 'points': [p.to_dict() for p in points]}, f, indent=2)
+
+    failed = sum(1 for p in points if not p.success)
+    print(f"\nCurve finished in {time.monotonic() - start:.1f} s: "
+          f"{len(points) - failed}/{len(points)} points passed")
+    print(f"  Results saved to: {args.output}")
+    sys.exit(1 if failed else 0)
@@ -0,0 +1,315 @@
+"""Order/fill stimulus for the risk gate driver.
+
+Packed 48-byte records replayed by ``sim_risk.cpp --orders``. The layout
+must match sim/order_record.h (OrderRecord):
+
+    timestamp_ns(8) order_id(8) quantity(8) price(8) notional(8)
+    symbol_id(4) kind(1) side(1) order_type(1) padding(1)
+
+Converts from three sources:
+
+- native: CSV with ``timestamp_ns,kind,side,type,qty,price[,notional,symbol,order_id]``
+  (kind order/fill, side buy/sell, type new/cancel/modify/heartbeat, or the
+  numeric codes)
+- demo: transactions as in demo/market_data.csv, where opcode 1/2/3 is
+  new/cancel/modify, data is ``symbol << 32 | order_id`` and meta is the
+  quantity. There is no side, so orders alternate buy/sell by order id
+- wind_tunnel: transactions as in wind_tunnel/data/sample_market.csv,
+  where opcode 0x1/0x2/0x10 is buy/sell/cancel, data is the order id and
+  meta is the quantity
+
+Transaction sources also cover the 24-byte binary stimulus format (see
+input_formats.py). They carry no price, so one is supplied (--price), and
+no fills, which can be synthesized for every Nth new order (--fill-every).
+"""
+
+import csv
+import struct
+import sys
+from dataclasses import dataclass
+from pathlib import Path
+from typing import BinaryIO, Iterator, List, TextIO
+
+from .input_formats import InputTransaction, load_input, _parse_int
+
+
+KIND_ORDER = 0
+KIND_FILL = 1
+
+SIDE_BUY = 1
+SIDE_SELL = 2
+
+TYPE_NEW = 0x1
+TYPE_CANCEL = 0x2
+TYPE_MODIFY = 0x3
+TYPE_HEARTBEAT = 0xF
+
+# Binary record format: 48 bytes, little-endian
+ORDER_STRUCT = struct.Struct('<QQQQQIBBBx')
+ORDER_RECORD_SIZE = 48
+
+_KINDS = {'order': KIND_ORDER, 'fill': KIND_FILL}
+_SIDES = {'buy': SIDE_BUY, 'sell': SIDE_SELL}
+_TYPES = {
+    'new': TYPE_NEW,
+    'cancel': TYPE_CANCEL,
+    'modify': TYPE_MODIFY,
+    'heartbeat': TYPE_HEARTBEAT,
+}
+
+
+@dataclass
+class OrderStimulus:
+    """One order or fill presented to the risk gate."""
+    timestamp_ns: int
+    kind: int = KIND_ORDER
+    side: int = SIDE_BUY
+    order_type: int = TYPE_NEW
+    quantity: int = 0
+    price: int = 0
+    notional: int = 0
+    symbol_id: int = 1
+    order_id: int = 0
+
+    def to_binary(self) -> bytes:
+        """Convert to binary format (48 bytes)."""
+        return ORDER_STRUCT.pack(
+            self.timestamp_ns,
+            self.order_id,
+            self.quantity,
+            self.price,
+            self.notional,
+            self.symbol_id,
+            self.kind,
+            self.side,
+            self.order_type,
+        )
+
+
+def parse_order_csv(file: TextIO) -> Iterator[OrderStimulus]:
+    """Parse a native order CSV.
+
+    Lines starting with # are comments and empty lines are skipped, as for
+    transaction CSVs. notional defaults to qty * price, symbol to 1 and
+    order_id to the row index.
+
+    Yields:
+        OrderStimulus objects, in file order
+    """
+    lines = [l.strip() for l in file if l.strip() and not l.strip().startswith('#')]
+    if not lines:
+        return
+
+    for index, row in enumerate(csv.DictReader(lines)):
+        try:
+            qty = _parse_int(row['qty'])
+            price = _parse_int(row['price'])
+            notional = row.get('notional')
+            symbol = row.get('symbol')
+            order_id = row.get('order_id')
+            yield OrderStimulus(
+                timestamp_ns=_parse_int(row['timestamp_ns']),
+                kind=_parse_code(row['kind'], _KINDS),
+                side=_parse_code(row['side'], _SIDES),
+                order_type=_parse_code(row['type'], _TYPES),
+                quantity=qty,
+                price=price,
+                notional=_parse_int(notional) if notional else qty * price,
+                symbol_id=_parse_int(symbol) if symbol else 1,
+                order_id=_parse_int(order_id) if order_id else index,
+            )
+        except (KeyError, ValueError) as e:
+            raise ValueError(f"Error parsing order CSV row {row}: {e}") from e
+
+
+def detect_dialect(path: Path, transactions: List[InputTransaction] = None) -> str:
+    """Pick native, demo or wind_tunnel for a CSV or binary input.
+
+    A CSV whose header has qty and side columns is native. Otherwise the
+    0x10 cancel opcode identifies wind_tunnel transactions; anything else
+    is read as demo.
+    """
+    if path.suffix.lower() in ('.csv', '.txt'):
+        with open(path) as f:
+            for line in f:
+                stripped = line.strip()
+                if stripped and not stripped.startswith('#'):
+                    columns = {c.strip() for c in stripped.split(',')}
+                    if {'qty', 'side'} <= columns:
+                        return 'native'
+                    break
+    if transactions is None:
+        transactions = load_input(path)
+    if any(tx.opcode == 0x10 for tx in transactions):
+        return 'wind_tunnel'
+    return 'demo'
+
+
+def from_transactions(
+    transactions: List[InputTransaction],
+    dialect: str,
+    price: int = 100,
+    fill_every: int = 0,
+    fill_delay_ns: int = 1000,
+) -> List[OrderStimulus]:
+    """Map generic stimulus transactions to orders.
+
+    Args:
+        transactions: Parsed transactions, in timestamp order
+        dialect: 'demo' or 'wind_tunnel' (see module docstring)
+        price: Price for every order (transactions carry none)
+        fill_every: Fill every Nth new order in full (0 = no fills)
+        fill_delay_ns: Fill timestamp after its order
+
+    Returns:
+        Orders and fills sorted by timestamp (orders first on ties)
+    """
+    if dialect not in ('demo', 'wind_tunnel'):
+        raise ValueError(f"Unknown transaction dialect: {dialect}")
+
+    records = []
+    new_orders = 0
+    for tx in transactions:
+        qty = tx.meta
+        if dialect == 'demo':
+            order_id = tx.data & 0xFFFFFFFF
+            symbol = (tx.data >> 32) & 0xFFFFFFFF
+            order_type = {1: TYPE_NEW, 2: TYPE_CANCEL, 3: TYPE_MODIFY}.get(tx.opcode)
+            side = SIDE_BUY if order_id % 2 == 0 else SIDE_SELL
+        else:
+            order_id = tx.data
+            symbol = 1
+            order_type = TYPE_CANCEL if tx.opcode == 0x10 else TYPE_NEW
+            side = {0x1: SIDE_BUY, 0x2: SIDE_SELL}.get(tx.opcode, SIDE_BUY)
+            if tx.opcode not in (0x1, 0x2, 0x10):
+                order_type = None
+        if order_type is None:
+            raise ValueError(f"Opcode 0x{tx.opcode:x} has no {dialect} order mapping")
+
+        order = OrderStimulus(
+            timestamp_ns=tx.timestamp_ns,
+            side=side,
+            order_type=order_type,
+            quantity=qty,
+            price=price,
+            notional=qty * price,
+            symbol_id=symbol,
+            order_id=order_id,
+        )
+        records.append(order)
+
+        if order_type == TYPE_NEW:
+            new_orders += 1
+            if fill_every and new_orders % fill_every == 0:
+                records.append(OrderStimulus(
+                    timestamp_ns=tx.timestamp_ns + fill_delay_ns,
+                    kind=KIND_FILL,
+                    side=side,
+                    quantity=qty,
+                    price=price,
+                    notional=qty * price,
+                    symbol_id=symbol,
+                    order_id=order_id,
+                ))
+
+    # Stable: equal timestamps keep their relative order
+    records.sort(key=lambda r: r.timestamp_ns)
+    return records
+
+
+def load_orders(path: Path, dialect: str = 'auto', **kwargs) -> List[OrderStimulus]:
+    """Load orders from a native CSV or a transaction file.
+
+    Args:
+        path: Input file (CSV or 24-byte binary stimulus)
+        dialect: 'auto', 'native', 'demo' or 'wind_tunnel'
+        **kwargs: Passed to from_transactions for transaction dialects
+
+    Returns:
+        Orders and fills sorted by timestamp
+    """
+    if dialect == 'auto':
+        dialect = detect_dialect(path)
+    if dialect == 'native':
+        with open(path) as f:
+            records = list(parse_order_csv(f))
+        records.sort(key=lambda r: r.timestamp_ns)
+        return records
+    return from_transactions(load_input(path), dialect, **kwargs)
+
+
+def parse_order_binary(file: BinaryIO) -> Iterator[OrderStimulus]:
+    """Parse a binary order stimulus file."""
+    while True:
+        data = file.read(ORDER_RECORD_SIZE)
+        if not data:
+            break
+        if len(data) < ORDER_RECORD_SIZE:
+            raise ValueError(
+                f"Incomplete record: expected {ORDER_RECORD_SIZE} bytes, got {len(data)}"
+            )
+        (timestamp_ns, order_id, quantity, price, notional,
+         symbol_id, kind, side, order_type) = ORDER_STRUCT.unpack(data)
+        yield OrderStimulus(
+            timestamp_ns=timestamp_ns,
+            kind=kind,
+            side=side,
+            order_type=order_type,
+            quantity=quantity,
+            price=price,
+            notional=notional,
+            symbol_id=symbol_id,
+            order_id=order_id,
+        )
+
+
+def write_order_stimulus(records: List[OrderStimulus], path: Path) -> None:
+    """Write orders and fills to a binary order stimulus file."""
+    with open(path, 'wb') as f:
+        for r in records:
+            f.write(r.to_binary())
+
+
+def _parse_code(value: str, names: dict) -> int:
+    """Parse a named code (case-insensitive) or an integer."""
+    value = value.strip()
+    if value.lower() in names:
+        return names[value.lower()]
+    return _parse_int(value)
+
+
+if __name__ == '__main__':
+    import argparse
+
+    parser = argparse.ArgumentParser(description='Convert orders to risk gate stimulus')
+    parser.add_argument('input', type=Path, help='Input file (CSV or binary stimulus)')
+    parser.add_argument('--output', '-o', type=Path, required=True,
+                       help='Output order stimulus file (.bin)')
+    parser.add_argument('--dialect', choices=['auto', 'native', 'demo', 'wind_tunnel'],
+                       default='auto', help='Input interpretation (default: auto)')
+    parser.add_argument('--price', type=int, default=100,
+                       help='Price for transaction inputs (default: 100)')
+    parser.add_argument('--fill-every', type=int, default=0,
+                       help='Transaction inputs: fill every Nth new order (default: none)')
+    parser.add_argument('--fill-delay-ns', type=int, default=1000,
+                       help='Transaction inputs: fill delay after the order (default: 1000)')
+
+    args = parser.parse_args()
+
+    try:
+        dialect = args.dialect
+        if dialect == 'auto':
+            dialect = detect_dialect(args.input)
+        kwargs = {}
+        if dialect != 'native':
+            kwargs = dict(price=args.price, fill_every=args.fill_every,
+                          fill_delay_ns=args.fill_delay_ns)
+        records = load_orders(args.input, dialect, **kwargs)
+    except (OSError, ValueError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        sys.exit(1)
+
+    write_order_stimulus(records, args.output)
+    fills = sum(1 for r in records if r.kind == KIND_FILL)
+    print(f"Converted {args.input} ({dialect}): {len(records) - fills} orders, "
+          f"{fills} fills -> {args.output}")
@@ -5,7 +5,8 @@ Orchestrates the complete replay workflow:
 1. Load and convert input data to stimulus format
 2. Build/configure Verilator simulation
 3. Run simulation with stimulus
-4. Collect and process traces
+4. Collect and process traces (read back from disk, or consumed from a
+   shared-memory ring while the simulation runs, see trace_output)
 5. Compute metrics
 6. Generate reports
 
@@ -27,17 +28,18 @@ import subprocess
 import tempfile
 from dataclasses import dataclass, field
 from pathlib import Path
-from typing import Optional
+from typing import Callable, Optional
 
 import sys
 sys.path.insert(0, str(Path(__file__).parent.parent / 'host'))
 
 from trace_decode import decode_trace_file, TraceRecord
+from trace_ring import TraceRingReader, is_shm_output, remove_ring
 from metrics import MetricsEngine, FullMetrics
 from report import ReportGenerator
 
 from .input_formats import load_input, write_stimulus_binary, InputTransaction
-from .trace_pipeline import TracePipeline, ValidationResult
+from .trace_pipeline import EnrichedTrace, TracePipeline, ValidationResult
 
 
 @dataclass
@@ -46,6 +48,7 @@ class ReplayConfig:
     # Simulation parameters
     core_latency: int = 1
     clock_period_ns: float = 10.0
+    fast_forward: bool = True  # Skip idle cycles (traces are unchanged)
 
     # Test parameters
     test_mode: str = "replay"
@@ -58,6 +61,7 @@ class ReplayConfig:
 
     # Output options
     json_stats: bool = True
+    trace_output: str = ""  # "" = traces.bin in the output dir; shm://NAME = live ring
 
 
 @dataclass
@@ -162,6 +166,7 @@ class ReplayRunner:
         input_file: Path,
         output_dir: Path,
         config: Optional[ReplayConfig] = None,
+        on_trace: Optional[Callable[[TraceRecord], None]] = None,
     ) -> ReplayResult:
         """Run complete replay workflow.
 
@@ -169,6 +174,8 @@ class ReplayRunner:
             input_file: Path to input transaction file (CSV or binary)
             output_dir: Directory for output files
             config: Replay configuration
+            on_trace: Called with each trace record; with an shm://
+                trace_output this happens while the simulation runs
 
         Returns:
             ReplayResult with metrics and status
@@ -210,28 +217,35 @@ class ReplayRunner:
             return result
 
         # Step 3: Run simulation
-        trace_path = output_dir / 'traces.bin'
+        live = is_shm_output(config.trace_output)
+        trace_path = None if live else output_dir / 'traces.bin'
 
         args = [
             str(self.exe_path),
             '--test', config.test_mode,
             '--stimulus', str(stimulus_path),
-            '--output', str(trace_path),
+            '--output', config.trace_output if live else str(trace_path),
             '--num-tx', str(len(transactions)),
         ]
 
+        if config.fast_forward:
+            args.append('--fast-forward')
+
         if config.json_stats:
             args.append('--json')
             args.extend(['--clock-ns', str(config.clock_period_ns)])
 
         try:
-            sim_result = subprocess.run(
-                args,
-                cwd=self.sim_dir,
-                capture_output=True,
-                text=True,
-                timeout=300,  # 5 minute timeout
-            )
+            if live:
+                sim_result, traces = self._run_live(args, config.trace_output, on_trace)
+            else:
+                sim_result = subprocess.run(
+                    args,
+                    cwd=self.sim_dir,
+                    capture_output=True,
+                    text=True,
+                    timeout=300,  # 5 minute timeout
+                )
 
             result.sim_returncode = sim_result.returncode
             result.sim_stdout = sim_result.stdout
@@ -250,21 +264,29 @@ class ReplayRunner:
             return result
 
         # Step 4: Process traces
-        try:
-            if trace_path.exists():
-                with open(trace_path, 'rb') as f:
-                    traces = list(decode_trace_file(f))
-                result.output_traces = len(traces)
-            else:
-                traces = []
-        except Exception as e:
-            result.error_message = f"Failed to decode traces: {e}"
-            return result
+        if not live:
+            try:
+                if trace_path.exists():
+                    with open(trace_path, 'rb') as f:
+                        traces = list(decode_trace_file(f))
+                else:
+                    traces = []
+            except Exception as e:
+                result.error_message = f"Failed to decode traces: {e}"
+                return result
+            if on_trace is not None:
+                for t in traces:
+                    on_trace(t)
+        result.output_traces = len(traces)
 
         # Step 5: Validate traces
         pipeline = TracePipeline(clock_period_ns=config.clock_period_ns)
         try:
-            result.validation = pipeline.validate(trace_path)
+            if live:
+                result.validation = pipeline.validate_traces(
+                    EnrichedTrace.from_trace(t, config.clock_period_ns) for t in traces)
+            else:
+                result.validation = pipeline.validate(trace_path)
         except Exception as e:
             # Validation is optional, continue even if it fails
             pass
@@ -288,7 +310,7 @@ class ReplayRunner:
                 })
 
             result.metrics = engine.compute_full(trace_dicts)
-            result.metrics.trace_file = str(trace_path)
+            result.metrics.trace_file = config.trace_output if live else str(trace_path)
             result.metrics.trace_count = len(traces)
 
             # Add validation errors if present
@@ -303,6 +325,44 @@ class ReplayRunner:
         result.success = True
         return result
 
+    def _run_live(
+        self,
+        args: list,
+        output: str,
+        on_trace: Optional[Callable[[TraceRecord], None]],
+        timeout: float = 300,
+    ) -> tuple:
+        """Run the simulation while consuming its shared-memory trace ring.
+
+        Returns:
+            (CompletedProcess, trace records)
+        """
+        # A leftover segment would be attached before the sim replaces it
+        remove_ring(output)
+        proc = subprocess.Popen(
+            args,
+            cwd=self.sim_dir,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.PIPE,
+            text=True,
+        )
+        traces = []
+        try:
+            reader = TraceRingReader(output)
+            for t in reader.records(done=lambda: proc.poll() is not None, timeout=timeout):
+                traces.append(t)
+                if on_trace is not None:
+                    on_trace(t)
+            stdout, stderr = proc.communicate(timeout=timeout)
+        except BaseException:
+            proc.kill()
+            proc.communicate()
+            remove_ring(output)
+            raise
+        if proc.returncode != 0:
+            remove_ring(output)
+        return subprocess.CompletedProcess(args, proc.returncode, stdout, stderr), traces
+
     def run_with_reports(
         self,
         input_file: Path,
@@ -377,6 +437,7 @@ def run_replay(
     sim_dir: Optional[Path] = None,
     latency: int = 1,
     clock_ns: float = 10.0,
+    trace_output: str = "",
 ) -> ReplayResult:
     """Convenience function for single replay.
 
@@ -386,6 +447,7 @@ def run_replay(
         sim_dir: Simulation directory (auto-detected if None)
         latency: Core latency
         clock_ns: Clock period
+        trace_output: shm://NAME to stream traces over shared memory
 
     Returns:
         ReplayResult
@@ -398,6 +460,7 @@ def run_replay(
     config = ReplayConfig(
         core_latency=latency,
         clock_period_ns=clock_ns,
+        trace_output=trace_output,
     )
 
     return runner.run_with_reports(input_file, output_dir, config)
@@ -416,6 +479,8 @@ if __name__ == '__main__':
                        help='Clock period in nanoseconds')
     parser.add_argument('--sim-dir', type=Path, default=None,
                        help='Simulation directory')
+    parser.add_argument('--trace-output', default='',
+                       help='shm://NAME: stream traces over shared memory instead of a file')
 
     args = parser.parse_args()
 
@@ -425,6 +490,7 @@ if __name__ == '__main__':
         sim_dir=args.sim_dir,
         latency=args.latency,
         clock_ns=args.clock_ns,
+        trace_output=args.trace_output,
     )
 
     if result.success:
@@ -0,0 +1,491 @@
+#!/usr/bin/env python3
+"""Simulator speed benchmark for Sentinel-HFT.
+
+Runs fixed scenarios on the Verilator drivers and measures how fast they
+simulate, so a change that slows the models (and every nightly replay
+with them) is caught before it lands:
+
+1. Every scenario runs once untimed (warm-up: page cache, CPU clocks)
+2. Then a fixed number of timed repetitions, each in a fresh process
+   pinned to one CPU
+3. Per scenario the median simulated cycles/sec, transactions/sec and
+   the peak RSS of the simulator process are reported as JSON
+4. Optionally the results are compared against a stored baseline and
+   any scenario slower (or larger) than the tolerance fails the run
+
+Rates come from the simulators' own --json stats (model construction and
+process start-up are excluded), as does peak RSS.
+
+Scenarios:
+    shell_idle          Replay with 200 idle cycles between transactions
+    shell_saturated     Back-to-back transactions (throughput test)
+    shell_backpressure  Periodic output backpressure
+    shell_overflow      Trace FIFO overflow (traces blocked)
+    shell_vcd_off       Latency test ...
+    shell_vcd_on        ... and the same with VCD tracing
+    risk_stress         Randomized order stream through the risk gate
+    risk_backpressure   Pipelined bursts with out_ready low 75% of cycles
+    risk_symbols        Multi-symbol stream, 256 symbols
+
+Baselines are machine specific: record one per runner (make
+bench-baseline) and compare on the same machine.
+
+Usage:
+    python -m wind_tunnel.sim_bench --sim-dir sim --out bench.json \\
+        --baseline baselines/sim_bench.json
+"""
+
+import json
+import os
+import platform
+import statistics
+import subprocess
+import tempfile
+import time
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Callable, Dict, List, Optional
+
+from .input_formats import write_stimulus_binary
+from .sweep import synthetic_stimulus
+
+
+SHELL_EXE = 'Vtb_sentinel_shell'
+RISK_EXE = 'Vtb_risk_gate'
+
+
+@dataclass
+class BenchScenario:
+    """One fixed simulator workload."""
+    name: str
+    driver: str                 # SHELL_EXE or RISK_EXE
+    args: List[str]
+    description: str = ""
+    stimulus: Optional[dict] = None   # synthetic_stimulus() arguments, written to --stimulus
+
+
+def default_scenarios(scale: float = 1.0) -> List[BenchScenario]:
+    """The standard scenario set; scale multiplies every workload size."""
+    def n(count: int) -> str:
+        return str(max(1, int(count * scale)))
+
+    return [
+        BenchScenario('shell_idle', SHELL_EXE,
+                      ['--test', 'replay', '--num-tx', n(20000), '--stats-only'],
+                      'Replay with 200 idle cycles between transactions',
+                      stimulus=dict(seed=1, num_tx=int(n(20000)), gap_ns=2000)),
+        BenchScenario('shell_saturated', SHELL_EXE,
+                      ['--test', 'throughput', '--num-tx', n(200000), '--stats-only'],
+                      'Back-to-back transactions'),
+        BenchScenario('shell_backpressure', SHELL_EXE,
+                      ['--test', 'backpressure', '--num-tx', n(100000), '--bp-cycles', '20',
+                       '--stats-only'],
+                      'Periodic output backpressure'),
+        BenchScenario('shell_overflow', SHELL_EXE,
+                      ['--test', 'overflow', '--num-tx', n(100000), '--stats-only'],
+                      'Trace FIFO overflow'),
+        BenchScenario('shell_vcd_off', SHELL_EXE,
+                      ['--test', 'latency', '--num-tx', n(10000), '--stats-only'],
+                      'Latency test, no waveform'),
+        BenchScenario('shell_vcd_on', SHELL_EXE,
+                      ['--test', 'latency', '--num-tx', n(10000), '--stats-only', '--trace'],
+                      'Latency test with VCD tracing'),
+        BenchScenario('risk_stress', RISK_EXE,
+                      ['--filter', 'stress', '--stress-orders', n(100000), '--jobs', '1'],
+                      'Randomized order stream'),
+        BenchScenario('risk_backpressure', RISK_EXE,
+                      ['--filter', 'stress_burst', '--stress-orders', n(100000),
+                       '--out-ready-pct', '25', '--jobs', '1'],
+                      'Pipelined bursts under output backpressure'),
+        BenchScenario('risk_symbols', RISK_EXE,
+                      ['--symbols', '256', '--symbol-cycles', n(500000)],
+                      'Multi-symbol stream, 256 symbols'),
+    ]
+
+
+@dataclass
+class BenchConfig:
+    """Configuration for a benchmark run."""
+    repetitions: int = 5
+    warmup: int = 1
+    cpu: Optional[int] = None        # CPU to pin to (None = last available)
+    pin: bool = True
+    scale: float = 1.0
+    timeout_s: float = 600.0
+    filter: Optional[List[str]] = None   # Scenario names (None = all)
+
+    # Regression gate: fail when the median rate drops (or RSS grows) by more
+    tolerance: float = 0.10
+    rss_tolerance: float = 0.25
+
+
+@dataclass
+class BenchSample:
+    """One timed simulator run."""
+    cycles: int = 0
+    transactions: int = 0
+    wall_time_s: float = 0.0
+    cycles_per_sec: float = 0.0
+    transactions_per_sec: float = 0.0
+    peak_rss_kb: int = 0
+
+
+@dataclass
+class BenchResult:
+    """Benchmark result for one scenario."""
+    name: str
+    description: str = ""
+    success: bool = False
+    error_message: str = ""
+    samples: List[BenchSample] = field(default_factory=list)
+
+    @property
+    def cycles_per_sec(self) -> float:
+        return statistics.median(s.cycles_per_sec for s in self.samples) if self.samples else 0.0
+
+    @property
+    def transactions_per_sec(self) -> float:
+        return (statistics.median(s.transactions_per_sec for s in self.samples)
+                if self.samples else 0.0)
+
+    @property
+    def peak_rss_kb(self) -> int:
+        return max((s.peak_rss_kb for s in self.samples), default=0)
+
+    def to_dict(self) -> dict:
+        """Convert to dictionary for JSON serialization."""
+        rates = [s.cycles_per_sec for s in self.samples]
+        return {
+            'description': self.description,
+            'success': self.success,
+            'error_message': self.error_message,
+            'repetitions': len(self.samples),
+            'cycles': self.samples[0].cycles if self.samples else 0,
+            'transactions': self.samples[0].transactions if self.samples else 0,
+            'cycles_per_sec': round(self.cycles_per_sec, 1),
+            'cycles_per_sec_min': round(min(rates), 1) if rates else 0.0,
+            'cycles_per_sec_max': round(max(rates), 1) if rates else 0.0,
+            'transactions_per_sec': round(self.transactions_per_sec, 1),
+            'peak_rss_kb': self.peak_rss_kb,
+        }
+
+
+def host_info() -> dict:
+    """Identify the machine a result was measured on."""
+    cpu = platform.processor()
+    try:
+        with open('/proc/cpuinfo') as f:
+            for line in f:
+                if line.startswith('model name'):
+                    cpu = line.split(':', 1)[1].strip()
+                    break
+    except OSError:
+        pass
+    return {
+        'hostname': platform.node(),
+        'machine': platform.machine(),
+        'cpu': cpu,
+        'cpus': os.cpu_count(),
+    }
+
+
+def parse_stats(stdout: str) -> Optional[dict]:
+    """Last JSON stats line a driver printed (both print one with --json)."""
+    stats = None
+    for line in stdout.splitlines():
+        if line.startswith('{'):
+            try:
+                stats = json.loads(line)
+            except json.JSONDecodeError:
+                continue
+    return stats
+
+
+def sample_from_stats(stats: dict) -> BenchSample:
+    """Rates and peak RSS from either driver's --json stats.
+
+    The drivers report their own peak RSS (sim/process_stats.h): measured
+    from here it would include the launching Python process.
+    """
+    if 'runs' in stats:
+        # Risk gate --symbols: one entry per symbol count
+        runs = stats['runs']
+        cycles = stats['cycles'] * len(runs)
+        transactions = sum(r['orders'] + r['fills'] for r in runs)
+        wall = sum(r['wall_time_s'] for r in runs)
+    else:
+        cycles = stats.get('cycles_simulated', 0)
+        # Shell: transactions through the DUT; risk gate: orders presented
+        transactions = stats.get('transactions_received', stats.get('orders_sent', 0))
+        wall = stats.get('wall_time_s', 0.0)
+    return BenchSample(
+        cycles=cycles,
+        transactions=transactions,
+        wall_time_s=wall,
+        cycles_per_sec=cycles / wall if wall > 0 else 0.0,
+        transactions_per_sec=transactions / wall if wall > 0 else 0.0,
+        peak_rss_kb=stats.get('peak_rss_kb', 0),
+    )
+
+
+def compare(results: Dict[str, dict], baseline: dict, config: BenchConfig) -> List[str]:
+    """Regressions of results against a baseline report.
+
+    Args:
+        results: Scenario name -> BenchResult.to_dict()
+        baseline: A previous report (its 'scenarios')
+        config: Tolerances
+
+    Returns:
+        One message per regression (empty = within tolerance)
+    """
+    regressions = []
+    for name, cur in results.items():
+        base = baseline.get('scenarios', {}).get(name)
+        if not base or not cur.get('success') or not base.get('cycles_per_sec'):
+            continue
+        floor = base['cycles_per_sec'] * (1 - config.tolerance)
+        if cur['cycles_per_sec'] < floor:
+            regressions.append(
+                f"{name}: {cur['cycles_per_sec']:.0f} cycles/s is "
+                f"{100 * (1 - cur['cycles_per_sec'] / base['cycles_per_sec']):.1f}% below "
+                f"baseline {base['cycles_per_sec']:.0f} (tolerance {100 * config.tolerance:.0f}%)")
+        if base.get('peak_rss_kb') and cur['peak_rss_kb'] > base['peak_rss_kb'] * (1 + config.rss_tolerance):
+            regressions.append(
+                f"{name}: peak RSS {cur['peak_rss_kb']} KiB exceeds baseline "
+                f"{base['peak_rss_kb']} KiB by more than {100 * config.rss_tolerance:.0f}%")
+    return regressions
+
+
+class SimBench:
+    """Run the simulator speed benchmark."""
+
+    def __init__(self, sim_dir: Path, work_dir: Path, build_dir: Optional[Path] = None):
+        """Initialize benchmark.
+
+        Args:
+            sim_dir: Simulation directory (contains Makefile)
+            work_dir: Scratch directory for stimulus and VCD files
+            build_dir: Directory with the built drivers (default: sim_dir/obj_dir)
+        """
+        self.sim_dir = Path(sim_dir)
+        self.work_dir = Path(work_dir)
+        self.build_dir = Path(build_dir) if build_dir else self.sim_dir / 'obj_dir'
+
+    def exe_path(self, driver: str) -> Path:
+        return self.build_dir / driver
+
+    def pick_cpu(self, config: BenchConfig) -> Optional[int]:
+        """CPU every run is pinned to (the last one, away from cpu0 interrupts)."""
+        if not config.pin or not hasattr(os, 'sched_setaffinity'):
+            return None
+        if config.cpu is not None:
+            return config.cpu
+        return max(os.sched_getaffinity(0))
+
+    def run_once(self, scenario: BenchScenario, args: List[str],
+                 cpu: Optional[int], timeout_s: float) -> BenchSample:
+        """Run the driver once and measure it."""
+        preexec = (lambda: os.sched_setaffinity(0, {cpu})) if cpu is not None else None
+        with tempfile.TemporaryFile('w+') as out, tempfile.TemporaryFile('w+') as err:
+            proc = subprocess.Popen(args, cwd=self.work_dir, stdout=out, stderr=err,
+                                    text=True, preexec_fn=preexec)
+            try:
+                returncode = proc.wait(timeout=timeout_s)
+            except subprocess.TimeoutExpired:
+                proc.kill()
+                proc.wait()
+                returncode = None
+            out.seek(0)
+            err.seek(0)
+            stdout, stderr = out.read(), err.read()
+
+        if returncode is None:
+            raise RuntimeError(f"{scenario.name} timed out after {timeout_s:.0f}s")
+        if returncode != 0:
+            raise RuntimeError(f"{scenario.name} failed ({returncode}): "
+                               f"{stderr.strip() or stdout.strip()[-500:]}")
+        stats = parse_stats(stdout)
+        if stats is None:
+            raise RuntimeError(f"{scenario.name}: no JSON stats in output")
+        return sample_from_stats(stats)
+
+    def run_scenario(self, scenario: BenchScenario, config: BenchConfig,
+                     cpu: Optional[int]) -> BenchResult:
+        """Warm up, then time the configured repetitions of one scenario."""
+        result = BenchResult(name=scenario.name, description=scenario.description)
+        exe = self.exe_path(scenario.driver)
+        if not exe.exists():
+            result.error_message = f"{exe} not built"
+            return result
+
+        args = [str(exe)] + scenario.args + ['--json']
+        if scenario.stimulus is not None:
+            stim_path = self.work_dir / f'{scenario.name}.stim.bin'
+            write_stimulus_binary(synthetic_stimulus(**scenario.stimulus), stim_path)
+            args += ['--stimulus', str(stim_path)]
+
+        try:
+            for _ in range(config.warmup):
+                self.run_once(scenario, args, cpu, config.timeout_s)
+            for _ in range(config.repetitions):
+                result.samples.append(self.run_once(scenario, args, cpu, config.timeout_s))
+        except (OSError, RuntimeError) as e:
+            result.error_message = str(e)
+            return result
+
+        result.success = True
+        return result
+
+    def run(self, config: BenchConfig,
+            progress: Optional[Callable[[BenchResult], None]] = None,
+            scenarios: Optional[List[BenchScenario]] = None) -> dict:
+        """Run every selected scenario.
+
+        Args:
+            config: Repetitions, pinning, scale and scenario filter
+            progress: Called with each scenario's result as it finishes
+            scenarios: Scenarios to choose from (default: default_scenarios)
+
+        Returns:
+            Report with host, config and per-scenario results
+        """
+        self.work_dir.mkdir(parents=True, exist_ok=True)
+        cpu = self.pick_cpu(config)
+        if scenarios is None:
+            scenarios = default_scenarios(config.scale)
+        scenarios = [s for s in scenarios
+                     if not config.filter or s.name in config.filter]
+
+        results = {}
+        for scenario in scenarios:
+            res = self.run_scenario(scenario, config, cpu)
+            results[scenario.name] = res.to_dict()
+            if progress:
+                progress(res)
+        # Waveforms from shell_vcd_on are only there to be written
+        for wave in [*self.work_dir.glob('*.vcd'), *self.work_dir.glob('*.fst')]:
+            wave.unlink()
+
+        return {
+            'host': host_info(),
+            'timestamp': time.strftime('%Y-%m-%dT%H:%M:%S'),
+            'config': {
+                'repetitions': config.repetitions,
+                'warmup': config.warmup,
+                'cpu': cpu,
+                'scale': config.scale,
+            },
+            'scenarios': results,
+        }
+
+
+def load_baseline(path: Path) -> Optional[dict]:
+    """A stored report, or None if there is none yet."""
+    try:
+        with open(path) as f:
+            return json.load(f)
+    except FileNotFoundError:
+        return None
+
+
+if __name__ == '__main__':
+    import argparse
+    import sys
+
+    parser = argparse.ArgumentParser(description='Benchmark Sentinel-HFT simulator speed')
+    parser.add_argument('--sim-dir', type=Path, default=Path(__file__).parent.parent / 'sim',
+                       help='Simulation directory (default: sim)')
+    parser.add_argument('--build-dir', type=Path, default=None,
+                       help='Directory with the built drivers (default: SIM_DIR/obj_dir)')
+    parser.add_argument('--work-dir', type=Path, default=Path('bench_out'),
+                       help='Scratch directory (default: bench_out)')
+    parser.add_argument('--out', '-o', type=Path, default=None,
+                       help='Write the report as JSON')
+    parser.add_argument('--baseline', type=Path, default=None,
+                       help='Compare against this report; exit 1 on regression')
+    parser.add_argument('--update-baseline', action='store_true',
+                       help='Write the report to --baseline instead of comparing')
+    parser.add_argument('--reps', type=int, default=5, help='Timed repetitions (default: 5)')
+    parser.add_argument('--warmup', type=int, default=1, help='Untimed runs first (default: 1)')
+    parser.add_argument('--cpu', type=int, default=None,
+                       help='CPU to pin to (default: the last available)')
+    parser.add_argument('--no-pin', action='store_true', help='Do not pin to a CPU')
+    parser.add_argument('--scale', type=float, default=1.0,
+                       help='Multiply every workload size (default: 1)')
+    parser.add_argument('--tolerance', type=float, default=0.10,
+                       help='Allowed cycles/sec drop vs baseline (default: 0.10)')
+    parser.add_argument('--rss-tolerance', type=float, default=0.25,
+                       help='Allowed peak RSS growth vs baseline (default: 0.25)')
+    parser.add_argument('--scenario', action='append', default=None,
+                       help='Run only this scenario (repeatable)')
+    parser.add_argument('--list', action='store_true', help='List scenarios and exit')
+
+    args = parser.parse_args()
+
+    if args.list:
+        for sc in default_scenarios(args.scale):
+            print(f"{sc.name:20s} {sc.driver:20s} {sc.description}")
+        sys.exit(0)
+    if args.update_baseline and args.baseline is None:
+        parser.error('--update-baseline needs --baseline')
+    if args.reps < 1:
+        parser.error('--reps must be at least 1')
+
+    config = BenchConfig(
+        repetitions=args.reps,
+        warmup=args.warmup,
+        cpu=args.cpu,
+        pin=not args.no_pin,
+        scale=args.scale,
+        filter=args.scenario,
+        tolerance=args.tolerance,
+        rss_tolerance=args.rss_tolerance,
+    )
+
+    def report(res: BenchResult) -> None:
+        if res.success:
+            print(f"  {res.name:20s} {res.cycles_per_sec:14,.0f} cycles/s "
+                  f"{res.transactions_per_sec:14,.0f} tx/s {res.peak_rss_kb:8d} KiB")
+        else:
+            print(f"  {res.name:20s} FAILED: {res.error_message}")
+
+    bench = SimBench(args.sim_dir, args.work_dir, args.build_dir)
+    print(f"Benchmarking {SHELL_EXE} and {RISK_EXE}: {config.warmup} warm-up + "
+          f"{config.repetitions} timed runs per scenario")
+    result = bench.run(config, progress=report)
+    failed = [n for n, r in result['scenarios'].items() if not r['success']]
+
+    if args.out:
+        args.out.parent.mkdir(parents=True, exist_ok=True)
+        with open(args.out, 'w') as f:
+            json.dump(result, f, indent=2)
+        print(f"Report written to {args.out}")
+
+    if failed:
+        print(f"Error: {len(failed)} scenario(s) failed: {', '.join(failed)}", file=sys.stderr)
+        sys.exit(1)
+
+    if args.update_baseline:
+        args.baseline.parent.mkdir(parents=True, exist_ok=True)
+        with open(args.baseline, 'w') as f:
+            json.dump(result, f, indent=2)
+        print(f"Baseline written to {args.baseline}")
+        sys.exit(0)
+
+    if args.baseline is not None:
+        baseline = load_baseline(args.baseline)
+        if baseline is None:
+            print(f"No baseline at {args.baseline}; record one with --update-baseline "
+                  f"(make bench-baseline)")
+            sys.exit(0)
+        if baseline.get('host', {}).get('cpu') != result['host']['cpu']:
+            print(f"Warning: baseline was measured on '{baseline.get('host', {}).get('cpu')}', "
+                  f"this is '{result['host']['cpu']}'", file=sys.stderr)
+        regressions = compare(result['scenarios'], baseline, config)
+        if regressions:
+            print("\nSim speed regressions:")
+            for r in regressions:
+                print(f"  {r}")
+            sys.exit(1)
+        print(f"\nAll scenarios within {100 * config.tolerance:.0f}% of baseline")
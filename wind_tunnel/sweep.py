@@ -0,0 +1,588 @@
+#!/usr/bin/env python3
+"""Parallel latency sweep for Sentinel-HFT Wind Tunnel.
+
+Sweeps CORE_LATENCY values against a set of stimulus workloads:
+1. Build every latency into its own build directory, in parallel
+2. Expand (latency, stimulus, seed) into independent replay jobs
+3. Run the jobs on a pool of simulator processes, one per core
+4. Aggregate per-job latency statistics into a single table
+
+Each parameterisation gets its own BUILD_DIR, so builds never share
+Verilator output and finished models are reused by later sweeps (make
+only rebuilds what changed). Jobs are queued longest-first and every
+worker pulls the next job as soon as its previous one finishes, so a
+few large captures don't leave cores idle at the end of the sweep.
+
+Usage:
+    from wind_tunnel.sweep import SweepConfig, SweepRunner
+
+    runner = SweepRunner(sim_dir=Path("sim"), work_dir=Path("sweep_out"))
+    results = runner.run(SweepConfig(
+        latencies=list(range(0, 33)),
+        stimulus_files=[Path("market_data.csv")],
+        seeds=[1, 2, 3],
+    ))
+    write_table(results, Path("sweep.json"))
+"""
+
+import hashlib
+import json
+import os
+import queue
+import random
+import struct
+import subprocess
+import threading
+import time
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass, field, asdict
+from pathlib import Path
+from typing import Callable, List, Optional, Tuple
+
+import sys
+sys.path.insert(0, str(Path(__file__).parent.parent / 'host'))
+
+from trace_decode import TRACE_FORMAT, TRACE_RECORD_SIZE
+
+from .input_formats import (
+    InputTransaction,
+    STIMULUS_RECORD_SIZE,
+    detect_format,
+    load_input,
+    write_stimulus_binary,
+)
+
+
+SIM_TOP = 'Vtb_sentinel_shell'
+
+
+@dataclass
+class SweepConfig:
+    """Configuration for a latency sweep."""
+    # Parameter space
+    latencies: List[int] = field(default_factory=lambda: list(range(0, 33)))
+    stimulus_files: List[Path] = field(default_factory=list)
+
+    # Synthetic workloads, one per seed
+    seeds: List[int] = field(default_factory=list)
+    synthetic_tx: int = 10000
+    synthetic_gap_ns: int = 30
+
+    # Simulation parameters
+    clock_period_ns: float = 10.0
+    fast_forward: bool = True
+    timeout_s: float = 600.0
+
+    # Parallelism (None = one per available core)
+    build_jobs: Optional[int] = None
+    workers: Optional[int] = None
+    pin_cores: bool = True
+
+    # Output options
+    keep_traces: bool = False
+
+    def to_dict(self) -> dict:
+        """Convert to dictionary for serialization."""
+        d = asdict(self)
+        d['stimulus_files'] = [str(p) for p in self.stimulus_files]
+        return d
+
+
+@dataclass
+class SweepJob:
+    """One simulation run in a sweep."""
+    latency: int
+    stimulus: str          # Workload name in the results table
+    stimulus_path: Path    # Binary stimulus passed to the simulator
+    num_tx: int
+    seed: Optional[int] = None
+
+
+@dataclass
+class SweepResult:
+    """Result row for one sweep job."""
+    latency: int
+    stimulus: str
+    seed: Optional[int]
+    success: bool = False
+
+    # Simulator counters
+    transactions: int = 0
+    traces: int = 0
+    trace_drops: int = 0
+    cycles: int = 0
+    wall_time_s: float = 0.0
+    cycles_per_sec: float = 0.0
+
+    # Latency distribution (cycles)
+    latency_min: int = 0
+    latency_mean: float = 0.0
+    latency_p50: int = 0
+    latency_p99: int = 0
+    latency_p999: int = 0
+    latency_p9999: int = 0
+    latency_max: int = 0
+
+    # Execution details
+    cpu: Optional[int] = None
+    returncode: int = 0
+    error_message: str = ""
+
+    def to_dict(self) -> dict:
+        """Convert to dictionary for serialization."""
+        return asdict(self)
+
+
+def parse_int_list(spec: str) -> List[int]:
+    """Parse a list like "0-8,12,16-32" into integers.
+
+    Args:
+        spec: Comma-separated values and inclusive ranges
+
+    Returns:
+        Sorted list of unique integers
+    """
+    values = set()
+    for part in spec.split(','):
+        part = part.strip()
+        if not part:
+            continue
+        if '-' in part:
+            lo, hi = part.split('-', 1)
+            values.update(range(int(lo), int(hi) + 1))
+        else:
+            values.add(int(part))
+    return sorted(values)
+
+
+def path_tag(path: Path) -> str:
+    """Short hash of a resolved path, so inputs with the same name in
+    different directories get different work files."""
+    return hashlib.sha1(str(Path(path).resolve()).encode()).hexdigest()[:8]
+
+
+def latency_stats(trace_path: Path) -> dict:
+    """Compute latency statistics from a binary trace file.
+
+    Args:
+        trace_path: Path to trace file written by the simulator
+
+    Returns:
+        Dictionary with count, min, mean, p50, p99, p999, p9999 and max (cycles)
+    """
+    with open(trace_path, 'rb') as f:
+        data = f.read()
+
+    usable = len(data) - len(data) % TRACE_RECORD_SIZE
+    latencies = sorted(
+        t_egress - t_ingress
+        for _, t_ingress, t_egress, _, _, _ in struct.iter_unpack(TRACE_FORMAT, data[:usable])
+    )
+
+    if not latencies:
+        return {'count': 0, 'min': 0, 'mean': 0.0, 'p50': 0, 'p99': 0,
+                'p999': 0, 'p9999': 0, 'max': 0}
+
+    def pct(p: float) -> int:
+        # Nearest-rank percentile
+        idx = max(0, int(p / 100.0 * len(latencies) + 0.5) - 1)
+        return latencies[min(idx, len(latencies) - 1)]
+
+    return {
+        'count': len(latencies),
+        'min': latencies[0],
+        'mean': sum(latencies) / len(latencies),
+        'p50': pct(50),
+        'p99': pct(99),
+        'p999': pct(99.9),
+        'p9999': pct(99.99),
+        'max': latencies[-1],
+    }
+
+
+def synthetic_stimulus(seed: int, num_tx: int, gap_ns: int) -> List[InputTransaction]:
+    """Generate a reproducible random workload.
+
+    Args:
+        seed: Random seed
+        num_tx: Number of transactions
+        gap_ns: Mean inter-arrival gap in nanoseconds
+
+    Returns:
+        Transactions with increasing timestamps
+    """
+    rng = random.Random(seed)
+    transactions = []
+    t = 0
+    for _ in range(num_tx):
+        t += rng.randint(0, 2 * gap_ns)
+        transactions.append(InputTransaction(
+            timestamp_ns=t,
+            data=rng.getrandbits(64),
+            opcode=rng.getrandbits(16),
+            meta=rng.getrandbits(32),
+        ))
+    return transactions
+
+
+def write_table(results: List[SweepResult], path: Path, config: Optional[SweepConfig] = None) -> None:
+    """Write sweep results as JSON or Parquet (by file extension).
+
+    Args:
+        results: Result rows
+        path: Output path (.json or .parquet)
+        config: Sweep configuration to embed in JSON output
+    """
+    path = Path(path)
+    rows = [r.to_dict() for r in results]
+
+    if path.suffix.lower() == '.parquet':
+        try:
+            import pyarrow as pa
+            import pyarrow.parquet as pq
+        except ImportError:
+            raise RuntimeError("pyarrow is required for Parquet output")
+        pq.write_table(pa.Table.from_pylist(rows), str(path))
+        return
+
+    doc = {
+        'config': config.to_dict() if config else None,
+        'results': rows,
+    }
+    with open(path, 'w') as f:
+        json.dump(doc, f, indent=2)
+
+
+class SweepRunner:
+    """Build and run latency sweeps in parallel."""
+
+    def __init__(self, sim_dir: Path, work_dir: Path):
+        """Initialize sweep runner.
+
+        Args:
+            sim_dir: Path to simulation directory (contains Makefile)
+            work_dir: Directory for builds, stimuli and traces
+        """
+        self.sim_dir = Path(sim_dir).resolve()
+        self.work_dir = Path(work_dir).resolve()
+        self.build_root = self.work_dir / 'builds'
+
+    def build_dir(self, latency: int) -> Path:
+        """Build directory for one CORE_LATENCY value."""
+        return self.build_root / f'lat_{latency}'
+
+    def exe_path(self, latency: int) -> Path:
+        """Simulator executable for one CORE_LATENCY value."""
+        return self.build_dir(latency) / SIM_TOP
+
+    def build(self, latency: int, force: bool = False) -> Tuple[bool, str]:
+        """Build the simulator for one latency.
+
+        Args:
+            latency: Core latency in cycles (CORE_LATENCY parameter)
+            force: Rebuild even if make considers it up to date
+
+        Returns:
+            (success, build stderr)
+        """
+        args = ['make', f'BUILD_DIR={self.build_dir(latency)}', f'CORE_LATENCY={latency}', 'all']
+        if force:
+            args.insert(1, '-B')
+
+        result = subprocess.run(
+            args,
+            cwd=self.sim_dir,
+            capture_output=True,
+            text=True,
+        )
+        ok = result.returncode == 0 and self.exe_path(latency).exists()
+        return ok, result.stderr
+
+    def build_all(self, latencies: List[int], jobs: Optional[int] = None,
+                  force: bool = False) -> List[int]:
+        """Build every latency concurrently.
+
+        Args:
+            latencies: Latencies to build
+            jobs: Concurrent builds (default: one per core)
+            force: Force rebuild
+
+        Returns:
+            Latencies whose build failed
+        """
+        self.build_root.mkdir(parents=True, exist_ok=True)
+        jobs = jobs or os.cpu_count() or 1
+
+        failed = []
+        with ThreadPoolExecutor(max_workers=jobs) as pool:
+            builds = {lat: pool.submit(self.build, lat, force) for lat in latencies}
+            for lat, fut in builds.items():
+                ok, stderr = fut.result()
+                if not ok:
+                    print(f"Build failed for CORE_LATENCY={lat}:\n{stderr}")
+                    failed.append(lat)
+        return failed
+
+    def prepare_stimuli(self, config: SweepConfig) -> List[Tuple[str, Path, int, Optional[int]]]:
+        """Convert inputs to binary stimulus files.
+
+        Returns:
+            List of (name, binary path, transaction count, seed)
+        """
+        stim_dir = self.work_dir / 'stimulus'
+        stim_dir.mkdir(parents=True, exist_ok=True)
+
+        stimuli = []
+        for path in config.stimulus_files:
+            path = Path(path)
+            if detect_format(path) == 'binary':
+                bin_path = path.resolve()
+                num_tx = bin_path.stat().st_size // STIMULUS_RECORD_SIZE
+            else:
+                transactions = load_input(path)
+                bin_path = stim_dir / f'{path.stem}_{path_tag(path)}.bin'
+                write_stimulus_binary(transactions, bin_path)
+                num_tx = len(transactions)
+            stimuli.append((path.name, bin_path, num_tx, None))
+
+        for seed in config.seeds:
+            bin_path = stim_dir / f'synthetic_{seed}.bin'
+            write_stimulus_binary(
+                synthetic_stimulus(seed, config.synthetic_tx, config.synthetic_gap_ns),
+                bin_path,
+            )
+            stimuli.append((f'synthetic-{seed}', bin_path, config.synthetic_tx, seed))
+
+        return stimuli
+
+    def plan(self, config: SweepConfig,
+             stimuli: List[Tuple[str, Path, int, Optional[int]]]) -> List[SweepJob]:
+        """Expand the parameter space into jobs, longest first."""
+        jobs = [
+            SweepJob(latency=lat, stimulus=name, stimulus_path=path, num_tx=num_tx, seed=seed)
+            for lat in config.latencies
+            for name, path, num_tx, seed in stimuli
+        ]
+        # Simulated cycles scale with the workload, and slightly with latency
+        jobs.sort(key=lambda j: (j.num_tx, j.latency), reverse=True)
+        return jobs
+
+    def run_job(self, job: SweepJob, config: SweepConfig, cpu: Optional[int] = None) -> SweepResult:
+        """Run one simulation and collect its statistics."""
+        result = SweepResult(latency=job.latency, stimulus=job.stimulus, seed=job.seed, cpu=cpu)
+
+        trace_dir = self.work_dir / 'traces'
+        trace_dir.mkdir(parents=True, exist_ok=True)
+        seed_tag = '' if job.seed is None else f'_s{job.seed}'
+        trace_name = f'lat{job.latency}_{Path(job.stimulus).stem}_{path_tag(job.stimulus_path)}'
+        trace_path = trace_dir / f'{trace_name}{seed_tag}.bin'
+
+        args = [
+            str(self.exe_path(job.latency)),
+            '--test', 'replay',
+            '--stimulus', str(job.stimulus_path),
+            '--output', str(trace_path),
+            '--num-tx', str(job.num_tx),
+            '--json',
+            '--clock-ns', str(config.clock_period_ns),
+        ]
+        if config.fast_forward:
+            args.append('--fast-forward')
+        if not config.keep_traces:
+            # Quantiles come from the simulator's own histogram
+            args.append('--stats-only')
+
+        try:
+            sim = subprocess.run(
+                args,
+                cwd=self.sim_dir,
+                capture_output=True,
+                text=True,
+                timeout=config.timeout_s,
+            )
+        except subprocess.TimeoutExpired:
+            result.error_message = "Simulation timed out"
+            return result
+        except Exception as e:
+            result.error_message = f"Simulation error: {e}"
+            return result
+
+        result.returncode = sim.returncode
+
+        lat = None
+        for line in sim.stdout.splitlines():
+            if line.startswith('{'):
+                try:
+                    stats = json.loads(line)
+                except json.JSONDecodeError:
+                    continue
+                result.transactions = stats.get('transactions_received', 0)
+                result.trace_drops = stats.get('trace_drops', 0)
+                result.cycles = stats.get('cycles_simulated', 0)
+                result.wall_time_s = stats.get('wall_time_s', 0.0)
+                result.cycles_per_sec = stats.get('cycles_per_sec', 0.0)
+                if 'latency_cycles' in stats:
+                    lat = dict(stats['latency_cycles'], count=stats.get('traces_collected', 0))
+
+        # Older simulators without the in-sim histogram: scan the trace
+        if trace_path.exists():
+            if lat is None:
+                lat = latency_stats(trace_path)
+            if not config.keep_traces:
+                trace_path.unlink()
+
+        if lat is not None:
+            result.traces = lat['count']
+            result.latency_min = lat['min']
+            result.latency_mean = lat['mean']
+            result.latency_p50 = lat['p50']
+            result.latency_p99 = lat['p99']
+            result.latency_p999 = lat['p999']
+            result.latency_p9999 = lat['p9999']
+            result.latency_max = lat['max']
+
+        if sim.returncode != 0:
+            result.error_message = f"Simulation failed: {sim.stderr.strip()}"
+            return result
+
+        result.success = True
+        return result
+
+    def run(self, config: SweepConfig, build: bool = True,
+            progress: Optional[Callable[[SweepResult, int, int], None]] = None) -> List[SweepResult]:
+        """Run a full sweep.
+
+        Args:
+            config: Sweep configuration
+            build: Build the simulators first (skip if already built)
+            progress: Called as progress(result, done, total) after each job
+
+        Returns:
+            Result rows ordered by (latency, stimulus)
+        """
+        self.work_dir.mkdir(parents=True, exist_ok=True)
+
+        latencies = list(config.latencies)
+        failed_builds = self.build_all(latencies, config.build_jobs) if build else []
+
+        stimuli = self.prepare_stimuli(config)
+        jobs = self.plan(config, stimuli)
+
+        results: List[SweepResult] = []
+        pending: queue.SimpleQueue = queue.SimpleQueue()
+        for job in jobs:
+            if job.latency in failed_builds:
+                results.append(SweepResult(
+                    latency=job.latency, stimulus=job.stimulus, seed=job.seed,
+                    error_message="Build failed",
+                ))
+            else:
+                pending.put(job)
+
+        cpus = self._worker_cpus(config)
+        lock = threading.Lock()
+        total = len(jobs)
+
+        def worker(cpu: Optional[int]) -> None:
+            # Linux affinity is per thread and inherited across fork, so
+            # pinning this thread pins every simulator it launches
+            if cpu is not None:
+                os.sched_setaffinity(0, {cpu})
+            while True:
+                try:
+                    job = pending.get_nowait()
+                except queue.Empty:
+                    return
+                res = self.run_job(job, config, cpu)
+                with lock:
+                    results.append(res)
+                    if progress:
+                        progress(res, len(results), total)
+
+        threads = [threading.Thread(target=worker, args=(cpu,), daemon=True) for cpu in cpus]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+
+        results.sort(key=lambda r: (r.latency, r.stimulus))
+        return results
+
+    def _worker_cpus(self, config: SweepConfig) -> List[Optional[int]]:
+        """One entry per worker: the core it is pinned to, or None."""
+        if hasattr(os, 'sched_getaffinity'):
+            available = sorted(os.sched_getaffinity(0))
+        else:
+            available = list(range(os.cpu_count() or 1))
+
+        count = config.workers or len(available)
+        if not config.pin_cores or not hasattr(os, 'sched_setaffinity'):
+            return [None] * count
+        return [available[i % len(available)] for i in range(count)]
+
+
+if __name__ == '__main__':
+    import argparse
+
+    parser = argparse.ArgumentParser(description='Run a Sentinel-HFT latency sweep')
+    parser.add_argument('stimulus', type=Path, nargs='*',
+                       help='Stimulus files (CSV or binary)')
+    parser.add_argument('--latencies', '-l', default='0-32',
+                       help='Latencies to sweep, e.g. "0-32" or "1,4,8"')
+    parser.add_argument('--seeds', default='',
+                       help='Seeds for synthetic workloads, e.g. "1-4"')
+    parser.add_argument('--synthetic-tx', type=int, default=10000,
+                       help='Transactions per synthetic workload')
+    parser.add_argument('--clock-ns', type=float, default=10.0,
+                       help='Clock period in nanoseconds')
+    parser.add_argument('--workers', '-j', type=int, default=None,
+                       help='Concurrent simulations (default: one per core)')
+    parser.add_argument('--build-jobs', type=int, default=None,
+                       help='Concurrent builds (default: one per core)')
+    parser.add_argument('--no-pin', action='store_true',
+                       help='Do not pin simulations to cores')
+    parser.add_argument('--no-build', action='store_true',
+                       help='Reuse existing builds in the work directory')
+    parser.add_argument('--keep-traces', action='store_true',
+                       help='Keep per-job trace files')
+    parser.add_argument('--work-dir', type=Path, default=Path('sweep_output'),
+                       help='Directory for builds, stimuli and traces')
+    parser.add_argument('--output', '-o', type=Path, default=Path('sweep.json'),
+                       help='Results table (.json or .parquet)')
+    parser.add_argument('--sim-dir', type=Path, default=None,
+                       help='Simulation directory')
+
+    args = parser.parse_args()
+
+    if not args.stimulus and not args.seeds:
+        parser.error("Give at least one stimulus file or --seeds")
+
+    config = SweepConfig(
+        latencies=parse_int_list(args.latencies),
+        stimulus_files=args.stimulus,
+        seeds=parse_int_list(args.seeds),
+        synthetic_tx=args.synthetic_tx,
+        clock_period_ns=args.clock_ns,
+        build_jobs=args.build_jobs,
+        workers=args.workers,
+        pin_cores=not args.no_pin,
+        keep_traces=args.keep_traces,
+    )
+
+    sim_dir = args.sim_dir or Path(__file__).parent.parent / 'sim'
+    runner = SweepRunner(sim_dir, args.work_dir)
+
+    def report(res: SweepResult, done: int, total: int) -> None:
+        status = 'ok' if res.success else f'FAIL ({res.error_message})'
+        print(f"[{done}/{total}] lat={res.latency} {res.stimulus}: "
+              f"p50={res.latency_p50} p99={res.latency_p99} {status}")
+
+    start = time.monotonic()
+    results = runner.run(config, build=not args.no_build, progress=report)
+    write_table(results, args.output, config)
+
+    failed = sum(1 for r in results if not r.success)
+    print(f"\nSweep finished in {time.monotonic() - start:.1f} s: "
+          f"{len(results) - failed}/{len(results)} jobs passed")
+    print(f"  Results saved to: {args.output}")
+    sys.exit(1 if failed else 0)
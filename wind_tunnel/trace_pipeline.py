@@ -3,17 +3,28 @@
 Provides streaming trace processing with validation and enrichment.
 """
 
+import time
 from dataclasses import dataclass, field
 from pathlib import Path
-from typing import Iterator, Optional
+from typing import Callable, Iterable, Iterator, Optional
 
 import sys
 sys.path.insert(0, str(Path(__file__).parent.parent / 'host'))
 
-from trace_decode import TraceRecord, decode_trace_file
+from trace_decode import TRACE_RECORD_SIZE, TraceRecord, decode_trace, decode_trace_file
+from trace_ring import TraceRingReader
 from .input_formats import InputTransaction
 
 
+def _trace_array():
+    """trace_array module, or None without numpy."""
+    try:
+        import trace_array
+    except ImportError:
+        return None
+    return trace_array
+
+
 @dataclass
 class EnrichedTrace:
     """Trace record with computed fields."""
@@ -129,6 +140,91 @@ class TracePipeline:
             for trace in decode_trace_file(f):
                 yield EnrichedTrace.from_trace(trace, self.clock_period_ns)
 
+    def follow(
+        self,
+        trace_file: Path,
+        done: Optional[Callable[[], bool]] = None,
+        poll_interval: float = 0.05,
+        timeout: Optional[float] = None,
+    ) -> Iterator[EnrichedTrace]:
+        """Stream enriched traces from a file that is still being written.
+
+        The simulator streams records to disk while it runs, so the file
+        can be consumed like ``tail -f``. Only whole records are decoded;
+        a trailing partial record is held back until the rest arrives.
+
+        Args:
+            trace_file: Path to binary trace file (may not exist yet)
+            done: Returns True once the writer has exited (e.g.
+                ``lambda: proc.poll() is not None``). The file is read to
+                its end after that before stopping. None = follow until
+                timeout.
+            poll_interval: Seconds to sleep when no new data is available
+            timeout: Give up after this many seconds (None = no limit)
+
+        Yields:
+            EnrichedTrace objects, in file order
+        """
+        path = Path(trace_file)
+        deadline = None if timeout is None else time.monotonic() + timeout
+
+        def expired() -> bool:
+            return deadline is not None and time.monotonic() >= deadline
+
+        while not path.exists():
+            if (done is not None and done()) or expired():
+                return
+            time.sleep(poll_interval)
+
+        pending = b''
+        finished = False
+        with open(path, 'rb') as f:
+            while True:
+                chunk = f.read(TRACE_RECORD_SIZE * 4096)
+                if chunk:
+                    pending += chunk
+                    usable = len(pending) - len(pending) % TRACE_RECORD_SIZE
+                    for i in range(0, usable, TRACE_RECORD_SIZE):
+                        trace = decode_trace(pending[i:i + TRACE_RECORD_SIZE])
+                        yield EnrichedTrace.from_trace(trace, self.clock_period_ns)
+                    pending = pending[usable:]
+                    continue
+
+                # Writer exited and one more read found nothing: done
+                if finished or expired():
+                    break
+                finished = done is not None and done()
+                if not finished:
+                    time.sleep(poll_interval)
+
+        if pending:
+            print(f"Warning: Incomplete record ({len(pending)} bytes) at end of file",
+                  file=sys.stderr)
+
+    def follow_ring(
+        self,
+        output: str,
+        done: Optional[Callable[[], bool]] = None,
+        timeout: Optional[float] = None,
+    ) -> Iterator[EnrichedTrace]:
+        """Stream enriched traces from a shared-memory ring (--output shm://NAME).
+
+        The shared-memory counterpart of follow(): records are consumed as
+        the simulator publishes them, and following stops once it closes
+        the ring (or exits, see done) and the ring is drained.
+
+        Args:
+            output: Ring name, shm://NAME
+            done: Returns True once the simulator has exited
+            timeout: Give up after this many seconds (None = no limit)
+
+        Yields:
+            EnrichedTrace objects, in publication order
+        """
+        reader = TraceRingReader(output)
+        for trace in reader.records(done=done, timeout=timeout):
+            yield EnrichedTrace.from_trace(trace, self.clock_period_ns)
+
     def process_all(self, trace_file: Path) -> list[EnrichedTrace]:
         """Load all traces from file.
 
@@ -152,6 +248,20 @@ class TracePipeline:
         Args:
             trace_file: Path to trace file
 
+        Returns:
+            ValidationResult with details
+        """
+        records = self._record_array(trace_file)
+        if records is not None:
+            return self._validate_records(records)
+        return self.validate_traces(self.process(trace_file))
+
+    def validate_traces(self, traces: Iterable[EnrichedTrace]) -> ValidationResult:
+        """Validate a trace stream (e.g. from follow_ring) with the checks of validate().
+
+        Args:
+            traces: Enriched traces, in trace order
+
         Returns:
             ValidationResult with details
         """
@@ -159,7 +269,7 @@ class TracePipeline:
         seen_tx_ids = set()
         last_tx_id = -1
 
-        for trace in self.process(trace_file):
+        for trace in traces:
             result.total_traces += 1
 
             # Check for duplicate tx_id
@@ -200,6 +310,66 @@ class TracePipeline:
 
         return result
 
+    def _record_array(self, trace_file: Path):
+        """Trace file as a record array, or None to fall back to decoding."""
+        ta = _trace_array()
+        if ta is None:
+            return None
+        try:
+            return ta.open_trace_array(trace_file, 'trace')
+        except ValueError:
+            return None
+
+    def _validate_records(self, records) -> ValidationResult:
+        """validate() over a record array: same checks and messages, in the
+        same order, with the per-record work limited to flagged records."""
+        import numpy as np
+
+        ta = _trace_array()
+        n = len(records)
+        result = ValidationResult(valid=True, total_traces=n, valid_traces=n)
+        if n == 0:
+            return result
+
+        tx = records['tx_id']
+        flags = records['flags']
+        lat = ta.latencies(records)
+
+        # Every occurrence of a tx_id after its first is a duplicate
+        _, first = np.unique(tx, return_index=True)
+        duplicate = np.ones(n, dtype=bool)
+        duplicate[first] = False
+        out_of_order = np.zeros(n, dtype=bool)
+        out_of_order[1:] = tx[1:] <= tx[:-1]
+        negative = lat < 0
+        flagged = flags != 0
+
+        result.duplicate_tx_ids = int(np.count_nonzero(duplicate))
+        result.out_of_order = int(np.count_nonzero(out_of_order))
+        result.negative_latency = int(np.count_nonzero(negative))
+        result.with_flags = int(np.count_nonzero(flagged))
+
+        for i in np.flatnonzero(duplicate | out_of_order | negative | flagged):
+            tx_id = int(tx[i])
+            if duplicate[i]:
+                result.errors.append(f"Duplicate tx_id: {tx_id}")
+                result.valid = False
+            if out_of_order[i]:
+                result.warnings.append(f"Out of order tx_id: {tx_id} after {int(tx[i - 1])}")
+            if negative[i]:
+                result.errors.append(f"Negative latency for tx_id {tx_id}: {int(lat[i])}")
+                result.valid = False
+            f = int(flags[i])
+            if f & 0x0001:  # FLAG_TRACE_DROPPED
+                result.warnings.append(f"tx_id {tx_id} has TRACE_DROPPED flag")
+            if f & 0x0002:  # FLAG_CORE_ERROR
+                result.warnings.append(f"tx_id {tx_id} has CORE_ERROR flag")
+            if f & 0x0004:  # FLAG_INFLIGHT_UNDER
+                result.errors.append(f"tx_id {tx_id} has INFLIGHT_UNDER flag")
+                result.valid = False
+
+        return result
+
     def filter(
         self,
         traces: Iterator[EnrichedTrace],
@@ -278,4 +448,21 @@ class TracePipeline:
         Returns:
             List of latency values in cycles
         """
+        records = self._record_array(trace_file)
+        if records is not None:
+            return _trace_array().latencies(records).tolist()
         return [t.latency_cycles for t in self.process(trace_file)]
+
+    def latency_array(self, trace_file: Path):
+        """Latency values as an int64 numpy array, without building a list.
+
+        Args:
+            trace_file: Path to trace file
+
+        Returns:
+            numpy array of latency values in cycles (requires numpy)
+        """
+        records = self._record_array(trace_file)
+        if records is None:
+            raise ValueError(f"Cannot map {trace_file} as a trace record array")
+        return _trace_array().latencies(records)